@@ -0,0 +1,13 @@
+#!/bin/sh
+COUNT=$1
+SIZE=$2
+shift 2
+
+$(dirname $0)/.setup.sh
+DISCOURSE=$(dirname $0)/../.build_benchmark/tools/libgnunetchat_discourse
+
+IDENTITY="gnunet-identity"
+
+$IDENTITY -C "bench"
+
+$DISCOURSE -a "bench" -n $COUNT -s $SIZE $@
@@ -48,6 +48,7 @@ struct GNUNET_CONFIGURATION_Handle;
 #endif
 
 #include <stdint.h>
+#include <sys/uio.h>
 #include <time.h>
 
 /**
@@ -412,6 +413,21 @@ typedef enum GNUNET_GenericReturnValue
                                        struct GNUNET_CHAT_Context *context,
                                        struct GNUNET_CHAT_Message *message);
 
+/**
+ * Method called when a batch of chat messages in a specific chat context is
+ * ready to be delivered.
+ *
+ * @param[in,out] cls Closure from #GNUNET_CHAT_set_batch_callback
+ * @param[in,out] context Chat context
+ * @param[in,out] messages Array of chat messages
+ * @param[in] count Amount of chat messages in the array
+ */
+typedef void
+(*GNUNET_CHAT_ContextMessageBatchCallback) (void *cls,
+                                            struct GNUNET_CHAT_Context *context,
+                                            struct GNUNET_CHAT_Message **messages,
+                                            unsigned int count);
+
 /**
  * Iterator over chat files in a specific chat context.
  *
@@ -443,9 +459,11 @@ typedef enum GNUNET_GenericReturnValue
                                            int read_receipt);
 
 /**
- * Iterator over chat tag messages with a specific target message.
+ * Iterator over chat tag messages with a specific target message
+ * or a specific tag value.
  *
- * @param[in,out] cls Closure from #GNUNET_CHAT_message_iterate_tags
+ * @param[in,out] cls Closure from #GNUNET_CHAT_message_iterate_tags or
+ *   #GNUNET_CHAT_iterate_tagged_messages
  * @param[in,out] message Chat message
  * @return #GNUNET_YES if we should continue to iterate, #GNUNET_NO otherwise.
  */
@@ -521,6 +539,18 @@ typedef enum GNUNET_GenericReturnValue
                                          struct GNUNET_CHAT_Discourse *discourse,
                                          struct GNUNET_CHAT_Contact *contact);
 
+/**
+ * Method called when writing data to a chat discourse has been completed.
+ *
+ * @param[in,out] cls Closure from #GNUNET_CHAT_discourse_writev
+ * @param[in,out] discourse Chat discourse
+ * @param[in] size Amount of bytes written
+ */
+typedef void
+(*GNUNET_CHAT_DiscourseWriteCallback) (void *cls,
+                                       struct GNUNET_CHAT_Discourse *discourse,
+                                       uint64_t size);
+
 /**
  * Start a chat handle with a certain configuration.
  *
@@ -861,6 +891,59 @@ GNUNET_CHAT_iterate_files (struct GNUNET_CHAT_Handle *handle,
                            GNUNET_CHAT_FileCallback callback,
                            void *cls);
 
+/**
+ * Iterates through the tag messages with a specific <i>tag</i> value
+ * from all chat contexts of a given chat <i>handle</i> with a selected
+ * callback and custom closure. The tagged messages can be accessed via
+ * #GNUNET_CHAT_message_get_target.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] tag Tag value
+ * @param[in] callback Callback for tag message iteration (optional)
+ * @param[in,out] cls Closure for tag message iteration (optional)
+ * @return Amount of tag messages iterated or #GNUNET_SYSERR on failure
+ */
+int
+GNUNET_CHAT_iterate_tagged_messages (struct GNUNET_CHAT_Handle *handle,
+                                     const char *tag,
+                                     GNUNET_CHAT_MessageCallback callback,
+                                     void *cls);
+
+/**
+ * Sets a <i>quota</i> in bytes for the local files stored by a given
+ * chat <i>handle</i>. Once the files exceed the quota, files which are
+ * not referenced by any message anymore get unindexed and deleted,
+ * least recently released first. A <i>quota</i> of zero disables the
+ * limit.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] quota Quota in bytes or zero
+ */
+void
+GNUNET_CHAT_set_file_quota (struct GNUNET_CHAT_Handle *handle,
+                            uint64_t quota);
+
+/**
+ * Returns the amount of bytes used by the local files stored by
+ * a given chat <i>handle</i>.
+ *
+ * @param[in] handle Chat handle
+ * @return Amount of bytes used by local files
+ */
+uint64_t
+GNUNET_CHAT_get_file_usage (const struct GNUNET_CHAT_Handle *handle);
+
+/**
+ * Unindexes and deletes all local files stored by a given chat
+ * <i>handle</i> which are not referenced by any message anymore,
+ * regardless of the quota.
+ *
+ * @param[in,out] handle Chat handle
+ * @return Amount of files getting deleted or #GNUNET_SYSERR on failure
+ */
+int
+GNUNET_CHAT_collect_files (struct GNUNET_CHAT_Handle *handle);
+
 /**
  * Sets a custom <i>user pointer</i> to a given chat <i>handle</i> so it can
  * be accessed in all handle related callbacks.
@@ -882,6 +965,170 @@ GNUNET_CHAT_set_user_pointer (struct GNUNET_CHAT_Handle *handle,
 void*
 GNUNET_CHAT_get_user_pointer (const struct GNUNET_CHAT_Handle *handle);
 
+/**
+ * Provides statistics about the memory management of a given chat
+ * <i>handle</i>. The amount of <i>objects</i> counts all messages and other
+ * small internal structures allocated by the handle so far, while the amount
+ * of <i>allocations</i> counts the actual memory allocations required for
+ * them.
+ *
+ * @param[in] handle Chat handle
+ * @param[out] objects Amount of allocated objects (optional)
+ * @param[out] allocations Amount of memory allocations (optional)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_allocation_stats (const struct GNUNET_CHAT_Handle *handle,
+                                  unsigned long long *objects,
+                                  unsigned long long *allocations);
+
+/**
+ * Provides a profile of the startup of a given chat <i>handle</i> and its
+ * connection to the current account. The durations of each phase are provided
+ * in milliseconds: <i>services</i> covers starting the required services,
+ * <i>identity</i> covers listing the available accounts, <i>zone</i> covers
+ * processing the stored records of the connected account and <i>messenger</i>
+ * covers waiting for the first message of any chat. The last two phases run
+ * concurrently after connecting to an account.
+ *
+ * Phases still in progress provide their duration so far and phases which did
+ * not begin provide zero.
+ *
+ * @param[in] handle Chat handle
+ * @param[out] services Duration of starting services (optional)
+ * @param[out] identity Duration of listing accounts (optional)
+ * @param[out] zone Duration of processing stored records (optional)
+ * @param[out] messenger Duration until receiving messages (optional)
+ * @return #GNUNET_YES if the account is connected and its stored records are
+ *   processed, #GNUNET_NO if the startup is in progress, otherwise
+ *   #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_startup_profile (const struct GNUNET_CHAT_Handle *handle,
+                                 unsigned long long *services,
+                                 unsigned long long *identity,
+                                 unsigned long long *zone,
+                                 unsigned long long *messenger);
+
+/**
+ * Sets a custom callback to a given chat <i>handle</i> which receives messages
+ * from chat contexts in batches instead of one by one via the message callback
+ * from #GNUNET_CHAT_start. Messages of a context get collected until either
+ * <i>max_size</i> messages are pending or the oldest pending message waited
+ * for <i>max_delay</i> milliseconds.
+ *
+ * Internal events like warnings or account updates will still be passed to the
+ * message callback. Passing NULL as callback disables batched delivery again
+ * after flushing all pending batches.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] batch_cb Callback for message batches (optional)
+ * @param[in,out] batch_cls Closure for message batches (optional)
+ * @param[in] max_size Maximum amount of messages per batch
+ * @param[in] max_delay Maximum delay of a pending batch (in milliseconds)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_batch_callback (struct GNUNET_CHAT_Handle *handle,
+                                GNUNET_CHAT_ContextMessageBatchCallback batch_cb,
+                                void *batch_cls,
+                                unsigned int max_size,
+                                unsigned int max_delay);
+
+/**
+ * Sets the limits of a given chat <i>handle</i> for resolving messages which
+ * depend on other messages not received yet, like deletions, tags or
+ * transcripts. Missing messages get requested at most <i>max_requests</i>
+ * times per second and each context. Messages waiting for longer than
+ * <i>timeout</i> milliseconds get processed without their dependency.
+ *
+ * Passing zero as <i>max_requests</i> disables the rate limit and passing zero
+ * as <i>timeout</i> lets messages wait until their dependency arrives.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] max_requests Maximum amount of requests per second
+ * @param[in] timeout Timeout of waiting messages (in milliseconds)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_dependency_limits (struct GNUNET_CHAT_Handle *handle,
+                                   unsigned int max_requests,
+                                   unsigned int timeout);
+
+/**
+ * Enables or disables a persistent cache of a given chat <i>handle</i> which
+ * stores the metadata of text, tag and deletion messages per chat context in
+ * its directory. Cached messages of a context can be iterated before they get
+ * received from the messenger service again, using
+ * #GNUNET_CHAT_context_iterate_cached_messages.
+ *
+ * The cache is disabled by default and requires the handle to use a directory.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] enabled #GNUNET_YES to enable the cache, #GNUNET_NO to disable it
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_message_cache (struct GNUNET_CHAT_Handle *handle,
+                               enum GNUNET_GenericReturnValue enabled);
+
+/**
+ * Sets the amount of records a given chat <i>handle</i> requests at once
+ * from the zone of its connected account. Records get processed in batches
+ * of <i>batch_size</i> instead of requesting each record separately. The
+ * default batch size is 64 and changes apply when the next batch gets
+ * requested.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] batch_size Amount of records per batch
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_zone_batch_size (struct GNUNET_CHAT_Handle *handle,
+                                 unsigned int batch_size);
+
+/**
+ * Provides statistics about the usage of the namestore by a given chat
+ * <i>handle</i> since connecting to its current account. The amount of
+ * <i>round_trips</i> counts the requests sent to the namestore service,
+ * while the amount of <i>records</i> counts the processed records of the
+ * account's zone.
+ *
+ * @param[in] handle Chat handle
+ * @param[out] round_trips Amount of namestore requests (optional)
+ * @param[out] records Amount of processed records (optional)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_namestore_stats (const struct GNUNET_CHAT_Handle *handle,
+                                 unsigned long long *round_trips,
+                                 unsigned long long *records);
+
+/**
+ * Provides statistics about the queue of a given chat <i>handle</i> which
+ * coalesces updates of records in the zone of its connected account. The
+ * amount of <i>pending</i> counts the record sets currently waiting in the
+ * queue, <i>written</i> counts the record sets stored so far and
+ * <i>coalesced</i> counts the updates which replaced a record set still
+ * waiting. The average and maximum latency between queueing a record set and
+ * the namestore confirming it are provided in milliseconds.
+ *
+ * @param[in] handle Chat handle
+ * @param[out] pending Amount of waiting record sets (optional)
+ * @param[out] written Amount of stored record sets (optional)
+ * @param[out] coalesced Amount of coalesced updates (optional)
+ * @param[out] average_latency Average latency in milliseconds (optional)
+ * @param[out] maximum_latency Maximum latency in milliseconds (optional)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_record_queue_stats (const struct GNUNET_CHAT_Handle *handle,
+                                    unsigned int *pending,
+                                    unsigned long long *written,
+                                    unsigned long long *coalesced,
+                                    unsigned long long *average_latency,
+                                    unsigned long long *maximum_latency);
+
 /**
  * Iterates through the contacts of a given chat <i>handle</i> with a selected
  * callback and custom closure.
@@ -1411,6 +1658,116 @@ GNUNET_CHAT_context_iterate_messages (struct GNUNET_CHAT_Context *context,
                                       GNUNET_CHAT_ContextMessageCallback callback,
                                       void *cls);
 
+/**
+ * Iterates through the messages of a given chat <i>context</i> ordered by
+ * their timestamp with a selected callback and custom closure. Only messages
+ * with a timestamp between <i>from</i> and <i>to</i> (both inclusive, in
+ * seconds) are passed to the callback.
+ *
+ * The iteration starts with the oldest matching message unless <i>reverse</i>
+ * is set to #GNUNET_YES, in which case it starts with the newest one. It stops
+ * after <i>limit</i> messages if the limit is not zero. Deleted messages are
+ * not included.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] from Lower bound of the timestamps
+ * @param[in] to Upper bound of the timestamps
+ * @param[in] limit Maximum amount of messages or zero
+ * @param[in] reverse #GNUNET_YES to iterate from newest to oldest
+ * @param[in] callback Callback for message iteration (optional)
+ * @param[in,out] cls Closure for message iteration (optional)
+ * @return Amount of messages iterated or #GNUNET_SYSERR on failure
+ */
+int
+GNUNET_CHAT_context_iterate_messages_range (struct GNUNET_CHAT_Context *context,
+                                            time_t from,
+                                            time_t to,
+                                            unsigned int limit,
+                                            enum GNUNET_GenericReturnValue reverse,
+                                            GNUNET_CHAT_ContextMessageCallback callback,
+                                            void *cls);
+
+/**
+ * Iterates through the messages of a given chat <i>context</i> stored in the
+ * persistent message cache of its chat handle, which have not been received
+ * from the messenger service yet. The messages are ordered by their timestamp
+ * and only provide their kind, timestamp, text and tag or deletion target.
+ * The cache gets loaded from disk on the first iteration and it is separated
+ * per account. Iterated messages are only valid until the cache gets disabled.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] callback Callback for message iteration (optional)
+ * @param[in,out] cls Closure for message iteration (optional)
+ * @return Amount of messages iterated or #GNUNET_SYSERR on failure
+ */
+int
+GNUNET_CHAT_context_iterate_cached_messages (struct GNUNET_CHAT_Context *context,
+                                             GNUNET_CHAT_ContextMessageCallback callback,
+                                             void *cls);
+
+/**
+ * Hints a given chat <i>context</i> to expect a certain amount of messages
+ * given by <i>expected_messages</i>, so it can prepare its internal storage
+ * upfront instead of growing it while messages arrive.
+ *
+ * Group and contact contexts remember how many messages they held before,
+ * so this is only necessary if a much larger history is expected.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] expected_messages Expected amount of messages
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_reserve (struct GNUNET_CHAT_Context *context,
+                             unsigned int expected_messages);
+
+/**
+ * Provides statistics about resolving message dependencies in a given chat
+ * <i>context</i>. The amount of <i>pending</i> counts the messages which are
+ * currently missing while <i>resolved</i> and <i>expired</i> count the missing
+ * messages which arrived or got timed out so far. The average and maximum
+ * latency between requesting a missing message and its arrival are provided
+ * in milliseconds.
+ *
+ * @param[in] context Chat context
+ * @param[out] pending Amount of missing messages (optional)
+ * @param[out] resolved Amount of resolved dependencies (optional)
+ * @param[out] expired Amount of expired dependencies (optional)
+ * @param[out] average_latency Average latency in milliseconds (optional)
+ * @param[out] maximum_latency Maximum latency in milliseconds (optional)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_get_dependency_stats (const struct GNUNET_CHAT_Context *context,
+                                          unsigned int *pending,
+                                          unsigned long long *resolved,
+                                          unsigned long long *expired,
+                                          unsigned long long *average_latency,
+                                          unsigned long long *maximum_latency);
+
+/**
+ * Provides the progress of synchronizing the message history of a given chat
+ * <i>context</i>. Missing messages are requested starting with the newest gaps
+ * in the history, so recent messages become available first.
+ *
+ * The amount of <i>pending</i> counts all missing messages known so far while
+ * <i>outstanding</i> counts the ones currently requested. The amount of
+ * <i>completed</i> counts the missing messages which arrived already. The
+ * history is complete when no messages are pending anymore.
+ *
+ * @param[in] context Chat context
+ * @param[out] pending Amount of missing messages (optional)
+ * @param[out] outstanding Amount of requested messages (optional)
+ * @param[out] completed Amount of arrived messages (optional)
+ * @return #GNUNET_YES if the history is complete, #GNUNET_NO if messages are
+ *   still missing and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_get_sync_progress (const struct GNUNET_CHAT_Context *context,
+                                       unsigned int *pending,
+                                       unsigned int *outstanding,
+                                       unsigned long long *completed);
+
 /**
  * Iterates through the files of a given chat <i>context</i> with a selected
  * callback and custom closure.
@@ -1557,6 +1914,18 @@ GNUNET_CHAT_message_get_read_receipt (struct GNUNET_CHAT_Message *message,
                                       GNUNET_CHAT_MessageReadReceiptCallback callback,
                                       void *cls);
 
+/**
+ * Returns the amount of members in the context related to a given chat
+ * <i>message</i> which have already received it without iterating
+ * through each of the contacts.
+ *
+ * @param[in] message Message
+ * @return Amount of members which received the message or
+ *   #GNUNET_SYSERR on failure
+ */
+int
+GNUNET_CHAT_message_get_read_count (const struct GNUNET_CHAT_Message *message);
+
 /**
  * Returns the text of a given <i>message</i> if its kind is
  * #GNUNET_CHAT_KIND_TEXT or #GNUNET_CHAT_KIND_WARNING,
@@ -1789,6 +2158,32 @@ GNUNET_CHAT_file_is_ready (const struct GNUNET_CHAT_File *file);
 const char*
 GNUNET_CHAT_file_open_preview (struct GNUNET_CHAT_File *file);
 
+/**
+ * Reads up to <i>size</i> bytes of the decrypted content of a given
+ * <i>file</i> handle starting at a specific <i>offset</i> into a custom
+ * <i>buffer</i>. Only the blocks of the file covering the requested range get
+ * decrypted, so no decrypted copy of the file is written to disk. A few of the
+ * most recently read blocks stay cached until the file handle gets destroyed.
+ *
+ * Other than #GNUNET_CHAT_file_open_preview this does not verify the hash of
+ * the whole file content!
+ *
+ * This can only be used when the file handle is ready to preview!
+ * @see GNUNET_CHAT_file_is_ready()
+ *
+ * @param[in,out] file File handle
+ * @param[in] offset Offset in the file content
+ * @param[out] buffer Buffer for the content
+ * @param[in] size Size of the buffer
+ * @return Amount of bytes read, zero at the end of the file or #GNUNET_SYSERR
+ *   on failure
+ */
+ssize_t
+GNUNET_CHAT_file_read_range (struct GNUNET_CHAT_File *file,
+                             uint64_t offset,
+                             void *buffer,
+                             size_t size);
+
 /**
  * Deletes the temporary decrypted file preview of a given <i>file</i>
  * handle.
@@ -2003,6 +2398,44 @@ GNUNET_CHAT_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
                              const char *data,
                              uint64_t size);
 
+/**
+ * Sends messages to a given chat <i>discourse</i> containing the data
+ * of an array of <i>iovcnt</i> buffers in <i>iov</i> without copying it
+ * into a single buffer first. The data gets sent asynchronously in
+ * order, limited by the write window of the discourse per scheduler
+ * round, and the <i>callback</i> gets called once all data has been
+ * sent or the discourse has been left.
+ *
+ * The buffers need to stay valid until the callback gets called. The
+ * callback will not be called if the discourse gets destroyed before.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] iov Array of buffers
+ * @param[in] iovcnt Amount of buffers
+ * @param[in] callback Callback for completion (optional)
+ * @param[in,out] cls Closure for completion (optional)
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_discourse_writev (struct GNUNET_CHAT_Discourse *discourse,
+                              const struct iovec *iov,
+                              int iovcnt,
+                              GNUNET_CHAT_DiscourseWriteCallback callback,
+                              void *cls);
+
+/**
+ * Sets the write <i>window</i> of a given chat <i>discourse</i> as the
+ * maximum amount of messages sent per scheduler round by
+ * #GNUNET_CHAT_discourse_writev before yielding to other tasks. The
+ * window is at least one message.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] window Amount of messages
+ */
+void
+GNUNET_CHAT_discourse_set_write_window (struct GNUNET_CHAT_Discourse *discourse,
+                                        unsigned int window);
+
 /**
  * Returns a file descriptor of a pipe to write data via IPC
  * into the given chat <i>discourse</i>.
@@ -2013,6 +2446,70 @@ GNUNET_CHAT_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
 int
 GNUNET_CHAT_discourse_get_fd (const struct GNUNET_CHAT_Discourse *discourse);
 
+/**
+ * Sets a playout <i>delay</i> in milliseconds for a given chat
+ * <i>discourse</i> to buffer its received data per sender. The data
+ * of each sender gets reordered by timestamp and released with the
+ * playout delay, so it can be read as contiguous stream. Data arriving
+ * after newer data of the same sender has been released gets dropped.
+ * A <i>delay</i> of zero disables the buffer and drops its data.
+ *
+ * The data messages are still passed to the message callback.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] delay Playout delay in milliseconds or zero
+ */
+void
+GNUNET_CHAT_discourse_set_playout_delay (struct GNUNET_CHAT_Discourse *discourse,
+                                         unsigned int delay);
+
+/**
+ * Sets a file descriptor <i>fd</i> to write the released data of a
+ * selected chat <i>contact</i> from a given chat <i>discourse</i> into
+ * once its playout delay passed, instead of buffering it to be read.
+ * The file descriptor should be non-blocking. Passing -1 as file
+ * descriptor buffers the data again.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] contact Chat contact
+ * @param[in] fd File descriptor or -1
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_discourse_set_playout_fd (struct GNUNET_CHAT_Discourse *discourse,
+                                      const struct GNUNET_CHAT_Contact *contact,
+                                      int fd);
+
+/**
+ * Returns the amount of bytes from a selected chat <i>contact</i> in
+ * a given chat <i>discourse</i> which passed its playout delay and are
+ * available to read.
+ *
+ * @param[in] discourse Chat discourse
+ * @param[in] contact Chat contact
+ * @return Amount of bytes available to read
+ */
+uint64_t
+GNUNET_CHAT_discourse_available (const struct GNUNET_CHAT_Discourse *discourse,
+                                 const struct GNUNET_CHAT_Contact *contact);
+
+/**
+ * Reads up to <i>size</i> bytes from a selected chat <i>contact</i> in
+ * a given chat <i>discourse</i>, which passed its playout delay, into
+ * a <i>data</i> buffer.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] contact Chat contact
+ * @param[out] data Data buffer
+ * @param[in] size Buffer size
+ * @return Amount of bytes read or #GNUNET_SYSERR on failure
+ */
+int64_t
+GNUNET_CHAT_discourse_read (struct GNUNET_CHAT_Discourse *discourse,
+                            const struct GNUNET_CHAT_Contact *contact,
+                            char *data,
+                            uint64_t size);
+
 /**
  * Iterates through the subscribed chat contacts of a given chat <i>discourse</i> 
  * with a selected callback and custom closure.
@@ -54,6 +54,8 @@ contact_create_from_member (struct GNUNET_CHAT_Handle *handle,
   contact->member = member;
   contact->joined = GNUNET_CONTAINER_multihashmap_create(
     initial_map_size_of_contact, GNUNET_NO);
+  contact->tags = GNUNET_CONTAINER_multihashmap32_create(
+    initial_map_size_of_contact);
 
   contact->tickets_head = NULL;
   contact->tickets_tail = NULL;
@@ -109,6 +111,8 @@ contact_update_join (struct GNUNET_CHAT_Contact *contact,
 
     GNUNET_memcpy(current, hash, 
       sizeof(struct GNUNET_HashCode));
+
+    contact_update_tags(contact);
     return;
   }
   else if (0 == (flags & GNUNET_MESSENGER_FLAG_RECENT))
@@ -119,6 +123,8 @@ contact_update_join (struct GNUNET_CHAT_Contact *contact,
 
   GNUNET_memcpy(current, hash, 
     sizeof(struct GNUNET_HashCode));
+
+  contact_update_tags(contact);
   
   if (GNUNET_YES == blocked)
     contact_tag(contact, context, NULL);
@@ -151,6 +157,129 @@ contact_leave (struct GNUNET_CHAT_Contact *contact,
     return;
 
   GNUNET_free(current);
+
+  contact_update_tags(contact);
+}
+
+void
+contact_update_tags (struct GNUNET_CHAT_Contact *contact)
+{
+  GNUNET_assert(
+    (contact) &&
+    (contact->joined) &&
+    (contact->tags)
+  );
+
+  GNUNET_CONTAINER_multihashmap32_destroy(contact->tags);
+  contact->tags = GNUNET_CONTAINER_multihashmap32_create(
+    initial_map_size_of_contact);
+
+  struct GNUNET_CONTAINER_MultiHashMapIterator *iter;
+  iter = GNUNET_CONTAINER_multihashmap_iterator_create(
+    contact->joined
+  );
+
+  if (! iter)
+    return;
+
+  struct GNUNET_HashCode key;
+  const void *value;
+
+  while (GNUNET_YES == GNUNET_CONTAINER_multihashmap_iterator_next(
+         iter, &key, &value))
+  {
+    const struct GNUNET_CHAT_Context *context = GNUNET_CONTAINER_multihashmap_get(
+      contact->handle->contexts, &key);
+
+    if ((! context) || (! (context->taggings)))
+      continue;
+
+    const struct GNUNET_CHAT_InternalTagging *tagging = GNUNET_CONTAINER_multihashmap_get(
+      context->taggings,
+      (const struct GNUNET_HashCode*) value
+    );
+
+    if (tagging)
+      internal_tagging_iterate(
+        tagging,
+        GNUNET_YES,
+        NULL,
+        it_contact_track_tag,
+        contact
+      );
+  }
+
+  GNUNET_CONTAINER_multihashmap_iterator_destroy(iter);
+}
+
+void
+contact_track_tag (struct GNUNET_CHAT_Contact *contact,
+                   const struct GNUNET_CHAT_Context *context,
+                   const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert(
+    (contact) &&
+    (contact->tags) &&
+    (context) &&
+    (message)
+  );
+
+  if (GNUNET_YES != message_has_msg(message))
+    return;
+
+  const struct GNUNET_HashCode *hash = get_contact_join_hash(
+    contact, context);
+
+  if ((! hash) ||
+      (0 != GNUNET_CRYPTO_hash_cmp(hash, &(message->msg->body.tag.hash))))
+    return;
+
+  it_contact_track_tag(contact, (struct GNUNET_CHAT_Message*) message);
+}
+
+void
+contact_untrack_tag (struct GNUNET_CHAT_Contact *contact,
+                     const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert(
+    (contact) &&
+    (contact->tags) &&
+    (message)
+  );
+
+  if (GNUNET_YES != message_has_msg(message))
+    return;
+
+  const unsigned int id = internal_tag_index_lookup(
+    contact->handle->tag_index,
+    message->msg->body.tag.tag
+  );
+
+  if (GNUNET_CHAT_INTERNAL_TAG_UNKNOWN != id)
+    GNUNET_CONTAINER_multihashmap32_remove(
+      contact->tags, id, message
+    );
+}
+
+void
+contact_untrack_context (struct GNUNET_CHAT_Contact *contact,
+                         const struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert(
+    (contact) &&
+    (contact->tags) &&
+    (context)
+  );
+
+  struct GNUNET_CHAT_ContactUntrackContext untrack;
+  untrack.contact = contact;
+  untrack.context = context;
+
+  GNUNET_CONTAINER_multihashmap32_iterate(
+    contact->tags,
+    it_contact_untrack_context,
+    &untrack
+  );
 }
 
 void
@@ -241,48 +370,25 @@ contact_is_tagged (const struct GNUNET_CHAT_Contact *contact,
     (contact->joined)
   );
 
-  const enum GNUNET_GenericReturnValue general = (
-    context ? GNUNET_NO : GNUNET_YES
-  );
-
-  if (context)
-    goto skip_context_search;
-
-  struct GNUNET_CONTAINER_MultiHashMapIterator *iter;
-  iter = GNUNET_CONTAINER_multihashmap_iterator_create(
-    contact->joined
-  );
-
-  if (iter)
+  if (! context)
   {
-    struct GNUNET_HashCode key;
-    const void *value;
-
-    while (! context)
-    {
-      if (GNUNET_YES != GNUNET_CONTAINER_multihashmap_iterator_next(
-          iter, &key, &value))
-        break;
-
-      context = GNUNET_CONTAINER_multihashmap_get(
-        contact->handle->contexts, &key);
-    }
+    const unsigned int id = internal_tag_index_lookup(
+      contact->handle->tag_index, tag
+    );
 
-    GNUNET_CONTAINER_multihashmap_iterator_destroy(iter);
+    if ((GNUNET_CHAT_INTERNAL_TAG_UNKNOWN == id) ||
+        (GNUNET_YES != GNUNET_CONTAINER_multihashmap32_contains(
+          contact->tags, id)))
+      return GNUNET_NO;
+    else
+      return GNUNET_YES;
   }
 
-skip_context_search:
-  if (! context)
-    return GNUNET_NO;
-
   const struct GNUNET_HashCode *hash = get_contact_join_hash(
     contact, context);
 
   if (! hash)
-    return (general == GNUNET_YES? 
-      GNUNET_NO : 
-      contact_is_tagged(contact, NULL, tag)
-    );
+    return contact_is_tagged(contact, NULL, tag);
   
   const struct GNUNET_CHAT_InternalTagging *tagging = GNUNET_CONTAINER_multihashmap_get(
     context->taggings,
@@ -428,51 +534,17 @@ contact_iterate_tags (struct GNUNET_CHAT_Contact *contact,
 
   if (! context)
   {
-    struct GNUNET_CHAT_ContactIterateUniqueTag it;
-    it.tags = GNUNET_CONTAINER_multihashmap_create(
-      initial_map_size_of_contact, GNUNET_NO);
+    struct GNUNET_CHAT_ContactIterateCachedTag it;
+    it.contact = contact;
     it.callback = callback;
     it.cls = cls;
+    it.result = 0;
 
-    if (! (it.tags))
+    if (GNUNET_SYSERR == GNUNET_CONTAINER_multihashmap32_iterate(
+        contact->tags, it_contact_iterate_cached_tag, &it))
       return GNUNET_SYSERR;
 
-    int result = GNUNET_SYSERR;
-
-    struct GNUNET_CONTAINER_MultiHashMapIterator *iter;
-    iter = GNUNET_CONTAINER_multihashmap_iterator_create(
-      contact->joined
-    );
-
-    if (! iter)
-      goto free_tags_iteration;
-
-    struct GNUNET_HashCode key;
-    const void *value;
-
-    while (! context)
-    {
-      if (GNUNET_YES != GNUNET_CONTAINER_multihashmap_iterator_next(
-          iter, &key, &value))
-        break;
-
-      context = GNUNET_CONTAINER_multihashmap_get(
-        contact->handle->contexts, &key);
-      
-      if (context)
-        result = contact_iterate_tags(
-          contact,
-          context,
-          it_contact_iterate_unique_tag,
-          &it
-        );
-    }
-
-    GNUNET_CONTAINER_multihashmap_iterator_destroy(iter);
-
-free_tags_iteration:
-    GNUNET_CONTAINER_multihashmap_destroy(it.tags);
-    return result;
+    return it.result;
   }
 
   const struct GNUNET_HashCode *hash = get_contact_join_hash(
@@ -539,6 +611,9 @@ contact_destroy (struct GNUNET_CHAT_Contact* contact)
     GNUNET_CONTAINER_multihashmap_destroy(contact->joined);
   }
 
+  if (contact->tags)
+    GNUNET_CONTAINER_multihashmap32_destroy(contact->tags);
+
   if ((contact->context) && (!(contact->context->room)))
     context_destroy(contact->context);
 
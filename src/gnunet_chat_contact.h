@@ -34,6 +34,7 @@
 struct GNUNET_CHAT_Handle;
 struct GNUNET_CHAT_Contact;
 struct GNUNET_CHAT_Context;
+struct GNUNET_CHAT_Message;
 struct GNUNET_CHAT_Ticket;
 
 struct GNUNET_CHAT_InternalTickets
@@ -53,6 +54,7 @@ struct GNUNET_CHAT_Contact
 
   const struct GNUNET_MESSENGER_Contact *member;
   struct GNUNET_CONTAINER_MultiHashMap *joined;
+  struct GNUNET_CONTAINER_MultiHashMap32 *tags;
 
   struct GNUNET_CHAT_InternalTickets *tickets_head;
   struct GNUNET_CHAT_InternalTickets *tickets_tail;
@@ -101,6 +103,52 @@ void
 contact_leave (struct GNUNET_CHAT_Contact *contact,
                struct GNUNET_CHAT_Context *context);
 
+/**
+ * Rebuilds the cached tags of a given chat <i>contact</i> from
+ * the tag messages targeting its latest join messages in all
+ * of its chat contexts.
+ *
+ * @param[in,out] contact Chat contact
+ */
+void
+contact_update_tags (struct GNUNET_CHAT_Contact *contact);
+
+/**
+ * Adds a tag <i>message</i> to the cached tags of a given chat
+ * <i>contact</i> if it targets the latest join message of the
+ * contact in a given chat <i>context</i>.
+ *
+ * @param[in,out] contact Chat contact
+ * @param[in] context Chat context
+ * @param[in] message Tag message
+ */
+void
+contact_track_tag (struct GNUNET_CHAT_Contact *contact,
+                   const struct GNUNET_CHAT_Context *context,
+                   const struct GNUNET_CHAT_Message *message);
+
+/**
+ * Removes a tag <i>message</i> from the cached tags of a given
+ * chat <i>contact</i>.
+ *
+ * @param[in,out] contact Chat contact
+ * @param[in] message Tag message
+ */
+void
+contact_untrack_tag (struct GNUNET_CHAT_Contact *contact,
+                     const struct GNUNET_CHAT_Message *message);
+
+/**
+ * Removes all tag messages of a given chat <i>context</i> from
+ * the cached tags of a given chat <i>contact</i>.
+ *
+ * @param[in,out] contact Chat contact
+ * @param[in] context Chat context
+ */
+void
+contact_untrack_context (struct GNUNET_CHAT_Contact *contact,
+                         const struct GNUNET_CHAT_Context *context);
+
 /**
  * Updates the string representation of the public key from
  * a given chat <i>contact</i>.
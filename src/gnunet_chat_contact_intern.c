@@ -85,38 +85,6 @@ it_contact_find_tag (void *cls,
   return GNUNET_YES;
 }
 
-struct GNUNET_CHAT_ContactIterateUniqueTag
-{
-  struct GNUNET_CONTAINER_MultiHashMap *tags;
-  GNUNET_CHAT_ContactTagCallback callback;
-  void *cls;
-};
-
-enum GNUNET_GenericReturnValue
-it_contact_iterate_unique_tag (void *cls,
-                               struct GNUNET_CHAT_Contact *contact,
-                               const char *tag)
-{
-  GNUNET_assert((cls) && (contact) && (tag));
-
-  struct GNUNET_CHAT_ContactIterateUniqueTag *it = cls;
-
-  struct GNUNET_HashCode hash;
-  GNUNET_CRYPTO_hash(tag, strlen(tag), &hash);
-
-  if (GNUNET_YES == GNUNET_CONTAINER_multihashmap_contains(it->tags, &hash))
-    return GNUNET_YES;
-
-  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(it->tags, 
-      &hash, NULL, GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
-    return GNUNET_YES;
-  
-  if (it->callback)
-    return it->callback(it->cls, contact, tag);
-  else
-    return GNUNET_YES;
-}
-
 struct GNUNET_CHAT_ContactIterateTag
 {
   struct GNUNET_CHAT_Contact *contact;
@@ -147,6 +115,92 @@ it_contact_iterate_tag (void *cls,
     return GNUNET_YES;
 }
 
+enum GNUNET_GenericReturnValue
+it_contact_track_tag (void *cls,
+                      struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((cls) && (message));
+
+  struct GNUNET_CHAT_Contact *contact = cls;
+
+  if ((GNUNET_YES != message_has_msg(message)) ||
+      (message->flags & GNUNET_MESSENGER_FLAG_DELETE) ||
+      (0 == (message->flags & GNUNET_MESSENGER_FLAG_SENT)))
+    return GNUNET_YES;
+
+  const unsigned int id = internal_tag_index_lookup(
+    contact->handle->tag_index,
+    message->msg->body.tag.tag
+  );
+
+  if ((GNUNET_CHAT_INTERNAL_TAG_UNKNOWN != id) &&
+      (GNUNET_YES != GNUNET_CONTAINER_multihashmap32_contains_value(
+        contact->tags, id, message)))
+    GNUNET_CONTAINER_multihashmap32_put(
+      contact->tags, id, message,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE
+    );
+
+  return GNUNET_YES;
+}
+
+struct GNUNET_CHAT_ContactUntrackContext
+{
+  struct GNUNET_CHAT_Contact *contact;
+  const struct GNUNET_CHAT_Context *context;
+};
+
+enum GNUNET_GenericReturnValue
+it_contact_untrack_context (void *cls,
+                            uint32_t key,
+                            void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_ContactUntrackContext *untrack = cls;
+  const struct GNUNET_CHAT_Message *message = value;
+
+  if (message->context == untrack->context)
+    GNUNET_CONTAINER_multihashmap32_remove(
+      untrack->contact->tags, key, value
+    );
+
+  return GNUNET_YES;
+}
+
+struct GNUNET_CHAT_ContactIterateCachedTag
+{
+  struct GNUNET_CHAT_Contact *contact;
+  GNUNET_CHAT_ContactTagCallback callback;
+  void *cls;
+  int result;
+};
+
+enum GNUNET_GenericReturnValue
+it_contact_iterate_cached_tag (void *cls,
+                               uint32_t key,
+                               void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_ContactIterateCachedTag *it = cls;
+
+  if (value != GNUNET_CONTAINER_multihashmap32_get(it->contact->tags, key))
+    return GNUNET_YES;
+
+  const struct GNUNET_CHAT_InternalTagIndex *index = it->contact->handle->tag_index;
+
+  if ((key >= index->count) || (! index->entries[key]->tag))
+    return GNUNET_YES;
+
+  it->result++;
+
+  if (it->callback)
+    return it->callback(it->cls, it->contact, index->entries[key]->tag);
+  else
+    return GNUNET_YES;
+}
+
 enum GNUNET_GenericReturnValue
 it_free_join_hashes (void *cls,
                      const struct GNUNET_HashCode *key,
@@ -23,11 +23,18 @@
  */
 
 #include "gnunet_chat_context.h"
+#include "gnunet_chat_contact.h"
 #include "gnunet_chat_file.h"
 #include "gnunet_chat_handle.h"
 #include "gnunet_chat_message.h"
 #include "gnunet_chat_util.h"
 
+#include "internal/gnunet_chat_archive.h"
+#include "internal/gnunet_chat_backfill.h"
+#include "internal/gnunet_chat_dependencies.h"
+#include "internal/gnunet_chat_receipts.h"
+#include "internal/gnunet_chat_timeline.h"
+
 #include "gnunet_chat_context_intern.c"
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_messenger_service.h>
@@ -37,10 +44,23 @@
 
 static const unsigned int initial_map_size_of_room = 8;
 static const unsigned int initial_map_size_of_contact = 4;
+static const unsigned int maximum_map_size_of_context = 65536;
+static const unsigned int maximum_requests_of_context = 32;
+static const unsigned int timeout_of_context_requests = 30;
+static const unsigned int maximum_attempts_of_context_requests = 3;
+
+static unsigned int
+get_map_size (unsigned int initial_map_size,
+              uint32_t expected)
+{
+  if (expected > maximum_map_size_of_context)
+    expected = maximum_map_size_of_context;
+
+  return expected > initial_map_size? expected : initial_map_size;
+}
 
 static void
-init_new_context (struct GNUNET_CHAT_Context *context,
-                  unsigned int initial_map_size)
+init_new_context (struct GNUNET_CHAT_Context *context)
 {
   GNUNET_assert(context);
 
@@ -49,31 +69,191 @@ init_new_context (struct GNUNET_CHAT_Context *context,
   context->topic = NULL;
   context->deleted = GNUNET_NO;
 
-  context->request_task = NULL;
+  memset(&(context->door), 0, sizeof(context->door));
+
+  context->batch = NULL;
+  context->batch_size = 0;
+  context->batch_count = 0;
+  context->batch_task = NULL;
+
+  context->timestamps = NULL;
+  context->messages = NULL;
+  context->taggings = NULL;
+  context->invites = NULL;
+  context->files = NULL;
+  context->discourses = NULL;
+
+  context->backfill = NULL;
+  context->dependencies = NULL;
+  context->timeline = NULL;
+  context->receipts = NULL;
+  context->archive = NULL;
+  context->capacity = 0;
+  
+  context->user_pointer = NULL;
+
+  context->member_pointers = NULL;
+}
+
+static void
+init_context_maps (struct GNUNET_CHAT_Context *context,
+                   unsigned int initial_map_size,
+                   const struct GNUNET_CHAT_ContextStats *stats)
+{
+  GNUNET_assert((context) && (stats));
+
+  const unsigned int messages = get_map_size(initial_map_size, stats->messages);
+  const unsigned int members = get_map_size(initial_map_size, stats->members);
 
   context->timestamps = GNUNET_CONTAINER_multishortmap_create(
-    initial_map_size, GNUNET_NO);
-  context->dependencies = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size, GNUNET_NO);
+    members, GNUNET_NO);
   context->messages = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size, GNUNET_NO);
-  context->requests = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size, GNUNET_NO);
+    messages, GNUNET_NO);
   context->taggings = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size, GNUNET_NO);
+    get_map_size(initial_map_size, stats->taggings), GNUNET_NO);
   context->invites = GNUNET_CONTAINER_multihashmap_create(
     initial_map_size, GNUNET_NO);
   context->files = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size, GNUNET_NO);
+    get_map_size(initial_map_size, stats->files), GNUNET_NO);
   context->discourses = GNUNET_CONTAINER_multishortmap_create(
     initial_map_size, GNUNET_NO);
-  
-  context->user_pointer = NULL;
+
+  context->backfill = internal_backfill_create(
+    initial_map_size,
+    maximum_requests_of_context,
+    maximum_attempts_of_context_requests,
+    GNUNET_TIME_relative_multiply(
+      GNUNET_TIME_UNIT_SECONDS, timeout_of_context_requests
+    ),
+    cb_context_request_message,
+    context
+  );
+
+  context->dependencies = internal_dependencies_create(
+    initial_map_size,
+    cb_context_fetch_dependency,
+    cb_context_release_dependency,
+    context
+  );
+
+  context_configure_dependencies(context);
+
+  context->timeline = internal_timeline_create(messages);
+  context->receipts = internal_receipts_create(members);
+  context->capacity = messages;
 
   context->member_pointers = GNUNET_CONTAINER_multishortmap_create(
-    initial_map_size, GNUNET_NO);
+    members, GNUNET_NO);
+}
+
+static void
+load_context_stats (const struct GNUNET_CHAT_Handle *handle,
+                    const struct GNUNET_HashCode *hash,
+                    struct GNUNET_CHAT_ContextStats *stats)
+{
+  GNUNET_assert((handle) && (hash) && (stats));
+
+  struct GNUNET_CHAT_ContextStats stored;
+  memset(stats, 0, sizeof(*stats));
+
+  // Statistics of a room are stored per account since each
+  // account may see a different part of the room.
+  struct GNUNET_HashCode key;
+  if ((!(handle->directory)) ||
+      (GNUNET_YES != handle_get_account_key(handle, hash, &key)) ||
+      (GNUNET_OK != util_load_stats(handle->directory, "stats/contexts",
+                                    &key, &stored, sizeof(stored))))
+    return;
+
+  stats->messages = ntohl(stored.messages);
+  stats->taggings = ntohl(stored.taggings);
+  stats->files = ntohl(stored.files);
+  stats->members = ntohl(stored.members);
+}
+
+static void
+release_context_archive (struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert(context);
+
+  if (!(context->archive))
+    return;
+
+  internal_archive_iterate(
+    context->archive, it_destroy_context_archive, NULL
+  );
+
+  internal_archive_destroy(context->archive);
+  context->archive = NULL;
+}
+
+static struct GNUNET_CHAT_InternalArchive*
+get_context_archive (struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert((context) && (context->handle));
+
+  const struct GNUNET_CHAT_Handle *handle = context->handle;
+
+  if (GNUNET_YES != handle->message_cache)
+  {
+    release_context_archive(context);
+    return NULL;
+  }
+
+  if ((context->archive) || (!(context->room)) || (!(handle->directory)))
+    return context->archive;
+
+  // Archives are kept per account because they contain the
+  // message flags and texts from its perspective.
+  struct GNUNET_HashCode key;
+  if (GNUNET_YES != handle_get_account_key(
+      handle, GNUNET_MESSENGER_room_get_key(context->room), &key))
+    return NULL;
+
+  char *filename;
+  util_get_filename(handle->directory, "archive", &key, &filename);
+
+  context->archive = internal_archive_create(filename);
+
+  GNUNET_free(filename);
+  return context->archive;
+}
+
+static void
+store_context_stats (const struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert((context) && (context->handle) && (context->room));
+
+  if (!(context->messages))
+    return;
 
-  context->query = NULL;
+  const struct GNUNET_CHAT_Handle *handle = context->handle;
+  const unsigned int messages = GNUNET_CONTAINER_multihashmap_size(
+    context->messages
+  );
+
+  struct GNUNET_HashCode key;
+  if ((!(handle->directory)) || (!messages) ||
+      (GNUNET_YES != handle_get_account_key(
+        handle, GNUNET_MESSENGER_room_get_key(context->room), &key)))
+    return;
+
+  struct GNUNET_CHAT_ContextStats stored;
+  stored.messages = htonl(messages);
+  stored.taggings = htonl(
+    GNUNET_CONTAINER_multihashmap_size(context->taggings));
+  stored.files = htonl(
+    GNUNET_CONTAINER_multihashmap_size(context->files));
+  stored.members = htonl(
+    GNUNET_CONTAINER_multishortmap_size(context->timestamps));
+
+  util_store_stats(
+    handle->directory,
+    "stats/contexts",
+    &key,
+    &stored,
+    sizeof(stored)
+  );
 }
 
 struct GNUNET_CHAT_Context*
@@ -86,8 +266,8 @@ context_create_from_room (struct GNUNET_CHAT_Handle *handle,
 
   context->handle = handle;
   context->type = GNUNET_CHAT_CONTEXT_TYPE_UNKNOWN;
-  
-  init_new_context(context, initial_map_size_of_room);
+
+  init_new_context(context);
 
   context->room = room;
   context->contact = NULL;
@@ -104,6 +284,7 @@ context_create_from_room (struct GNUNET_CHAT_Handle *handle,
   else
     context->type = GNUNET_CHAT_CONTEXT_TYPE_CONTACT;
 
+  get_context_archive(context);
   return context;
 }
 
@@ -118,16 +299,67 @@ context_create_from_contact (struct GNUNET_CHAT_Handle *handle,
   context->handle = handle;
   context->type = GNUNET_CHAT_CONTEXT_TYPE_CONTACT;
 
-  init_new_context(context, initial_map_size_of_contact);
+  init_new_context(context);
 
   context->room = NULL;
   context->contact = contact;
 
+  context_materialize(context);
   return context;
 }
 
 void
-context_destroy (struct GNUNET_CHAT_Context *context)
+context_materialize (struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert((context) && (context->handle));
+
+  if (context->messages)
+    return;
+
+  struct GNUNET_CHAT_ContextStats stats;
+
+  if (context->room)
+  {
+    load_context_stats(
+      context->handle, GNUNET_MESSENGER_room_get_key(context->room), &stats
+    );
+
+    init_context_maps(context, initial_map_size_of_room, &stats);
+  }
+  else
+  {
+    memset(&stats, 0, sizeof(stats));
+
+    init_context_maps(context, initial_map_size_of_contact, &stats);
+  }
+}
+
+static void
+release_context_taggings (struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert((context) && (context->handle) && (context->taggings));
+
+  if (!GNUNET_CONTAINER_multihashmap_size(context->taggings))
+    return;
+
+  // Contacts cache tag messages of the context which get
+  // destroyed along with the messages and must not be used.
+  if (context->handle->contacts)
+    GNUNET_CONTAINER_multishortmap_iterate(
+      context->handle->contacts, it_untrack_context_taggings, context
+    );
+
+  // Taggings remove their messages from the tag index of the
+  // handle, so they need to be destroyed before the messages.
+  GNUNET_CONTAINER_multihashmap_iterate(
+    context->taggings, it_destroy_context_taggings, NULL
+  );
+
+  GNUNET_CONTAINER_multihashmap_clear(context->taggings);
+}
+
+static void
+release_context_maps (struct GNUNET_CHAT_Context *context)
 {
   GNUNET_assert(
     (context) &&
@@ -137,30 +369,34 @@ context_destroy (struct GNUNET_CHAT_Context *context)
     (context->taggings) &&
     (context->invites) &&
     (context->files) &&
-    (context->discourses)
+    (context->discourses) &&
+    (context->timeline) &&
+    (context->receipts)
   );
 
-  if (context->request_task)
-    GNUNET_SCHEDULER_cancel(context->request_task);
-
-  if (context->query)
-    GNUNET_NAMESTORE_cancel(context->query);
-
   GNUNET_CONTAINER_multishortmap_iterate(
-    context->timestamps, it_destroy_context_timestamps, NULL
+    context->timestamps, it_destroy_context_timestamps,
+    context->handle->timestamp_pool
   );
 
-  GNUNET_CONTAINER_multihashmap_clear(context->dependencies);
+  internal_backfill_destroy(context->backfill);
+  internal_dependencies_destroy(context->dependencies);
+  internal_timeline_destroy(context->timeline);
+  internal_receipts_destroy(context->receipts);
+
+  release_context_archive(context);
+  release_context_taggings(context);
+
   GNUNET_CONTAINER_multihashmap_iterate(
     context->messages, it_destroy_context_messages, NULL
   );
 
   GNUNET_CONTAINER_multihashmap_iterate(
-    context->taggings, it_destroy_context_taggings, NULL
+    context->invites, it_destroy_context_invites, context
   );
 
   GNUNET_CONTAINER_multihashmap_iterate(
-    context->invites, it_destroy_context_invites, context
+    context->files, it_drop_context_files, context->handle->store
   );
 
   GNUNET_CONTAINER_multishortmap_iterate(
@@ -170,13 +406,35 @@ context_destroy (struct GNUNET_CHAT_Context *context)
   GNUNET_CONTAINER_multishortmap_destroy(context->member_pointers);
 
   GNUNET_CONTAINER_multishortmap_destroy(context->timestamps);
-  GNUNET_CONTAINER_multihashmap_destroy(context->dependencies);
   GNUNET_CONTAINER_multihashmap_destroy(context->messages);
-  GNUNET_CONTAINER_multihashmap_destroy(context->requests);
   GNUNET_CONTAINER_multihashmap_destroy(context->taggings);
   GNUNET_CONTAINER_multihashmap_destroy(context->invites);
   GNUNET_CONTAINER_multihashmap_destroy(context->files);
   GNUNET_CONTAINER_multishortmap_destroy(context->discourses);
+}
+
+void
+context_destroy (struct GNUNET_CHAT_Context *context)
+{
+  GNUNET_assert(context);
+
+  // No callbacks may run during destruction, so a pending batch gets
+  // dropped here. The handle flushes all batches before disconnecting.
+  if (context->batch_task)
+    GNUNET_SCHEDULER_cancel(context->batch_task);
+
+  context->batch_task = NULL;
+  context->batch_count = 0;
+
+  if (context->room)
+    store_context_stats(context);
+
+  GNUNET_array_grow(context->batch, context->batch_size, 0);
+
+  if (context->messages)
+    release_context_maps(context);
+  else
+    release_context_archive(context);
 
   if (context->topic)
     GNUNET_free(context->topic);
@@ -187,31 +445,74 @@ context_destroy (struct GNUNET_CHAT_Context *context)
   GNUNET_free(context);
 }
 
+void
+context_reserve_messages (struct GNUNET_CHAT_Context* context,
+                          unsigned int amount)
+{
+  GNUNET_assert((context) && (context->messages) && (context->timeline));
+
+  if (amount > maximum_map_size_of_context)
+    amount = maximum_map_size_of_context;
+
+  if (amount <= context->capacity)
+    return;
+
+  struct GNUNET_CONTAINER_MultiHashMap *messages;
+  messages = GNUNET_CONTAINER_multihashmap_create(amount, GNUNET_NO);
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    context->messages, it_move_context_messages, messages
+  );
+
+  GNUNET_CONTAINER_multihashmap_destroy(context->messages);
+  context->messages = messages;
+
+  internal_timeline_reserve(context->timeline, amount);
+  context->capacity = amount;
+}
+
+void
+context_configure_dependencies (struct GNUNET_CHAT_Context* context)
+{
+  GNUNET_assert((context) && (context->handle));
+
+  if (!(context->dependencies))
+    return;
+
+  const struct GNUNET_CHAT_Handle *handle = context->handle;
+
+  internal_dependencies_configure(
+    context->dependencies,
+    handle->dependency_limit,
+    handle->dependency_timeout
+  );
+}
+
+void
+context_configure_archive (struct GNUNET_CHAT_Context* context)
+{
+  GNUNET_assert((context) && (context->handle));
+
+  if (GNUNET_YES != context->handle->message_cache)
+    release_context_archive(context);
+}
+
 void
 context_request_message (struct GNUNET_CHAT_Context* context,
-                         const struct GNUNET_HashCode *hash)
+                         const struct GNUNET_HashCode *hash,
+                         struct GNUNET_TIME_Absolute timestamp)
 {
   GNUNET_assert((context) && (hash));
 
-  if ((!(context->room)) || (GNUNET_YES == context->deleted))
+  if ((!(context->room)) || (!(context->messages)) ||
+      (GNUNET_YES == context->deleted))
     return;
 
   if ((GNUNET_is_zero(hash)) || 
       (GNUNET_YES == GNUNET_CONTAINER_multihashmap_contains(context->messages, hash)))
     return;
 
-  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(context->requests,
-      hash, NULL, GNUNET_CONTAINER_MULTIHASHMAPOPTION_REPLACE))
-    return;
-  
-  if (context->request_task)
-    return;
-
-  context->request_task = GNUNET_SCHEDULER_add_with_priority(
-    GNUNET_SCHEDULER_PRIORITY_BACKGROUND,
-    cb_context_request_messages,
-    context
-  );
+  internal_backfill_request(context->backfill, hash, timestamp);
 }
 
 void
@@ -220,6 +521,9 @@ context_update_message (struct GNUNET_CHAT_Context* context,
 {
   GNUNET_assert((context) && (hash));
 
+  if (!(context->messages))
+    return;
+
   struct GNUNET_CHAT_Message *message = GNUNET_CONTAINER_multihashmap_get(
     context->messages, hash);
   
@@ -228,34 +532,114 @@ context_update_message (struct GNUNET_CHAT_Context* context,
 
   message->flags |= GNUNET_MESSENGER_FLAG_UPDATE;
 
+  context_deliver_message(context, message);
+}
+
+void
+context_deliver_message (struct GNUNET_CHAT_Context *context,
+                         struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((context) && (context->handle) && (message));
+
   struct GNUNET_CHAT_Handle *handle = context->handle;
 
-  if (!(handle->msg_cb))
+  if (!(handle->batch_cb))
+  {
+    if (handle->msg_cb)
+      handle->msg_cb(handle->msg_cls, context, message);
+
+    return;
+  }
+
+  if (context->batch_count >= context->batch_size)
+    GNUNET_array_grow(
+      context->batch,
+      context->batch_size,
+      handle->batch_size > context->batch_count?
+      handle->batch_size : context->batch_count + 1
+    );
+
+  context->batch[context->batch_count++] = message;
+
+  if (context->batch_count >= handle->batch_size)
+  {
+    context_flush_messages(context);
+    return;
+  }
+
+  if (context->batch_task)
     return;
 
-  handle->msg_cb(handle->msg_cls, context, message);
+  context->batch_task = GNUNET_SCHEDULER_add_delayed(
+    handle->batch_delay,
+    cb_context_flush_messages,
+    context
+  );
 }
 
 void
-context_update_room (struct GNUNET_CHAT_Context *context,
-                     struct GNUNET_MESSENGER_Room *room,
-                     enum GNUNET_GenericReturnValue record)
+context_flush_messages (struct GNUNET_CHAT_Context *context)
 {
-  GNUNET_assert(context);
+  GNUNET_assert((context) && (context->handle));
 
-  if (room == context->room)
+  if (context->batch_task)
+  {
+    GNUNET_SCHEDULER_cancel(context->batch_task);
+    context->batch_task = NULL;
+  }
+
+  if (!(context->batch_count))
     return;
 
+  struct GNUNET_CHAT_Handle *handle = context->handle;
+
+  struct GNUNET_CHAT_Message **batch = context->batch;
+  unsigned int size = context->batch_size;
+  unsigned int count = context->batch_count;
+
+  context->batch = NULL;
+  context->batch_size = 0;
+  context->batch_count = 0;
+
+  if (handle->batch_cb)
+    handle->batch_cb(handle->batch_cls, context, batch, count);
+  else if (handle->msg_cb)
+    for (unsigned int i = 0; i < count; i++)
+      handle->msg_cb(handle->msg_cls, context, batch[i]);
+
+  if (context->batch)
+    GNUNET_array_grow(batch, size, 0);
+  else
+  {
+    context->batch = batch;
+    context->batch_size = size;
+  }
+}
+
+static void
+clear_context_maps (struct GNUNET_CHAT_Context *context)
+{
   GNUNET_assert(
+    (context) &&
     (context->timestamps) &&
     (context->messages) &&
-    (context->requests) &&
+    (context->taggings) &&
+    (context->backfill) &&
     (context->invites) &&
     (context->discourses)
   );
 
+  // The maps get cleared when the context changes its room, so
+  // the statistics of the previous room need to be kept.
+  if (context->room)
+    store_context_stats(context);
+
+  internal_dependencies_clear(context->dependencies);
+  release_context_taggings(context);
+
   GNUNET_CONTAINER_multishortmap_iterate(
-    context->timestamps, it_destroy_context_timestamps, NULL
+    context->timestamps, it_destroy_context_timestamps,
+    context->handle->timestamp_pool
   );
 
   GNUNET_CONTAINER_multihashmap_iterate(
@@ -274,19 +658,49 @@ context_update_room (struct GNUNET_CHAT_Context *context,
   context->timestamps = GNUNET_CONTAINER_multishortmap_create(
     initial_map_size_of_room, GNUNET_NO);
 
+  internal_timeline_clear(context->timeline);
+  internal_receipts_clear(context->receipts);
+
   GNUNET_CONTAINER_multihashmap_clear(context->messages);
-  GNUNET_CONTAINER_multihashmap_clear(context->requests);
+  internal_backfill_clear(context->backfill);
   GNUNET_CONTAINER_multihashmap_clear(context->invites);
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    context->files, it_release_context_files, context->handle->store
+  );
+
   GNUNET_CONTAINER_multihashmap_clear(context->files);
+  handle_update_files(context->handle);
 
   GNUNET_CONTAINER_multishortmap_destroy(context->discourses);
   context->discourses = GNUNET_CONTAINER_multishortmap_create(
     initial_map_size_of_room, GNUNET_NO);
+}
+
+void
+context_update_room (struct GNUNET_CHAT_Context *context,
+                     struct GNUNET_MESSENGER_Room *room,
+                     enum GNUNET_GenericReturnValue record)
+{
+  GNUNET_assert(context);
+
+  if (room == context->room)
+    return;
+
+  // Deliver batched messages of the previous room before
+  // they get destroyed along with the maps of the context.
+  context_flush_messages(context);
+
+  if (context->messages)
+    clear_context_maps(context);
 
   if (context->room)
     context_delete(context, GNUNET_YES);
 
+  release_context_archive(context);
+
   context->room = room;
+  get_context_archive(context);
 
   if ((!(context->room)) || (GNUNET_YES != record))
     return;
@@ -294,6 +708,54 @@ context_update_room (struct GNUNET_CHAT_Context *context,
   context_write_records(context);
 }
 
+void
+context_archive_message (struct GNUNET_CHAT_Context *context,
+                         const struct GNUNET_CHAT_Message *message,
+                         const struct GNUNET_ShortHashCode *sender)
+{
+  GNUNET_assert((context) && (message));
+
+  if (GNUNET_YES != message_has_msg(message))
+    return;
+
+  struct GNUNET_CHAT_InternalArchive *archive = get_context_archive(context);
+
+  if (!archive)
+    return;
+
+  internal_archive_append(
+    archive,
+    &(message->hash),
+    sender,
+    message->flags,
+    message->msg
+  );
+}
+
+int
+context_iterate_archive (struct GNUNET_CHAT_Context *context,
+                         GNUNET_CHAT_ContextMessageCallback callback,
+                         void *cls)
+{
+  GNUNET_assert(context);
+
+  struct GNUNET_CHAT_InternalArchive *archive = get_context_archive(context);
+
+  if ((!archive) || (GNUNET_OK != internal_archive_load(archive)))
+    return GNUNET_SYSERR;
+
+  context_materialize(context);
+
+  struct GNUNET_CHAT_ContextIterateArchive it;
+  it.context = context;
+  it.cb = callback;
+  it.cls = cls;
+  it.result = 0;
+
+  internal_archive_iterate(archive, it_context_iterate_archive, &it);
+  return it.result;
+}
+
 void
 context_update_nick (struct GNUNET_CHAT_Context *context,
                      const char *nick)
@@ -398,6 +860,8 @@ context_delete_message (struct GNUNET_CHAT_Context *context,
   if (GNUNET_YES != message_has_msg(message))
     return;
 
+  internal_timeline_remove(context->timeline, message);
+
   struct GNUNET_CHAT_Handle *handle = context->handle;
 
   switch (message->msg->header.kind)
@@ -425,7 +889,15 @@ context_delete_message (struct GNUNET_CHAT_Context *context,
       if (GNUNET_YES != GNUNET_CONTAINER_multihashmap_contains(context->files, &(message->hash)))
         break;
 
+      struct GNUNET_CHAT_InternalStoreEntry *entry = GNUNET_CONTAINER_multihashmap_get(
+        context->files, &(message->hash)
+      );
+
+      if (entry)
+        internal_store_release(context->handle->store, entry);
+
       GNUNET_CONTAINER_multihashmap_remove_all(context->files, &(message->hash));
+      handle_update_files(context->handle);
       break;
     }
     case GNUNET_MESSENGER_KIND_TAG:
@@ -435,10 +907,20 @@ context_delete_message (struct GNUNET_CHAT_Context *context,
         &(message->msg->body.tag.hash)
       );
 
-      if (!tagging)
+      if ((!tagging) || (GNUNET_YES != internal_tagging_remove(tagging, message)) ||
+          (!(context->room)))
         break;
 
-      internal_tagging_remove(tagging, message);
+      const struct GNUNET_MESSENGER_Contact *target = GNUNET_MESSENGER_get_sender(
+        context->room, &(message->msg->body.tag.hash)
+      );
+
+      struct GNUNET_CHAT_Contact *tagged = target? handle_get_contact_from_messenger(
+        handle, target
+      ) : NULL;
+
+      if (tagged)
+        contact_untrack_tag(tagged, message);
       break;
     }
     default:
@@ -544,18 +1026,7 @@ context_write_records (struct GNUNET_CHAT_Context *context)
   }
 
 skip_record_data:
-  if (context->query)
-    GNUNET_NAMESTORE_cancel(context->query);
-
-  context->query = GNUNET_NAMESTORE_record_set_store(
-    context->handle->namestore,
-    zone,
-    label,
-    count,
-    data,
-    cont_context_write_records,
-    context
-  );
+  handle_write_records(context->handle, label, count, data);
 
   GNUNET_free(label);
 }
@@ -572,11 +1043,8 @@ context_delete (struct GNUNET_CHAT_Context *context,
   if (GNUNET_YES != exit)
     return;
 
-  if (context->request_task)
-  {
-    GNUNET_SCHEDULER_cancel(context->request_task);
-    context->request_task = NULL;
-  }
+  if (context->backfill)
+    internal_backfill_clear(context->backfill);
 
   GNUNET_MESSENGER_close_room(context->room);
 }
@@ -35,37 +35,57 @@
 
 struct GNUNET_CHAT_Handle;
 struct GNUNET_CHAT_Message;
+struct GNUNET_CHAT_InternalArchive;
+struct GNUNET_CHAT_InternalBackfill;
+struct GNUNET_CHAT_InternalDependencies;
+struct GNUNET_CHAT_InternalReceipts;
+struct GNUNET_CHAT_InternalTimeline;
+
+struct GNUNET_CHAT_ContextStats
+{
+  uint32_t messages;
+  uint32_t taggings;
+  uint32_t files;
+  uint32_t members;
+};
 
 struct GNUNET_CHAT_Context
 {
   struct GNUNET_CHAT_Handle *handle;
 
   union GNUNET_MESSENGER_RoomKey key;
+  struct GNUNET_PeerIdentity door;
   enum GNUNET_CHAT_ContextType type;
   uint32_t flags;
   char *nick;
   char *topic;
   int deleted;
 
-  struct GNUNET_SCHEDULER_Task *request_task;
+  struct GNUNET_CHAT_Message **batch;
+  unsigned int batch_size;
+  unsigned int batch_count;
+  struct GNUNET_SCHEDULER_Task *batch_task;
 
   struct GNUNET_CONTAINER_MultiShortmap *timestamps;
-  struct GNUNET_CONTAINER_MultiHashMap *dependencies;
   struct GNUNET_CONTAINER_MultiHashMap *messages;
-  struct GNUNET_CONTAINER_MultiHashMap *requests;
   struct GNUNET_CONTAINER_MultiHashMap *taggings;
   struct GNUNET_CONTAINER_MultiHashMap *invites;
   struct GNUNET_CONTAINER_MultiHashMap *files;
   struct GNUNET_CONTAINER_MultiShortmap *discourses;
 
+  struct GNUNET_CHAT_InternalBackfill *backfill;
+  struct GNUNET_CHAT_InternalDependencies *dependencies;
+  struct GNUNET_CHAT_InternalTimeline *timeline;
+  struct GNUNET_CHAT_InternalReceipts *receipts;
+  struct GNUNET_CHAT_InternalArchive *archive;
+  unsigned int capacity;
+
   struct GNUNET_MESSENGER_Room *room;
   const struct GNUNET_MESSENGER_Contact *contact;
 
   void *user_pointer;
 
   struct GNUNET_CONTAINER_MultiShortmap *member_pointers;
-
-  struct GNUNET_NAMESTORE_QueueEntry *query;
 };
 
 /**
@@ -92,6 +112,17 @@ struct GNUNET_CHAT_Context*
 context_create_from_contact (struct GNUNET_CHAT_Handle *handle,
 			                       const struct GNUNET_MESSENGER_Contact *contact);
 
+/**
+ * Allocates the maps and internal structures of a given chat
+ * <i>context</i> to handle its messages unless it has been done
+ * already. Contexts from rooms only keep their key, type, nick
+ * and topic until they get accessed the first time.
+ *
+ * @param[in,out] context Chat context
+ */
+void
+context_materialize (struct GNUNET_CHAT_Context *context);
+
 /**
  * Destroys a chat <i>context</i> and frees its memory.
  *
@@ -100,16 +131,48 @@ context_create_from_contact (struct GNUNET_CHAT_Handle *handle,
 void
 context_destroy (struct GNUNET_CHAT_Context* context);
 
+/**
+ * Prepares the maps of a given chat <i>context</i> to hold an
+ * expected <i>amount</i> of messages without growing repeatedly.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] amount Expected amount of messages
+ */
+void
+context_reserve_messages (struct GNUNET_CHAT_Context* context,
+                          unsigned int amount);
+
+/**
+ * Applies the limits for resolving message dependencies
+ * configured in the handle of a given chat <i>context</i>.
+ *
+ * @param[in,out] context Chat context
+ */
+void
+context_configure_dependencies (struct GNUNET_CHAT_Context* context);
+
+/**
+ * Releases the message cache of a given chat <i>context</i>
+ * if it got disabled in the handle of the context.
+ *
+ * @param[in,out] context Chat context
+ */
+void
+context_configure_archive (struct GNUNET_CHAT_Context* context);
+
 /**
  * Request a message from a chat <i>context</i> with a
- * given <i>hash</i>.
+ * given <i>hash</i>. Requests referred by messages with
+ * a newer <i>timestamp</i> get sent first.
  *
  * @param[in,out] context Chat context
  * @param[in] hash Message hash
+ * @param[in] timestamp Timestamp of the referring message
  */
 void
 context_request_message (struct GNUNET_CHAT_Context* context,
-                         const struct GNUNET_HashCode *hash);
+                         const struct GNUNET_HashCode *hash,
+                         struct GNUNET_TIME_Absolute timestamp);
 
 /**
  * Updates a message with a given <i>hash</i> inside a
@@ -122,6 +185,57 @@ void
 context_update_message (struct GNUNET_CHAT_Context* context,
                         const struct GNUNET_HashCode *hash);
 
+/**
+ * Delivers a chat <i>message</i> from a given chat <i>context</i>
+ * to the client of its chat handle. Depending on the handle, the
+ * message gets passed to the message callback directly or it gets
+ * appended to the pending batch of the context.
+ *
+ * @param[in,out] context Chat context
+ * @param[in,out] message Chat message
+ */
+void
+context_deliver_message (struct GNUNET_CHAT_Context *context,
+                         struct GNUNET_CHAT_Message *message);
+
+/**
+ * Passes all pending messages of a given chat <i>context</i>
+ * to the batch callback of its chat handle at once.
+ *
+ * @param[in,out] context Chat context
+ */
+void
+context_flush_messages (struct GNUNET_CHAT_Context *context);
+
+/**
+ * Appends the metadata of a chat <i>message</i> from a given
+ * chat <i>context</i> to its message cache on disk if the
+ * chat handle of the context has it enabled.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] message Chat message
+ * @param[in] sender Shorthash of the sender or NULL
+ */
+void
+context_archive_message (struct GNUNET_CHAT_Context *context,
+                         const struct GNUNET_CHAT_Message *message,
+                         const struct GNUNET_ShortHashCode *sender);
+
+/**
+ * Iterates through the messages of a given chat <i>context</i>
+ * from its message cache on disk which have not been received
+ * from the messenger service yet, ordered by their timestamp.
+ *
+ * @param[in,out] context Chat context
+ * @param[in] callback Callback for message iteration (optional)
+ * @param[in,out] cls Closure for message iteration (optional)
+ * @return Amount of messages iterated or #GNUNET_SYSERR on failure
+ */
+int
+context_iterate_archive (struct GNUNET_CHAT_Context *context,
+                         GNUNET_CHAT_ContextMessageCallback callback,
+                         void *cls);
+
 /**
  * Updates the connected messenger <i>room</i> of a
  * selected chat <i>context</i>.
@@ -173,7 +287,8 @@ context_read_records (struct GNUNET_CHAT_Context *context,
 
 /**
  * Writes the data from a selected chat <i>context</i> into
- * the namestore as private records.
+ * the namestore as private records. The records get queued
+ * in its chat handle to coalesce frequent updates.
  *
  * @param[in,out] context Chat context
  */
@@ -26,6 +26,8 @@
 #include "gnunet_chat_invitation.h"
 #include "gnunet_chat_message.h"
 
+#include "internal/gnunet_chat_archive.h"
+#include "internal/gnunet_chat_pool.h"
 #include "internal/gnunet_chat_tagging.h"
 
 #include <gnunet/gnunet_common.h>
@@ -35,14 +37,15 @@
 #define GNUNET_UNUSED __attribute__ ((unused))
 
 enum GNUNET_GenericReturnValue
-it_destroy_context_timestamps (GNUNET_UNUSED void *cls,
+it_destroy_context_timestamps (void *cls,
                                GNUNET_UNUSED const struct GNUNET_ShortHashCode *key,
                                void *value)
 {
-  GNUNET_assert(value);
+  GNUNET_assert((cls) && (value));
 
+  struct GNUNET_CHAT_InternalPool *pool = cls;
   struct GNUNET_TIME_Absolute *time = value;
-  GNUNET_free(time);
+  internal_pool_free(pool, time);
   return GNUNET_YES;
 }
 
@@ -70,6 +73,20 @@ it_destroy_context_taggings (GNUNET_UNUSED void *cls,
   return GNUNET_YES;
 }
 
+enum GNUNET_GenericReturnValue
+it_untrack_context_taggings (void *cls,
+                             GNUNET_UNUSED const struct GNUNET_ShortHashCode *key,
+                             void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  const struct GNUNET_CHAT_Context *context = cls;
+  struct GNUNET_CHAT_Contact *contact = value;
+
+  contact_untrack_context(contact, context);
+  return GNUNET_YES;
+}
+
 enum GNUNET_GenericReturnValue
 it_destroy_context_invites (void *cls,
                             GNUNET_UNUSED const struct GNUNET_HashCode *key,
@@ -89,6 +106,34 @@ it_destroy_context_invites (void *cls,
   return GNUNET_YES;
 }
 
+enum GNUNET_GenericReturnValue
+it_release_context_files (void *cls,
+                          GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  struct GNUNET_CHAT_InternalStore *store = cls;
+  struct GNUNET_CHAT_InternalStoreEntry *entry = value;
+
+  if ((store) && (entry))
+    internal_store_release(store, entry);
+
+  return GNUNET_YES;
+}
+
+enum GNUNET_GenericReturnValue
+it_drop_context_files (void *cls,
+                       GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                       void *value)
+{
+  struct GNUNET_CHAT_InternalStore *store = cls;
+  struct GNUNET_CHAT_InternalStoreEntry *entry = value;
+
+  if ((store) && (entry))
+    internal_store_drop(store, entry);
+
+  return GNUNET_YES;
+}
+
 enum GNUNET_GenericReturnValue
 it_destroy_context_discourses (GNUNET_UNUSED void *cls,
                                GNUNET_UNUSED const struct GNUNET_ShortHashCode *key,
@@ -102,57 +147,118 @@ it_destroy_context_discourses (GNUNET_UNUSED void *cls,
 }
 
 enum GNUNET_GenericReturnValue
-it_iterate_context_requests (void *cls,
-                             const struct GNUNET_HashCode *key,
-                             GNUNET_UNUSED void *value)
+it_destroy_context_archive (GNUNET_UNUSED void *cls,
+                            struct GNUNET_CHAT_InternalArchiveEntry *entry)
 {
-  struct GNUNET_CHAT_Context *context = cls;
+  GNUNET_assert(entry);
+
+  if (entry->message)
+    message_destroy(entry->message);
+
+  entry->message = NULL;
+  return GNUNET_YES;
+}
+
+struct GNUNET_CHAT_ContextIterateArchive
+{
+  struct GNUNET_CHAT_Context *context;
+  GNUNET_CHAT_ContextMessageCallback cb;
+  void *cls;
+  int result;
+};
+
+enum GNUNET_GenericReturnValue
+it_context_iterate_archive (void *cls,
+                            struct GNUNET_CHAT_InternalArchiveEntry *entry)
+{
+  GNUNET_assert((cls) && (entry));
+
+  struct GNUNET_CHAT_ContextIterateArchive *it = cls;
 
-  GNUNET_assert((context) && (context->room) && (key));
+  if ((entry->flags & GNUNET_MESSENGER_FLAG_DELETE) ||
+      (GNUNET_YES == GNUNET_CONTAINER_multihashmap_contains(
+        it->context->messages, &(entry->hash))))
+    return GNUNET_YES;
+
+  if (!(entry->message))
+    entry->message = message_create_from_msg(
+      it->context, &(entry->hash), entry->flags, &(entry->msg)
+    );
 
-  GNUNET_MESSENGER_get_message(context->room, key);
+  it->result++;
+
+  if (!(it->cb))
+    return GNUNET_YES;
+
+  return it->cb(it->cls, it->context, entry->message);
+}
+
+enum GNUNET_GenericReturnValue
+it_move_context_messages (void *cls,
+                          const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert((cls) && (key) && (value));
+
+  struct GNUNET_CONTAINER_MultiHashMap *messages = cls;
+
+  GNUNET_CONTAINER_multihashmap_put(
+    messages, key, value,
+    GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST
+  );
 
   return GNUNET_YES;
 }
 
 void
-cb_context_request_messages (void *cls)
+cb_context_request_message (void *cls,
+                            const struct GNUNET_HashCode *hash)
 {
   struct GNUNET_CHAT_Context *context = cls;
 
-  GNUNET_assert(context);
-
-  context->request_task = NULL;
+  GNUNET_assert((context) && (hash));
 
   if ((!(context->room)) || (GNUNET_YES == context->deleted))
     return;
 
-  GNUNET_CONTAINER_multihashmap_iterate(
-    context->requests,
-    it_iterate_context_requests,
-    context
-  );
+  GNUNET_MESSENGER_get_message(context->room, hash);
+}
+
+void
+cb_context_fetch_dependency (void *cls,
+                             const struct GNUNET_HashCode *hash)
+{
+  struct GNUNET_CHAT_Context *context = cls;
+
+  GNUNET_assert((context) && (hash));
+
+  // Missing dependencies are requested via the backfill, so they
+  // share its limit of outstanding requests and get retried.
+  context_request_message(context, hash, GNUNET_TIME_absolute_get());
+}
 
-  GNUNET_CONTAINER_multihashmap_clear(context->requests);
+void
+cb_context_release_dependency (void *cls,
+                               struct GNUNET_CHAT_Message *message)
+{
+  struct GNUNET_CHAT_Context *context = cls;
+
+  GNUNET_assert((context) && (message));
+
+  if (message->task)
+    return;
+
+  handle_process_message(context->handle, message);
 }
 
 void
-cont_context_write_records (void *cls,
-			                      enum GNUNET_ErrorCode ec)
+cb_context_flush_messages (void *cls)
 {
   struct GNUNET_CHAT_Context *context = cls;
 
   GNUNET_assert(context);
 
-  context->query = NULL;
+  context->batch_task = NULL;
 
-  if (GNUNET_EC_NONE != ec)
-    handle_send_internal_message(
-      context->handle,
-      NULL,
-      context,
-      GNUNET_CHAT_FLAG_WARNING,
-      GNUNET_ErrorCode_get_hint(ec),
-      GNUNET_YES
-    );
+  context_flush_messages(context);
 }
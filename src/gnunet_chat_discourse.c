@@ -28,10 +28,14 @@
 #include <gnunet/gnunet_scheduler_lib.h>
 #include <gnunet/gnunet_time_lib.h>
 
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "gnunet_chat_discourse_intern.c"
 
+static const unsigned int initial_map_size_of_discourse = 8;
+static const unsigned int default_write_window_of_discourse = 8;
+
 struct GNUNET_CHAT_Discourse*
 discourse_create (struct GNUNET_CHAT_Context *context,
                   const struct GNUNET_CHAT_DiscourseId *id)
@@ -49,13 +53,38 @@ discourse_create (struct GNUNET_CHAT_Context *context,
     discourse->pipe[0] = -1;
     discourse->pipe[1] = -1;
   }
+  else
+  {
+    const int flags = fcntl(discourse->pipe[0], F_GETFL);
+
+    if (-1 != flags)
+      fcntl(discourse->pipe[0], F_SETFL, flags | O_NONBLOCK);
+  }
 
   discourse->head = NULL;
   discourse->tail = NULL;
 
-  discourse->pipe_task = GNUNET_SCHEDULER_add_now(
-    cb_reinit_discourse_pipe, discourse
-  );
+  discourse->subscriptions = GNUNET_CONTAINER_multishortmap_create(
+    initial_map_size_of_discourse, GNUNET_NO);
+
+  if (-1 != discourse->pipe[0])
+    internal_poller_add(
+      context->handle->poller,
+      discourse->pipe[0],
+      cb_read_discourse_pipe,
+      discourse
+    );
+
+  discourse->writes_head = NULL;
+  discourse->writes_tail = NULL;
+
+  discourse->write_task = NULL;
+  discourse->write_window = default_write_window_of_discourse;
+  discourse->write_buffer = NULL;
+
+  discourse->destroyed = NULL;
+
+  discourse->playout = NULL;
 
   discourse->user_pointer = NULL;
 
@@ -68,6 +97,10 @@ discourse_remove_subscription (void *cls)
   struct GNUNET_CHAT_DiscourseSubscription *sub = cls;
   struct GNUNET_CHAT_Discourse *discourse = sub->discourse;
 
+  GNUNET_CONTAINER_multishortmap_remove(
+    discourse->subscriptions, &(sub->shorthash), sub
+  );
+
   GNUNET_CONTAINER_DLL_remove(
     discourse->head,
     discourse->tail,
@@ -77,23 +110,58 @@ discourse_remove_subscription (void *cls)
   GNUNET_free(sub);
 }
 
+static void
+cb_discourse_subscription_ended (void *cls)
+{
+  struct GNUNET_CHAT_DiscourseSubscription *sub = cls;
+
+  GNUNET_assert(sub);
+
+  sub->timer = NULL;
+
+  discourse_remove_subscription(sub);
+}
+
 void
 discourse_destroy (struct GNUNET_CHAT_Discourse *discourse)
 {
   GNUNET_assert(discourse);
 
+  if (discourse->destroyed)
+    *(discourse->destroyed) = GNUNET_YES;
+
+  struct GNUNET_CHAT_InternalTimers *timers;
+  timers = discourse->context->handle->timers;
+
   while (discourse->head)
   {
     struct GNUNET_CHAT_DiscourseSubscription *sub = discourse->head;
 
-    if (sub->task)
-      GNUNET_SCHEDULER_cancel(sub->task);
+    if (sub->timer)
+      internal_timers_cancel(timers, sub->timer);
 
     discourse_remove_subscription(sub);
   }
 
-  if (discourse->pipe_task)
-    GNUNET_SCHEDULER_cancel(discourse->pipe_task);
+  GNUNET_CONTAINER_multishortmap_destroy(discourse->subscriptions);
+
+  if (-1 != discourse->pipe[0])
+    internal_poller_remove(
+      discourse->context->handle->poller,
+      discourse->pipe[0]
+    );
+
+  if (discourse->write_task)
+    GNUNET_SCHEDULER_cancel(discourse->write_task);
+
+  while (discourse->writes_head)
+    remove_discourse_write(discourse, discourse->writes_head);
+
+  if (discourse->write_buffer)
+    GNUNET_free(discourse->write_buffer);
+
+  if (discourse->playout)
+    internal_playout_destroy(discourse->playout);
 
   if (-1 != discourse->pipe[0])
     close(discourse->pipe[0]);
@@ -119,10 +187,16 @@ discourse_subscribe (struct GNUNET_CHAT_Discourse *discourse,
   if (GNUNET_TIME_absolute_cmp(end, <, GNUNET_TIME_absolute_get()))
     return GNUNET_SYSERR;
 
+  struct GNUNET_CHAT_InternalTimers *timers;
+  timers = discourse->context->handle->timers;
+
+  struct GNUNET_ShortHashCode shorthash;
+  util_shorthash_from_member(contact->member, &shorthash);
+
   struct GNUNET_CHAT_DiscourseSubscription *sub;
-  for (sub = discourse->head; sub; sub = sub->next)
-    if (sub->contact == contact)
-      break;
+  sub = GNUNET_CONTAINER_multishortmap_get(
+    discourse->subscriptions, &shorthash
+  );
   
   const enum GNUNET_GenericReturnValue update = (
     sub? GNUNET_YES : GNUNET_NO
@@ -138,21 +212,32 @@ discourse_subscribe (struct GNUNET_CHAT_Discourse *discourse,
     sub->discourse = discourse;
     sub->contact = contact;
 
+    GNUNET_memcpy(&(sub->shorthash), &shorthash, sizeof(shorthash));
+
+    if (GNUNET_OK != GNUNET_CONTAINER_multishortmap_put(
+        discourse->subscriptions, &shorthash, sub,
+        GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+    {
+      GNUNET_free(sub);
+      return GNUNET_SYSERR;
+    }
+
     GNUNET_CONTAINER_DLL_insert(
       discourse->head,
       discourse->tail,
       sub
     );
   }
-  else if (sub->task)
-    GNUNET_SCHEDULER_cancel(sub->task);
+  else if (sub->timer)
+    internal_timers_cancel(timers, sub->timer);
 
   sub->start = timestamp;
   sub->end = end;
 
-  sub->task = GNUNET_SCHEDULER_add_at(
+  sub->timer = internal_timers_add_at(
+    timers,
     end,
-    discourse_remove_subscription,
+    cb_discourse_subscription_ended,
     sub
   );
 
@@ -167,10 +252,16 @@ discourse_unsubscribe (struct GNUNET_CHAT_Discourse *discourse,
 {
   GNUNET_assert((discourse) && (contact));
 
+  struct GNUNET_CHAT_InternalTimers *timers;
+  timers = discourse->context->handle->timers;
+
+  struct GNUNET_ShortHashCode shorthash;
+  util_shorthash_from_member(contact->member, &shorthash);
+
   struct GNUNET_CHAT_DiscourseSubscription *sub;
-  for (sub = discourse->head; sub; sub = sub->next)
-    if (sub->contact == contact)
-      break;
+  sub = GNUNET_CONTAINER_multishortmap_get(
+    discourse->subscriptions, &shorthash
+  );
 
   if ((!sub) || (GNUNET_TIME_absolute_cmp(sub->start, >, timestamp)))
     return;
@@ -182,15 +273,62 @@ discourse_unsubscribe (struct GNUNET_CHAT_Discourse *discourse,
   if (GNUNET_TIME_absolute_cmp(exit, <, sub->end))
     sub->end = exit;
 
-  if (sub->task)
-    GNUNET_SCHEDULER_cancel(sub->task);
+  if (sub->timer)
+    internal_timers_cancel(timers, sub->timer);
+
+  sub->timer = NULL;
 
   if (GNUNET_TIME_absolute_cmp(sub->end, <, GNUNET_TIME_absolute_get()))
     discourse_remove_subscription(sub);
   else
-    sub->task = GNUNET_SCHEDULER_add_at(
+    sub->timer = internal_timers_add_at(
+      timers,
       sub->end,
-      discourse_remove_subscription,
+      cb_discourse_subscription_ended,
       sub
     );
 }
+
+void
+discourse_writev (struct GNUNET_CHAT_Discourse *discourse,
+                  const struct iovec *iov,
+                  int iovcnt,
+                  GNUNET_CHAT_DiscourseWriteCallback callback,
+                  void *cls)
+{
+  GNUNET_assert((discourse) && (iov) && (iovcnt > 0));
+
+  struct GNUNET_CHAT_DiscourseWrite *write = GNUNET_new(
+    struct GNUNET_CHAT_DiscourseWrite
+  );
+
+  write->iov = GNUNET_new_array(iovcnt, struct iovec);
+  write->iovcnt = iovcnt;
+
+  GNUNET_memcpy(write->iov, iov, sizeof(*iov) * iovcnt);
+
+  write->index = 0;
+  write->offset = 0;
+
+  write->remaining = 0;
+  write->written = 0;
+
+  for (int i = 0; i < iovcnt; i++)
+    write->remaining += iov[i].iov_len;
+
+  write->callback = callback;
+  write->cls = cls;
+
+  GNUNET_CONTAINER_DLL_insert_tail(
+    discourse->writes_head,
+    discourse->writes_tail,
+    write
+  );
+
+  if (discourse->write_task)
+    return;
+
+  discourse->write_task = GNUNET_SCHEDULER_add_now(
+    cb_write_discourse_queue, discourse
+  );
+}
@@ -27,10 +27,14 @@
 
 #include "gnunet_chat_util.h"
 
+#include "internal/gnunet_chat_playout.h"
+#include "internal/gnunet_chat_timers.h"
+
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_messenger_service.h>
 #include <gnunet/gnunet_time_lib.h>
 #include <gnunet/gnunet_util_lib.h>
+#include <sys/uio.h>
 
 struct GNUNET_CHAT_Contact;
 struct GNUNET_CHAT_Context;
@@ -46,7 +50,26 @@ struct GNUNET_CHAT_DiscourseSubscription
   struct GNUNET_TIME_Absolute end;
 
   struct GNUNET_CHAT_Contact *contact;
-  struct GNUNET_SCHEDULER_Task *task;
+  struct GNUNET_ShortHashCode shorthash;
+  struct GNUNET_CHAT_InternalTimer *timer;
+};
+
+struct GNUNET_CHAT_DiscourseWrite
+{
+  struct GNUNET_CHAT_DiscourseWrite *prev;
+  struct GNUNET_CHAT_DiscourseWrite *next;
+
+  struct iovec *iov;
+  int iovcnt;
+
+  int index;
+  size_t offset;
+
+  uint64_t remaining;
+  uint64_t written;
+
+  GNUNET_CHAT_DiscourseWriteCallback callback;
+  void *cls;
 };
 
 struct GNUNET_CHAT_Discourse
@@ -59,7 +82,18 @@ struct GNUNET_CHAT_Discourse
   struct GNUNET_CHAT_DiscourseSubscription *head;
   struct GNUNET_CHAT_DiscourseSubscription *tail;
 
-  struct GNUNET_SCHEDULER_Task *pipe_task;
+  struct GNUNET_CONTAINER_MultiShortmap *subscriptions;
+
+  struct GNUNET_CHAT_DiscourseWrite *writes_head;
+  struct GNUNET_CHAT_DiscourseWrite *writes_tail;
+
+  struct GNUNET_SCHEDULER_Task *write_task;
+  unsigned int write_window;
+  char *write_buffer;
+
+  enum GNUNET_GenericReturnValue *destroyed;
+
+  struct GNUNET_CHAT_InternalPlayout *playout;
 
   void *user_pointer;
 };
@@ -118,4 +152,27 @@ discourse_unsubscribe (struct GNUNET_CHAT_Discourse *discourse,
                        const struct GNUNET_TIME_Absolute timestamp,
                        const struct GNUNET_TIME_Relative delay);
 
+/**
+ * Queues the data of an array of <i>iovcnt</i> buffers in
+ * <i>iov</i> to be sent to a given chat <i>discourse</i> in
+ * order. The data gets sent in chunks without more than the
+ * write window of the discourse per scheduler round and the
+ * <i>callback</i> gets called with its closure afterwards.
+ *
+ * The buffers need to stay valid until the callback gets
+ * called.
+ *
+ * @param[in,out] discourse Chat discourse
+ * @param[in] iov Array of buffers
+ * @param[in] iovcnt Amount of buffers
+ * @param[in] callback Callback for completion (optional)
+ * @param[in,out] cls Closure for completion (optional)
+ */
+void
+discourse_writev (struct GNUNET_CHAT_Discourse *discourse,
+                  const struct iovec *iov,
+                  int iovcnt,
+                  GNUNET_CHAT_DiscourseWriteCallback callback,
+                  void *cls);
+
 #endif /* GNUNET_CHAT_DISCOURSE_H_ */
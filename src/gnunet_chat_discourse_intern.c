@@ -23,6 +23,9 @@
  */
 
 #include "gnunet_chat_context.h"
+#include "gnunet_chat_handle.h"
+
+#include <errno.h>
 
 #define GNUNET_UNUSED __attribute__ ((unused))
 
@@ -32,44 +35,169 @@
   sizeof (struct GNUNET_MESSENGER_Message))
 
 static void
-cb_read_discourse_pipe (void *cls);
-
-void
-cb_reinit_discourse_pipe (void *cls)
+cb_read_discourse_pipe (void *cls,
+                        int fd)
 {
   struct GNUNET_CHAT_Discourse *discourse = cls;
 
-  GNUNET_assert(discourse);
+  GNUNET_assert((discourse) && (fd == discourse->pipe[0]));
+
+  struct GNUNET_MESSENGER_Message msg;
+  memset(&msg, 0, sizeof(msg));
+
+  msg.header.kind = GNUNET_MESSENGER_KIND_TALK;
+
+  util_shorthash_from_discourse_id(
+    &(discourse->id),
+    &(msg.body.talk.discourse)
+  );
+
+  char data [MAX_WRITE_SIZE];
+  ssize_t len;
+
+  do
+  {
+    len = read(fd, data, MAX_WRITE_SIZE);
+
+    if (len <= 0)
+      break;
 
-  discourse->pipe_task = NULL;
+    msg.body.talk.data = data;
+    msg.body.talk.length = (uint16_t) len;
 
-  if (-1 == discourse->pipe[0])
+    GNUNET_MESSENGER_send_message(discourse->context->room, &msg, NULL);
+  }
+  while (MAX_WRITE_SIZE == len);
+
+  if ((len > 0) || ((len < 0) && ((EAGAIN == errno) || (EINTR == errno))))
     return;
 
-  struct GNUNET_NETWORK_FDSet *rs = GNUNET_NETWORK_fdset_create();
+  // The pipe got closed or failed, so it would be reported
+  // readable over and over again.
+  internal_poller_remove(discourse->context->handle->poller, fd);
+}
 
-  GNUNET_NETWORK_fdset_set_native(rs, discourse->pipe[0]);
+static void
+remove_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
+                        struct GNUNET_CHAT_DiscourseWrite *write)
+{
+  GNUNET_assert((discourse) && (write));
 
-  discourse->pipe_task = GNUNET_SCHEDULER_add_select(
-    GNUNET_SCHEDULER_PRIORITY_DEFAULT,
-    GNUNET_TIME_UNIT_FOREVER_REL,
-    rs,
-    NULL,
-    cb_read_discourse_pipe,
-    discourse
+  GNUNET_CONTAINER_DLL_remove(
+    discourse->writes_head,
+    discourse->writes_tail,
+    write
   );
 
-  GNUNET_NETWORK_fdset_destroy(rs);
+  GNUNET_free(write->iov);
+  GNUNET_free(write);
 }
 
 static void
-cb_read_discourse_pipe (void *cls)
+complete_discourse_writes (struct GNUNET_CHAT_Discourse *discourse,
+                           struct GNUNET_CHAT_DiscourseWrite *head,
+                           struct GNUNET_CHAT_DiscourseWrite *tail)
+{
+  GNUNET_assert(discourse);
+
+  // The callbacks might destroy the discourse, so all further
+  // callbacks get skipped in that case.
+  enum GNUNET_GenericReturnValue destroyed = GNUNET_NO;
+  discourse->destroyed = &destroyed;
+
+  struct GNUNET_CHAT_DiscourseWrite *write;
+  while (head)
+  {
+    write = head;
+
+    GNUNET_CONTAINER_DLL_remove(head, tail, write);
+
+    if ((GNUNET_YES != destroyed) && (write->callback))
+      write->callback(write->cls, discourse, write->written);
+
+    GNUNET_free(write->iov);
+    GNUNET_free(write);
+  }
+
+  if (GNUNET_YES != destroyed)
+    discourse->destroyed = NULL;
+}
+
+static void
+prepare_discourse_talk (struct GNUNET_CHAT_Discourse *discourse,
+                        struct GNUNET_CHAT_DiscourseWrite *write,
+                        struct GNUNET_MESSENGER_MessageTalk *talk)
+{
+  GNUNET_assert((discourse) && (write) && (talk) && (write->remaining > 0));
+
+  while (write->offset >= write->iov[write->index].iov_len)
+  {
+    write->index++;
+    write->offset = 0;
+  }
+
+  const uint64_t length = (
+    write->remaining > MAX_WRITE_SIZE? MAX_WRITE_SIZE : write->remaining
+  );
+
+  const struct iovec *vec = &(write->iov[write->index]);
+  char *data = ((char*) vec->iov_base) + write->offset;
+
+  talk->length = (uint16_t) length;
+
+  write->remaining -= length;
+  write->written += length;
+
+  // Chunks within a single buffer get sent without copying,
+  // only chunks across buffers get gathered.
+  if (vec->iov_len - write->offset >= length)
+  {
+    talk->data = data;
+    write->offset += length;
+    return;
+  }
+
+  if (!(discourse->write_buffer))
+    discourse->write_buffer = GNUNET_malloc(MAX_WRITE_SIZE);
+
+  uint64_t gathered = 0;
+  uint64_t amount;
+
+  while (gathered < length)
+  {
+    vec = &(write->iov[write->index]);
+    amount = vec->iov_len - write->offset;
+
+    if (amount > length - gathered)
+      amount = length - gathered;
+
+    GNUNET_memcpy(
+      discourse->write_buffer + gathered,
+      ((const char*) vec->iov_base) + write->offset,
+      amount
+    );
+
+    gathered += amount;
+    write->offset += amount;
+
+    if (write->offset < vec->iov_len)
+      continue;
+
+    write->index++;
+    write->offset = 0;
+  }
+
+  talk->data = discourse->write_buffer;
+}
+
+void
+cb_write_discourse_queue (void *cls)
 {
   struct GNUNET_CHAT_Discourse *discourse = cls;
 
-  GNUNET_assert((discourse) && (-1 != discourse->pipe[0]));
+  GNUNET_assert(discourse);
 
-  discourse->pipe_task = NULL;
+  discourse->write_task = NULL;
 
   struct GNUNET_MESSENGER_Message msg;
   memset(&msg, 0, sizeof(msg));
@@ -81,27 +209,48 @@ cb_read_discourse_pipe (void *cls)
     &(msg.body.talk.discourse)
   );
 
-  char data [MAX_WRITE_SIZE];
-  ssize_t len;
+  struct GNUNET_CHAT_DiscourseWrite *completed_head = NULL;
+  struct GNUNET_CHAT_DiscourseWrite *completed_tail = NULL;
 
-  do
+  struct GNUNET_CHAT_DiscourseWrite *write;
+  unsigned int sent = 0;
+
+  while ((discourse->writes_head) && (sent < discourse->write_window))
   {
-    len = read(discourse->pipe[0], data, MAX_WRITE_SIZE);
+    write = discourse->writes_head;
 
-    if (len <= 0)
-      break;
+    if ((write->remaining > 0) && (discourse->context->room))
+    {
+      prepare_discourse_talk(discourse, write, &(msg.body.talk));
 
-    msg.body.talk.data = data;
-    msg.body.talk.length = (uint16_t) len;
+      GNUNET_MESSENGER_send_message(discourse->context->room, &msg, NULL);
+      sent++;
+    }
 
-    GNUNET_MESSENGER_send_message(discourse->context->room, &msg, NULL);
+    if ((write->remaining > 0) && (discourse->context->room))
+      continue;
+
+    GNUNET_CONTAINER_DLL_remove(
+      discourse->writes_head,
+      discourse->writes_tail,
+      write
+    );
+
+    GNUNET_CONTAINER_DLL_insert_tail(
+      completed_head,
+      completed_tail,
+      write
+    );
   }
-  while (MAX_WRITE_SIZE == len);
 
-  if (len < 0)
-    return;
+  // Yield to other tasks, like the transmission of queued
+  // messages, before sending the next window of chunks.
+  if ((discourse->writes_head) && (!(discourse->write_task)))
+    discourse->write_task = GNUNET_SCHEDULER_add_with_priority(
+      GNUNET_SCHEDULER_PRIORITY_IDLE,
+      cb_write_discourse_queue,
+      discourse
+    );
 
-  discourse->pipe_task = GNUNET_SCHEDULER_add_now(
-    cb_reinit_discourse_pipe, discourse
-  );
+  complete_discourse_writes(discourse, completed_head, completed_tail);
 }
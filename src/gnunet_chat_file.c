@@ -27,6 +27,8 @@
 #include "gnunet_chat_context.h"
 #include "gnunet_chat_handle.h"
 
+#include "internal/gnunet_chat_block_reader.h"
+
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_fs_service.h>
 #include <string.h>
@@ -52,6 +54,8 @@ file_initialize (struct GNUNET_CHAT_File *file)
   file->status = 0;
   file->preview = NULL;
 
+  file->reader = NULL;
+
   file->user_pointer = NULL;
 }
 
@@ -195,6 +199,8 @@ skip_filename:
   GNUNET_free(file->preview);
 
 skip_preview:
+  file_close_reader(file);
+
   if (file->publish)
     GNUNET_FS_publish_stop(file->publish);
 
@@ -258,6 +264,49 @@ skip_preview:
   GNUNET_free(file);
 }
 
+ssize_t
+file_read_range (struct GNUNET_CHAT_File *file,
+                 uint64_t offset,
+                 void *buffer,
+                 size_t size)
+{
+  GNUNET_assert((file) && (buffer));
+
+  if (file->reader)
+    goto read_range;
+
+  char *filename = handle_create_file_path(
+    file->handle, &(file->hash)
+  );
+
+  if (!filename)
+    return GNUNET_SYSERR;
+
+  file->reader = internal_block_reader_create(
+    filename, &(file->hash), file->key
+  );
+
+  GNUNET_free(filename);
+
+  if (!(file->reader))
+    return GNUNET_SYSERR;
+
+read_range:
+  return internal_block_reader_read(file->reader, offset, buffer, size);
+}
+
+void
+file_close_reader (struct GNUNET_CHAT_File *file)
+{
+  GNUNET_assert(file);
+
+  if (!(file->reader))
+    return;
+
+  internal_block_reader_destroy(file->reader);
+  file->reader = NULL;
+}
+
 void
 file_bind_upload (struct GNUNET_CHAT_File *file,
                   struct GNUNET_CHAT_Context *context,
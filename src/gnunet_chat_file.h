@@ -63,6 +63,7 @@ struct GNUNET_CHAT_FileUnindex
 };
 
 struct GNUNET_CHAT_Handle;
+struct GNUNET_CHAT_InternalBlockReader;
 
 #define GNUNET_CHAT_FILE_STATUS_DOWNLOAD 0x1
 #define GNUNET_CHAT_FILE_STATUS_PUBLISH  0x2
@@ -96,6 +97,8 @@ struct GNUNET_CHAT_File
   int status;
   char *preview;
 
+  struct GNUNET_CHAT_InternalBlockReader *reader;
+
   void *user_pointer;
 };
 
@@ -149,6 +152,33 @@ file_create_from_disk (struct GNUNET_CHAT_Handle *handle,
 void
 file_destroy (struct GNUNET_CHAT_File *file);
 
+/**
+ * Reads up to <i>size</i> bytes of the decrypted content of a
+ * given chat <i>file</i> handle starting at a specific
+ * <i>offset</i> into a <i>buffer</i> without decrypting the
+ * whole file on disk.
+ *
+ * @param[in,out] file Chat file handle
+ * @param[in] offset Offset in the file
+ * @param[out] buffer Buffer
+ * @param[in] size Size of buffer
+ * @return Amount of bytes read or #GNUNET_SYSERR on failure
+ */
+ssize_t
+file_read_range (struct GNUNET_CHAT_File *file,
+                 uint64_t offset,
+                 void *buffer,
+                 size_t size);
+
+/**
+ * Closes the reader of a given chat <i>file</i> handle
+ * used to access its content in ranges if there is any.
+ *
+ * @param[in,out] file Chat file handle
+ */
+void
+file_close_reader (struct GNUNET_CHAT_File *file);
+
 /**
  * Binds a chat <i>context</i>, a callback and a closure
  * to a given chat <i>file</i> handle to be called on any
@@ -33,9 +33,19 @@
 #include <gnunet/gnunet_reclaim_service.h>
 #include <gnunet/gnunet_scheduler_lib.h>
 #include <gnunet/gnunet_util_lib.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 static const unsigned int initial_map_size_of_handle = 8;
+static const unsigned int maximum_map_size_of_handle = 65536;
+static const unsigned int slab_length_of_handle_pools = 256;
+static const unsigned int default_dependency_limit_of_handle = 64;
+static const unsigned int default_dependency_timeout_of_handle = 300;
+static const unsigned int default_monitor_batch_of_handle = 64;
+static const unsigned int write_delay_of_handle = 250;
+static const unsigned int concurrent_account_operations_of_handle = 8;
 static const unsigned int minimum_amount_of_other_members_in_group = 2;
+static const unsigned int timer_resolution_of_handle = 100;
 
 struct GNUNET_CHAT_Handle*
 handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
@@ -91,15 +101,42 @@ handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
   handle->msg_cb = msg_cb;
   handle->msg_cls = msg_cls;
 
+  handle->batch_cb = NULL;
+  handle->batch_cls = NULL;
+  handle->batch_size = 0;
+  handle->batch_delay = GNUNET_TIME_relative_get_zero_();
+
+  handle->dependency_limit = default_dependency_limit_of_handle;
+  handle->dependency_timeout = GNUNET_TIME_relative_multiply(
+    GNUNET_TIME_UNIT_SECONDS, default_dependency_timeout_of_handle
+  );
+
+  handle->message_cache = GNUNET_NO;
+
   handle->accounts_head = NULL;
   handle->accounts_tail = NULL;
 
+  handle->accounts_names = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_handle, GNUNET_NO);
+  handle->accounts_egos = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_handle, GNUNET_NO);
+
+  handle->accounts_pending_head = NULL;
+  handle->accounts_pending_tail = NULL;
+  handle->accounts_running = 0;
+
   handle->refreshing = GNUNET_NO;
   handle->own_contact = NULL;
 
   handle->next = NULL;
   handle->current = NULL;
   handle->monitor = NULL;
+  handle->monitor_batch = default_monitor_batch_of_handle;
+  handle->monitor_limit = 0;
+  handle->restored = NULL;
+
+  handle->namestore_round_trips = 0;
+  handle->namestore_records = 0;
 
   handle->lobbies_head = NULL;
   handle->lobbies_tail = NULL;
@@ -113,6 +150,13 @@ handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
   handle->tickets_head = NULL;
   handle->tickets_tail = NULL;
 
+  if (handle->directory)
+    handle->store = internal_store_create(handle->directory);
+  else
+    handle->store = NULL;
+
+  handle->collection = NULL;
+
   handle->files = GNUNET_CONTAINER_multihashmap_create(
     initial_map_size_of_handle, GNUNET_NO);
   
@@ -121,6 +165,23 @@ handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
   handle->groups = NULL;
   handle->invitations = NULL;
 
+  handle->message_pool = internal_pool_create(
+    sizeof(struct GNUNET_CHAT_Message), slab_length_of_handle_pools);
+  handle->internal_pool = internal_pool_create(
+    sizeof(struct GNUNET_CHAT_InternalMessages), slab_length_of_handle_pools);
+  handle->timestamp_pool = internal_pool_create(
+    sizeof(struct GNUNET_TIME_Absolute), slab_length_of_handle_pools);
+
+  handle->poller = internal_poller_create();
+  handle->timers = internal_timers_create(
+    GNUNET_TIME_relative_multiply(
+      GNUNET_TIME_UNIT_MILLISECONDS, timer_resolution_of_handle
+    )
+  );
+
+  handle->tag_index = internal_tag_index_create();
+  handle->startup = internal_startup_create();
+
   handle->arm = GNUNET_ARM_connect(
     handle->cfg,
     on_handle_arm_connection, 
@@ -130,6 +191,8 @@ handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
   if (handle->arm)
     on_handle_arm_connection(handle, GNUNET_NO);
 
+  internal_startup_begin(handle->startup, GNUNET_CHAT_STARTUP_PHASE_IDENTITY);
+
   handle->identity = GNUNET_IDENTITY_connect(
     handle->cfg,
     on_handle_gnunet_identity,
@@ -154,6 +217,12 @@ handle_create_from_config (const struct GNUNET_CONFIGURATION_Handle* cfg,
     handle->cfg
   );
 
+  handle->writes = internal_writes_create(
+    handle->namestore, on_handle_writes_error, handle
+  );
+
+  handle->writing = NULL;
+
   handle->public_key = NULL;
   handle->user_pointer = NULL;
   return handle;
@@ -212,10 +281,22 @@ handle_destroy (struct GNUNET_CHAT_Handle *handle)
   if (handle->reclaim)
     GNUNET_RECLAIM_disconnect(handle->reclaim);
 
+  if (handle->writing)
+    GNUNET_SCHEDULER_cancel(handle->writing);
+
+  internal_writes_destroy(handle->writes);
+
   if (handle->namestore)
     GNUNET_NAMESTORE_disconnect(handle->namestore);
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
+  while (handle->accounts_pending_head)
+  {
+    accounts = handle->accounts_pending_head;
+
+    internal_accounts_stop_method(accounts);
+  }
+
   while (handle->accounts_head)
   {
     accounts = handle->accounts_head;
@@ -228,6 +309,9 @@ handle_destroy (struct GNUNET_CHAT_Handle *handle)
     internal_accounts_destroy(accounts);
   }
 
+  GNUNET_CONTAINER_multihashmap_destroy(handle->accounts_names);
+  GNUNET_CONTAINER_multihashmap_destroy(handle->accounts_egos);
+
   if (handle->fs)
     GNUNET_FS_stop(handle->fs);
 
@@ -256,6 +340,12 @@ handle_destroy (struct GNUNET_CHAT_Handle *handle)
 
   GNUNET_CONTAINER_multihashmap_destroy(handle->files);
 
+  if (handle->collection)
+    GNUNET_SCHEDULER_cancel(handle->collection);
+
+  if (handle->store)
+    internal_store_destroy(handle->store);
+
   if (handle->directory)
     GNUNET_free(handle->directory);
 
@@ -276,9 +366,18 @@ handle_destroy (struct GNUNET_CHAT_Handle *handle)
       internal
     );
 
-    GNUNET_free(internal);
+    internal_pool_free(handle->internal_pool, internal);
   }
 
+  internal_pool_destroy(handle->message_pool);
+  internal_pool_destroy(handle->internal_pool);
+  internal_pool_destroy(handle->timestamp_pool);
+
+  internal_poller_destroy(handle->poller);
+  internal_timers_destroy(handle->timers);
+  internal_tag_index_destroy(handle->tag_index);
+  internal_startup_destroy(handle->startup);
+
   GNUNET_free(handle);
 }
 
@@ -310,25 +409,151 @@ handle_update_identity(struct GNUNET_CHAT_Handle *handle)
     NULL,
     GNUNET_NO
   );
+}
+
+struct GNUNET_CHAT_HandleStats
+{
+  uint32_t contexts;
+  uint32_t contacts;
+  uint32_t groups;
+  uint32_t invitations;
+};
+
+static enum GNUNET_GenericReturnValue
+get_handle_stats_key (const struct GNUNET_CHAT_Handle *handle,
+                      const struct GNUNET_CHAT_Account *account,
+                      struct GNUNET_HashCode *key)
+{
+  GNUNET_assert((handle) && (account) && (key));
+
+  const char *name = account_get_name(account);
 
-  const struct GNUNET_CRYPTO_BlindablePrivateKey *zone = handle_get_key(handle);
+  if ((!(handle->directory)) || (!name))
+    return GNUNET_NO;
 
-  if ((!zone) || (handle->monitor))
+  GNUNET_CRYPTO_hash(name, strlen(name), key);
+  return GNUNET_YES;
+}
+
+static unsigned int
+get_handle_map_size (uint32_t expected)
+{
+  expected = ntohl(expected);
+
+  if (expected > maximum_map_size_of_handle)
+    expected = maximum_map_size_of_handle;
+
+  return expected > initial_map_size_of_handle?
+    expected : initial_map_size_of_handle;
+}
+
+static void
+load_handle_stats (const struct GNUNET_CHAT_Handle *handle,
+                   const struct GNUNET_CHAT_Account *account,
+                   struct GNUNET_CHAT_HandleStats *stats)
+{
+  GNUNET_assert((handle) && (account) && (stats));
+
+  struct GNUNET_HashCode key;
+
+  if ((GNUNET_YES != get_handle_stats_key(handle, account, &key)) ||
+      (GNUNET_OK != util_load_stats(handle->directory, "stats/handles",
+                                    &key, stats, sizeof(*stats))))
+    memset(stats, 0, sizeof(*stats));
+}
+
+static void
+store_handle_stats (const struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert((handle) && (handle->current));
+
+  struct GNUNET_HashCode key;
+  if (GNUNET_YES != get_handle_stats_key(handle, handle->current, &key))
     return;
 
-  handle->monitor = GNUNET_NAMESTORE_zone_monitor_start(
-    handle->cfg,
-    zone,
-    GNUNET_YES,
-    NULL,
-    NULL,
-    on_monitor_namestore_record,
-    handle,
-    NULL,
-    NULL
+  struct GNUNET_CHAT_HandleStats stats;
+  stats.contexts = htonl(
+    GNUNET_CONTAINER_multihashmap_size(handle->contexts));
+  stats.contacts = htonl(
+    GNUNET_CONTAINER_multishortmap_size(handle->contacts));
+  stats.groups = htonl(
+    GNUNET_CONTAINER_multihashmap_size(handle->groups));
+  stats.invitations = htonl(
+    GNUNET_CONTAINER_multihashmap_size(handle->invitations));
+
+  util_store_stats(
+    handle->directory, "stats/handles", &key, &stats, sizeof(stats)
   );
 }
 
+static enum GNUNET_GenericReturnValue
+get_handle_snapshot_filename (const struct GNUNET_CHAT_Handle *handle,
+                              const struct GNUNET_CHAT_Account *account,
+                              char **filename)
+{
+  GNUNET_assert((handle) && (account) && (filename));
+
+  struct GNUNET_HashCode key;
+  if (GNUNET_YES != get_handle_stats_key(handle, account, &key))
+    return GNUNET_NO;
+
+  util_get_filename(handle->directory, "snapshots", &key, filename);
+  return GNUNET_YES;
+}
+
+static void
+restore_handle_snapshot (struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert(
+    (handle) &&
+    (handle->current) &&
+    (handle->contexts) &&
+    (!(handle->restored))
+  );
+
+  // Restored contexts get only reconciled once the zone monitor
+  // processed all stored records, so it needs to be running.
+  if ((!(handle->messenger)) || (!(handle->monitor)))
+    return;
+
+  char *filename;
+  if (GNUNET_YES != get_handle_snapshot_filename(
+      handle, handle->current, &filename))
+    return;
+
+  struct GNUNET_CHAT_InternalSnapshot *snapshot;
+  snapshot = internal_snapshot_create(filename);
+  GNUNET_free(filename);
+
+  handle->restored = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_handle, GNUNET_NO);
+
+  internal_snapshot_iterate(snapshot, it_restore_handle_snapshot, handle);
+  internal_snapshot_destroy(snapshot);
+}
+
+static void
+store_handle_snapshot (const struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert((handle) && (handle->current) && (handle->contexts));
+
+  char *filename;
+  if (GNUNET_YES != get_handle_snapshot_filename(
+      handle, handle->current, &filename))
+    return;
+
+  struct GNUNET_CHAT_InternalSnapshot *snapshot;
+  snapshot = internal_snapshot_create(filename);
+  GNUNET_free(filename);
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    handle->contexts, it_store_handle_snapshot, snapshot
+  );
+
+  internal_snapshot_store(snapshot);
+  internal_snapshot_destroy(snapshot);
+}
+
 void
 handle_connect (struct GNUNET_CHAT_Handle *handle,
 		            struct GNUNET_CHAT_Account *account)
@@ -349,20 +574,63 @@ handle_connect (struct GNUNET_CHAT_Handle *handle,
     handle->monitor = NULL;
   }
 
+  struct GNUNET_CHAT_HandleStats stats;
+  load_handle_stats(handle, account, &stats);
+
   handle->contexts = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size_of_handle, GNUNET_NO);
+    get_handle_map_size(stats.contexts), GNUNET_NO);
   handle->contacts = GNUNET_CONTAINER_multishortmap_create(
-    initial_map_size_of_handle, GNUNET_NO);
+    get_handle_map_size(stats.contacts), GNUNET_NO);
   handle->groups = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size_of_handle, GNUNET_NO);
+    get_handle_map_size(stats.groups), GNUNET_NO);
   handle->invitations = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size_of_handle, GNUNET_NO);
-
-  handle->gns = GNUNET_GNS_connect(handle->cfg);
+    get_handle_map_size(stats.invitations), GNUNET_NO);
 
   const struct GNUNET_CRYPTO_BlindablePrivateKey *key;
   key = account_get_key(account);
 
+  internal_startup_begin(handle->startup, GNUNET_CHAT_STARTUP_PHASE_ZONE);
+  internal_startup_begin(handle->startup, GNUNET_CHAT_STARTUP_PHASE_MESSENGER);
+
+  handle->namestore_round_trips = 0;
+  handle->namestore_records = 0;
+
+  // The zone monitor only delivers records asynchronously, so the
+  // messenger below is connected before processing the first record.
+  if (key)
+    handle->monitor = GNUNET_NAMESTORE_zone_monitor_start(
+      handle->cfg,
+      key,
+      GNUNET_YES,
+      on_monitor_namestore_error,
+      handle,
+      on_monitor_namestore_record,
+      handle,
+      on_monitor_namestore_sync,
+      handle
+    );
+
+  if (handle->monitor)
+  {
+    handle->namestore_round_trips++;
+    handle->monitor_limit = 1;
+
+    // The monitor only grants a single record initially, so the
+    // rest of the first batch gets requested right away.
+    if (handle->monitor_batch > 1)
+    {
+      GNUNET_NAMESTORE_zone_monitor_next(
+        handle->monitor, handle->monitor_batch - 1
+      );
+
+      handle->monitor_limit = handle->monitor_batch;
+    }
+  }
+  else
+    internal_startup_end(handle->startup, GNUNET_CHAT_STARTUP_PHASE_ZONE);
+
+  handle->gns = GNUNET_GNS_connect(handle->cfg);
+
   const char *name = account_get_name(account);
 
   handle->messenger = GNUNET_MESSENGER_connect(
@@ -374,6 +642,8 @@ handle_connect (struct GNUNET_CHAT_Handle *handle,
   handle->next = NULL;
   handle->current = account;
   handle_update_identity(handle);
+
+  restore_handle_snapshot(handle);
 }
 
 void
@@ -388,6 +658,12 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
 		(handle->files)
   );
 
+  // Pending batches need to be delivered while all contacts and
+  // files they refer to are still valid, before the logout.
+  GNUNET_CONTAINER_multihashmap_iterate(
+    handle->contexts, it_flush_handle_contexts, NULL
+  );
+
   handle_send_internal_message(
     handle,
     handle->current,
@@ -397,6 +673,16 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
     GNUNET_YES
   );
 
+  store_handle_stats(handle);
+  store_handle_snapshot(handle);
+  handle_flush_records(handle);
+
+  if (handle->restored)
+  {
+    GNUNET_CONTAINER_multihashmap_destroy(handle->restored);
+    handle->restored = NULL;
+  }
+
   handle->own_contact = NULL;
 
   while (handle->attributes_head)
@@ -413,6 +699,11 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
     handle->contacts, it_destroy_handle_contacts, NULL
   );
 
+  // Contexts untrack their tags from all contacts on destruction,
+  // so destroyed contacts must not be found anymore at that point.
+  GNUNET_CONTAINER_multishortmap_destroy(handle->contacts);
+  handle->contacts = NULL;
+
   GNUNET_CONTAINER_multihashmap_iterate(
     handle->contexts, it_destroy_handle_contexts, NULL
   );
@@ -437,7 +728,7 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
       internal
     );
 
-    GNUNET_free(internal);
+    internal_pool_free(handle->internal_pool, internal);
   }
 
   if (handle->messenger)
@@ -494,7 +785,6 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
 
   GNUNET_CONTAINER_multihashmap_destroy(handle->invitations);
   GNUNET_CONTAINER_multihashmap_destroy(handle->groups);
-  GNUNET_CONTAINER_multishortmap_destroy(handle->contacts);
   GNUNET_CONTAINER_multihashmap_destroy(handle->contexts);
   GNUNET_CONTAINER_multihashmap_clear(handle->files);
 
@@ -512,50 +802,135 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle)
   handle_update_key(handle);
 }
 
-static struct GNUNET_CHAT_InternalAccounts*
-find_accounts_by_name (const struct GNUNET_CHAT_Handle *handle,
-		                   const char *name,
-                       enum GNUNET_GenericReturnValue skip_op)
+struct GNUNET_CHAT_Account*
+handle_get_account_by_name (const struct GNUNET_CHAT_Handle *handle,
+		                        const char *name,
+                            enum GNUNET_GenericReturnValue skip_op)
 {
   GNUNET_assert((handle) && (name));
 
-  struct GNUNET_CHAT_InternalAccounts *accounts = handle->accounts_head;
-  const char *account_name;
+  struct GNUNET_CHAT_InternalAccounts *accounts;
+  accounts = internal_accounts_find_by_name(handle, name, skip_op);
 
-  while (accounts)
-  {
-    if ((!(accounts->account)) || ((GNUNET_YES == skip_op) &&
-        (accounts->op)))
-      goto skip_account;
+  if (!accounts)
+    return NULL;
 
-    account_name = account_get_name(
-      accounts->account
-    );
+  return accounts->account;
+}
+
+static enum GNUNET_GenericReturnValue
+start_accounts_operation (struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert((accounts) && (accounts->handle));
 
-    if ((account_name) && (0 == strcmp(account_name, name)))
+  struct GNUNET_CHAT_Handle *handle = accounts->handle;
+  const char *name = NULL;
+
+  if (accounts->account)
+    name = account_get_name(accounts->account);
+
+  switch (accounts->method)
+  {
+    case GNUNET_CHAT_ACCOUNT_CREATION:
+      accounts->op = GNUNET_IDENTITY_create(
+        handle->identity,
+        accounts->identifier,
+        NULL,
+        GNUNET_PUBLIC_KEY_TYPE_ECDSA,
+        cb_account_creation,
+        accounts
+      );
+      break;
+    case GNUNET_CHAT_ACCOUNT_DELETION:
+      if (accounts->account)
+        accounts->op = GNUNET_IDENTITY_delete(
+          handle->identity,
+          name,
+          cb_account_deletion,
+          accounts
+        );
+      else if (accounts->identifier)
+        accounts->op = GNUNET_IDENTITY_delete(
+          handle->identity,
+          accounts->identifier,
+          cb_lobby_deletion,
+          accounts
+        );
       break;
+    case GNUNET_CHAT_ACCOUNT_RENAMING:
+      if ((name) && (accounts->identifier))
+        accounts->op = GNUNET_IDENTITY_rename(
+          handle->identity,
+          name,
+          accounts->identifier,
+          cb_account_rename,
+          accounts
+        );
+      break;
+    case GNUNET_CHAT_ACCOUNT_UPDATING:
+      if (name)
+        accounts->op = GNUNET_IDENTITY_delete(
+          handle->identity,
+          name,
+          cb_account_update,
+          accounts
+        );
+      break;
+    default:
+      break;
+  }
 
-  skip_account:
-    accounts = accounts->next;
+  if (!(accounts->op))
+  {
+    internal_accounts_stop_method(accounts);
+    return GNUNET_SYSERR;
   }
 
-  return accounts;
+  accounts->running = GNUNET_YES;
+  handle->accounts_running++;
+  return GNUNET_OK;
 }
 
-struct GNUNET_CHAT_Account*
-handle_get_account_by_name (const struct GNUNET_CHAT_Handle *handle,
-		                        const char *name,
-                            enum GNUNET_GenericReturnValue skip_op)
+static enum GNUNET_GenericReturnValue
+queue_accounts_operation (struct GNUNET_CHAT_InternalAccounts *accounts)
 {
-  GNUNET_assert((handle) && (name));
+  GNUNET_assert((accounts) && (accounts->handle));
+
+  struct GNUNET_CHAT_Handle *handle = accounts->handle;
+
+  if ((!(handle->accounts_pending_head)) &&
+      (handle->accounts_running < concurrent_account_operations_of_handle))
+    return start_accounts_operation(accounts);
+
+  internal_accounts_enqueue(accounts);
+  return GNUNET_OK;
+}
+
+void
+handle_process_accounts (struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert(handle);
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
-  accounts = find_accounts_by_name(handle, name, skip_op);
+  while ((handle->accounts_pending_head) &&
+         (handle->accounts_running < concurrent_account_operations_of_handle))
+  {
+    accounts = handle->accounts_pending_head;
 
-  if (!accounts)
-    return NULL;
+    internal_accounts_dequeue(accounts);
 
-  return accounts->account;
+    if (GNUNET_OK == start_accounts_operation(accounts))
+      continue;
+
+    handle_send_internal_message(
+      handle,
+      accounts->account,
+      NULL,
+      GNUNET_CHAT_FLAG_WARNING,
+      GNUNET_ErrorCode_get_hint(GNUNET_EC_SERVICE_COMMUNICATION_FAILED),
+      GNUNET_YES
+    );
+  }
 }
 
 static enum GNUNET_GenericReturnValue
@@ -592,7 +967,7 @@ handle_create_account (struct GNUNET_CHAT_Handle *handle,
   GNUNET_assert((handle) && (name));
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
-  accounts = find_accounts_by_name(handle, name, GNUNET_NO);
+  accounts = internal_accounts_find_by_name(handle, name, GNUNET_NO);
 
   if (accounts)
     return GNUNET_SYSERR;
@@ -608,19 +983,7 @@ handle_create_account (struct GNUNET_CHAT_Handle *handle,
   if (GNUNET_OK != result)
     return result;
 
-  accounts->op = GNUNET_IDENTITY_create(
-    handle->identity,
-    name,
-    NULL,
-    GNUNET_PUBLIC_KEY_TYPE_ECDSA,
-    cb_account_creation,
-    accounts
-  );
-
-  if (!accounts->op)
-    return GNUNET_SYSERR;
-
-  return result;
+  return queue_accounts_operation(accounts);
 }
 
 enum GNUNET_GenericReturnValue
@@ -630,13 +993,7 @@ handle_delete_account (struct GNUNET_CHAT_Handle *handle,
   GNUNET_assert((handle) && (account));
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
-  accounts = handle->accounts_head;
-
-  while (accounts)
-    if (account == accounts->account)
-      break;
-    else
-      accounts = accounts->next;
+  accounts = internal_accounts_find_by_account(handle, account);
 
   if (!accounts)
     return GNUNET_SYSERR;
@@ -652,19 +1009,7 @@ handle_delete_account (struct GNUNET_CHAT_Handle *handle,
   if (GNUNET_OK != result)
     return result;
 
-  const char *name = account_get_name(account);
-
-  accounts->op = GNUNET_IDENTITY_delete(
-    handle->identity,
-    name,
-    cb_account_deletion,
-    accounts
-  );
-
-  if (!accounts->op)
-    return GNUNET_SYSERR;
-
-  return result;
+  return queue_accounts_operation(accounts);
 }
 
 enum GNUNET_GenericReturnValue
@@ -675,18 +1020,12 @@ handle_rename_account (struct GNUNET_CHAT_Handle *handle,
   GNUNET_assert((handle) && (account) && (new_name));
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
-  accounts = handle->accounts_head;
-
-  while (accounts)
-    if (account == accounts->account)
-      break;
-    else
-      accounts = accounts->next;
+  accounts = internal_accounts_find_by_account(handle, account);
 
   if (!accounts)
     return GNUNET_SYSERR;
 
-  if (find_accounts_by_name(handle, new_name, GNUNET_NO))
+  if (internal_accounts_find_by_name(handle, new_name, GNUNET_NO))
     return GNUNET_SYSERR;
 
   const char *old_name = account_get_name(account);
@@ -698,25 +1037,14 @@ handle_rename_account (struct GNUNET_CHAT_Handle *handle,
   result = update_accounts_operation(
     &accounts, 
     handle, 
-    NULL, 
+    new_name, 
     GNUNET_CHAT_ACCOUNT_RENAMING
   );
 
   if (GNUNET_OK != result)
     return result;
 
-  accounts->op = GNUNET_IDENTITY_rename(
-    handle->identity,
-    old_name,
-    new_name,
-    cb_account_rename,
-    accounts
-  );
-
-  if (!accounts->op)
-    return GNUNET_SYSERR;
-
-  return result;
+  return queue_accounts_operation(accounts);
 }
 
 enum GNUNET_GenericReturnValue
@@ -735,34 +1063,24 @@ handle_delete_lobby (struct GNUNET_CHAT_Handle *handle,
   if (!key)
     return GNUNET_SYSERR;
 
+  char *name;
+  util_lobby_name(key, &name);
+
   struct GNUNET_CHAT_InternalAccounts *accounts = NULL;
   enum GNUNET_GenericReturnValue result;
   result = update_accounts_operation(
     &accounts, 
     handle, 
-    NULL, 
+    name, 
     GNUNET_CHAT_ACCOUNT_DELETION
   );
 
-  if (GNUNET_OK != result)
-    return result;
-
-  char *name;
-  util_lobby_name(key, &name);
-
-  accounts->op = GNUNET_IDENTITY_delete(
-    handle->identity,
-    name,
-    cb_lobby_deletion,
-    accounts
-  );
-
   GNUNET_free(name);
 
-  if (!accounts->op)
-    return GNUNET_SYSERR;
+  if (GNUNET_OK != result)
+    return result;
 
-  return result;
+  return queue_accounts_operation(accounts);
 }
 
 const char*
@@ -792,19 +1110,96 @@ handle_create_file_path (const struct GNUNET_CHAT_Handle *handle,
   return filename;
 }
 
+enum GNUNET_GenericReturnValue
+handle_get_account_key (const struct GNUNET_CHAT_Handle *handle,
+                        const struct GNUNET_HashCode *hash,
+                        struct GNUNET_HashCode *key)
+{
+  GNUNET_assert((handle) && (hash) && (key));
+
+  struct GNUNET_HashCode keys [2];
+
+  if ((!(handle->current)) ||
+      (GNUNET_YES != get_handle_stats_key(handle, handle->current, keys)))
+    return GNUNET_NO;
+
+  GNUNET_memcpy(keys + 1, hash, sizeof(*hash));
+  GNUNET_CRYPTO_hash(keys, sizeof(keys), key);
+  return GNUNET_YES;
+}
+
+char*
+handle_create_temporary_file_path (const struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert(handle);
+
+  const char *directory = handle_get_directory(handle);
+
+  if (!directory)
+    return NULL;
+
+  char *dirname;
+  util_get_dirname(directory, "files", &dirname);
+
+  if (GNUNET_OK != GNUNET_DISK_directory_create(dirname))
+  {
+    GNUNET_free(dirname);
+    return NULL;
+  }
+
+  char *filename;
+  GNUNET_asprintf(&filename, "%s/.upload.XXXXXX", dirname);
+  GNUNET_free(dirname);
+
+  const int fd = mkstemp(filename);
+
+  if (fd < 0)
+  {
+    GNUNET_free(filename);
+    return NULL;
+  }
+
+  close(fd);
+  return filename;
+}
+
+void
+handle_update_files (struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert(handle);
+
+  if ((!(handle->store)) || (handle->collection) || (handle->destruction) ||
+      (GNUNET_YES != internal_store_is_exceeded(handle->store)))
+    return;
+
+  handle->collection = GNUNET_SCHEDULER_add_with_priority(
+    GNUNET_SCHEDULER_PRIORITY_BACKGROUND,
+    on_handle_collection,
+    handle
+  );
+}
+
+int
+handle_collect_files (struct GNUNET_CHAT_Handle *handle,
+                      enum GNUNET_GenericReturnValue all)
+{
+  GNUNET_assert(handle);
+
+  if (!(handle->store))
+    return 0;
+
+  return internal_store_collect(
+    handle->store, all, it_handle_collect_file, handle
+  );
+}
+
 enum GNUNET_GenericReturnValue
 handle_update (struct GNUNET_CHAT_Handle *handle)
 {
   GNUNET_assert((handle) && (handle->current));
 
   struct GNUNET_CHAT_InternalAccounts *accounts;
-  accounts = handle->accounts_head;
-
-  while (accounts)
-    if (handle->current == accounts->account)
-      break;
-    else
-      accounts = accounts->next;
+  accounts = internal_accounts_find_by_account(handle, handle->current);
 
   if (!accounts)
     return GNUNET_SYSERR;
@@ -822,17 +1217,7 @@ handle_update (struct GNUNET_CHAT_Handle *handle)
   if (GNUNET_OK != result)
     return result;
 
-  accounts->op = GNUNET_IDENTITY_delete(
-    handle->identity,
-    name,
-    cb_account_update,
-    accounts
-  );
-
-  if (!accounts->op)
-    return GNUNET_SYSERR;
-
-  return result;
+  return queue_accounts_operation(accounts);
 }
 
 const struct GNUNET_CRYPTO_BlindablePrivateKey*
@@ -859,18 +1244,18 @@ handle_send_internal_message (struct GNUNET_CHAT_Handle *handle,
   if ((handle->destruction) || (!(handle->msg_cb)))
     return;
 
-  struct GNUNET_CHAT_InternalMessages *internal = GNUNET_new(
-    struct GNUNET_CHAT_InternalMessages
+  struct GNUNET_CHAT_InternalMessages *internal = internal_pool_alloc(
+    handle->internal_pool
   );
 
   internal->chat = handle;
   internal->msg = message_create_internally(
-    account, context, flag, warning
+    handle, account, context, flag, warning
   );
 
   if (!(internal->msg))
   {
-    GNUNET_free(internal);
+    internal_pool_free(handle->internal_pool, internal);
     return;
   }
 
@@ -900,6 +1285,48 @@ handle_send_internal_message (struct GNUNET_CHAT_Handle *handle,
     );
 }
 
+void
+handle_write_records (struct GNUNET_CHAT_Handle *handle,
+                      const char *label,
+                      unsigned int count,
+                      const struct GNUNET_GNSRECORD_Data *data)
+{
+  GNUNET_assert((handle) && (handle->writes) && (label));
+
+  const struct GNUNET_CRYPTO_BlindablePrivateKey *zone = handle_get_key(
+    handle
+  );
+
+  if ((!zone) || (GNUNET_SYSERR == internal_writes_add(
+      handle->writes, zone, label, count, data)))
+    return;
+
+  if (handle->writing)
+    return;
+
+  handle->writing = GNUNET_SCHEDULER_add_delayed(
+    GNUNET_TIME_relative_multiply(
+      GNUNET_TIME_UNIT_MILLISECONDS, write_delay_of_handle
+    ),
+    on_handle_write_records,
+    handle
+  );
+}
+
+void
+handle_flush_records (struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_assert((handle) && (handle->writes));
+
+  if (handle->writing)
+  {
+    GNUNET_SCHEDULER_cancel(handle->writing);
+    handle->writing = NULL;
+  }
+
+  handle->namestore_round_trips += internal_writes_flush(handle->writes);
+}
+
 void
 handle_send_room_name (struct GNUNET_CHAT_Handle *handle,
 		                   struct GNUNET_MESSENGER_Room *room)
@@ -925,6 +1352,23 @@ handle_send_room_name (struct GNUNET_CHAT_Handle *handle,
   GNUNET_free(msg.body.name.name);
 }
 
+void
+handle_process_message (struct GNUNET_CHAT_Handle *handle,
+                        struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert(
+    (handle) &&
+    (message) &&
+    (message->context) &&
+    (message->context->handle == handle)
+  );
+
+  if (handle->destruction)
+    return;
+
+  on_handle_message_callback(message);
+}
+
 enum GNUNET_GenericReturnValue
 handle_request_context_by_room (struct GNUNET_CHAT_Handle *handle,
 				                        struct GNUNET_MESSENGER_Room *room)
@@ -1106,6 +1550,9 @@ handle_process_records (struct GNUNET_CHAT_Handle *handle,
   union GNUNET_MESSENGER_RoomKey key;
   GNUNET_memcpy (&(key.hash), &(record->key), sizeof(key));
 
+  if (handle->restored)
+    GNUNET_CONTAINER_multihashmap_remove_all(handle->restored, &(key.hash));
+
   struct GNUNET_CHAT_Context *context = GNUNET_CONTAINER_multihashmap_get(
     handle->contexts,
     &(key.hash)
@@ -1113,6 +1560,7 @@ handle_process_records (struct GNUNET_CHAT_Handle *handle,
 
   if ((context) && (context->room))
   {
+    GNUNET_memcpy(&(context->door), &(record->door), sizeof(context->door));
     context_read_records(context, label, count, data);
     return NULL;
   }
@@ -1128,11 +1576,13 @@ handle_process_records (struct GNUNET_CHAT_Handle *handle,
   else if (context)
   {
     context_update_room(context, room, GNUNET_NO);
+    GNUNET_memcpy(&(context->door), &(record->door), sizeof(context->door));
     context_read_records(context, label, count, data);
     return NULL;
   }
 
   context = context_create_from_room(handle, room);
+  GNUNET_memcpy(&(context->door), &(record->door), sizeof(context->door));
   context_read_records(context, label, count, data);
 
   if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
@@ -34,7 +34,15 @@
 
 #include "internal/gnunet_chat_accounts.h"
 #include "internal/gnunet_chat_attribute_process.h"
+#include "internal/gnunet_chat_poller.h"
+#include "internal/gnunet_chat_pool.h"
+#include "internal/gnunet_chat_snapshot.h"
+#include "internal/gnunet_chat_startup.h"
+#include "internal/gnunet_chat_store.h"
+#include "internal/gnunet_chat_tag_index.h"
 #include "internal/gnunet_chat_ticket_process.h"
+#include "internal/gnunet_chat_timers.h"
+#include "internal/gnunet_chat_writes.h"
 
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_arm_service.h>
@@ -104,15 +112,38 @@ struct GNUNET_CHAT_Handle
   GNUNET_CHAT_ContextMessageCallback msg_cb;
   void *msg_cls;
 
+  GNUNET_CHAT_ContextMessageBatchCallback batch_cb;
+  void *batch_cls;
+  unsigned int batch_size;
+  struct GNUNET_TIME_Relative batch_delay;
+
+  unsigned int dependency_limit;
+  struct GNUNET_TIME_Relative dependency_timeout;
+
+  enum GNUNET_GenericReturnValue message_cache;
+
   struct GNUNET_CHAT_InternalAccounts *accounts_head;
   struct GNUNET_CHAT_InternalAccounts *accounts_tail;
 
+  struct GNUNET_CONTAINER_MultiHashMap *accounts_names;
+  struct GNUNET_CONTAINER_MultiHashMap *accounts_egos;
+
+  struct GNUNET_CHAT_InternalAccounts *accounts_pending_head;
+  struct GNUNET_CHAT_InternalAccounts *accounts_pending_tail;
+  unsigned int accounts_running;
+
   enum GNUNET_GenericReturnValue refreshing;
   struct GNUNET_CHAT_Contact *own_contact;
 
   struct GNUNET_CHAT_Account *next;
   struct GNUNET_CHAT_Account *current;
   struct GNUNET_NAMESTORE_ZoneMonitor *monitor;
+  unsigned int monitor_batch;
+  unsigned int monitor_limit;
+  struct GNUNET_CONTAINER_MultiHashMap *restored;
+
+  unsigned long long namestore_round_trips;
+  unsigned long long namestore_records;
 
   struct GNUNET_CHAT_InternalLobbies *lobbies_head;
   struct GNUNET_CHAT_InternalLobbies *lobbies_tail;
@@ -126,12 +157,26 @@ struct GNUNET_CHAT_Handle
   struct GNUNET_CHAT_TicketProcess *tickets_head;
   struct GNUNET_CHAT_TicketProcess *tickets_tail;
 
+  struct GNUNET_CHAT_InternalStore *store;
+  struct GNUNET_SCHEDULER_Task *collection;
+
   struct GNUNET_CONTAINER_MultiHashMap *files;
   struct GNUNET_CONTAINER_MultiHashMap *contexts;
   struct GNUNET_CONTAINER_MultiShortmap *contacts;
   struct GNUNET_CONTAINER_MultiHashMap *groups;
   struct GNUNET_CONTAINER_MultiHashMap *invitations;
 
+  struct GNUNET_CHAT_InternalPool *message_pool;
+  struct GNUNET_CHAT_InternalPool *internal_pool;
+  struct GNUNET_CHAT_InternalPool *timestamp_pool;
+
+  struct GNUNET_CHAT_InternalPoller *poller;
+  struct GNUNET_CHAT_InternalTimers *timers;
+  struct GNUNET_CHAT_InternalTagIndex *tag_index;
+  struct GNUNET_CHAT_InternalStartup *startup;
+  struct GNUNET_CHAT_InternalWrites *writes;
+  struct GNUNET_SCHEDULER_Task *writing;
+
   struct GNUNET_ARM_Handle *arm;
   struct GNUNET_FS_Handle *fs;
   struct GNUNET_GNS_Handle *gns;
@@ -202,7 +247,7 @@ handle_disconnect (struct GNUNET_CHAT_Handle *handle);
  *
  * @param[in] handle Chat handle
  * @param[in] name Chat account name
- * @param[in] skip_op Whether to skip accounts with active operation
+ * @param[in] skip_op Whether to skip accounts with pending operation
  * @return Chat account
  */
 struct GNUNET_CHAT_Account*
@@ -210,6 +255,16 @@ handle_get_account_by_name (const struct GNUNET_CHAT_Handle *handle,
 		                        const char *name,
                             enum GNUNET_GenericReturnValue skip_op);
 
+/**
+ * Starts pending operations regarding chat accounts of
+ * a given chat <i>handle</i> as long as the amount of
+ * running operations stays below its limit.
+ *
+ * @param[in,out] handle Chat handle
+ */
+void
+handle_process_accounts (struct GNUNET_CHAT_Handle *handle);
+
 /**
  * Enqueues a creation for a chat account with a specific
  * <i>name</i> as identifier for a given chat <i>handle</i>.
@@ -283,6 +338,57 @@ char*
 handle_create_file_path (const struct GNUNET_CHAT_Handle *handle,
                          const struct GNUNET_HashCode *hash);
 
+/**
+ * Derives a <i>key</i> from a given <i>hash</i> which is unique
+ * to the current account of a chat <i>handle</i>, so data of
+ * different accounts can be stored separately in its directory.
+ *
+ * @param[in] handle Chat handle
+ * @param[in] hash Hash of the data
+ * @param[out] key Key of the data
+ * @return #GNUNET_YES if the key got derived, otherwise #GNUNET_NO
+ */
+enum GNUNET_GenericReturnValue
+handle_get_account_key (const struct GNUNET_CHAT_Handle *handle,
+                        const struct GNUNET_HashCode *hash,
+                        struct GNUNET_HashCode *key);
+
+/**
+ * Creates a new empty file next to the files stored by a
+ * chat <i>handle</i> which can be moved in place once its
+ * hash is known and returns an allocated string providing
+ * its full path.
+ *
+ * @param[in] handle Chat handle
+ * @return Temporary file path or NULL on failure
+ */
+char*
+handle_create_temporary_file_path (const struct GNUNET_CHAT_Handle *handle);
+
+/**
+ * Checks the usage of files stored by a chat <i>handle</i>
+ * against its quota and schedules the collection of files
+ * without references in case it got exceeded.
+ *
+ * @param[in,out] handle Chat handle
+ */
+void
+handle_update_files (struct GNUNET_CHAT_Handle *handle);
+
+/**
+ * Collects files stored by a chat <i>handle</i> which are not
+ * referenced anymore by unindexing and deleting them. If
+ * <i>all</i> is set to #GNUNET_NO, only as many files get
+ * collected as required to comply with the quota.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] all Flag to collect all files without references
+ * @return Amount of files getting collected
+ */
+int
+handle_collect_files (struct GNUNET_CHAT_Handle *handle,
+                      enum GNUNET_GenericReturnValue all);
+
 /**
  * Updates the used private key by creating a new identity
  * using the same identifier as currently in use, replacing
@@ -329,6 +435,32 @@ handle_send_internal_message (struct GNUNET_CHAT_Handle *handle,
                               const char *warning,
                               enum GNUNET_GenericReturnValue feedback);
 
+/**
+ * Queues a record set of <i>count</i> records from <i>data</i>
+ * under a given <i>label</i> in the zone of the current account
+ * of a chat <i>handle</i>. Record sets of the same label get
+ * coalesced until the queue gets flushed after a short delay.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in] label Record label
+ * @param[in] count Amount of records
+ * @param[in] data Records
+ */
+void
+handle_write_records (struct GNUNET_CHAT_Handle *handle,
+                      const char *label,
+                      unsigned int count,
+                      const struct GNUNET_GNSRECORD_Data *data);
+
+/**
+ * Stores all record sets queued by a given chat <i>handle</i>
+ * in the namestore right away.
+ *
+ * @param[in,out] handle Chat handle
+ */
+void
+handle_flush_records (struct GNUNET_CHAT_Handle *handle);
+
 /**
  * Sends a name message to a messenger <i>room</i> with
  * a selected chat <i>handle</i>.
@@ -340,6 +472,18 @@ void
 handle_send_room_name (struct GNUNET_CHAT_Handle *handle,
 		                   struct GNUNET_MESSENGER_Room *room);
 
+/**
+ * Processes a chat <i>message</i> received by a selected
+ * chat <i>handle</i> which does not wait for any other
+ * message to arrive anymore.
+ *
+ * @param[in,out] handle Chat handle
+ * @param[in,out] message Chat message
+ */
+void
+handle_process_message (struct GNUNET_CHAT_Handle *handle,
+                        struct GNUNET_CHAT_Message *message);
+
 /**
  * Checks a given chat <i>handle</i> for any chat context
  * connected with a messenger <i>room</i>, creates it if
@@ -35,7 +35,13 @@
 #include "gnunet_chat_util.h"
 
 #include "internal/gnunet_chat_accounts.h"
+#include "internal/gnunet_chat_backfill.h"
+#include "internal/gnunet_chat_dependencies.h"
+#include "internal/gnunet_chat_receipts.h"
+#include "internal/gnunet_chat_snapshot.h"
+#include "internal/gnunet_chat_store.h"
 #include "internal/gnunet_chat_tagging.h"
+#include "internal/gnunet_chat_timeline.h"
 
 #include <gnunet/gnunet_arm_service.h>
 #include <gnunet/gnunet_common.h>
@@ -92,6 +98,9 @@ on_handle_service_request(void *cls,
   );
 
   GNUNET_free(services);
+
+  if (!(chat->services_head))
+    internal_startup_end(chat->startup, GNUNET_CHAT_STARTUP_PHASE_SERVICES);
 }
 
 static void
@@ -132,6 +141,8 @@ on_handle_arm_connection(void *cls,
   GNUNET_assert((chat) && (chat->arm));
 
   if (GNUNET_YES == connected) {
+    internal_startup_begin(chat->startup, GNUNET_CHAT_STARTUP_PHASE_SERVICES);
+
     _request_service_via_arm(chat, gnunet_service_name_identity);
     _request_service_via_arm(chat, gnunet_service_name_messenger);
     _request_service_via_arm(chat, gnunet_service_name_fs);
@@ -143,6 +154,47 @@ on_handle_arm_connection(void *cls,
   }
 }
 
+static void
+remove_handle_file (struct GNUNET_CHAT_Handle *handle,
+                    const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((handle) && (hash));
+
+  char *filename = handle_create_file_path(
+    handle, hash
+  );
+
+  if (!filename)
+    return;
+
+  if (GNUNET_YES == GNUNET_DISK_file_test_read(filename))
+    remove(filename);
+
+  GNUNET_free(filename);
+
+  if (!(handle->store))
+    return;
+
+  struct GNUNET_CHAT_File *file = NULL;
+
+  if (GNUNET_YES == internal_store_is_collecting(handle->store, hash))
+    file = GNUNET_CONTAINER_multihashmap_get(handle->files, hash);
+
+  internal_store_remove(handle->store, hash);
+
+  if (!file)
+    return;
+
+  // Applications may still refer to collected files and their messages
+  // keep the URI and key to download them again, so only the local
+  // state of the file gets reset.
+  file_close_reader(file);
+
+  file->status &= (
+    GNUNET_CHAT_FILE_STATUS_MASK ^ GNUNET_CHAT_FILE_STATUS_DOWNLOAD
+  );
+}
+
 void*
 notify_handle_fs_progress(void* cls,
 			                    const struct GNUNET_FS_ProgressInfo* info)
@@ -226,6 +278,12 @@ notify_handle_fs_progress(void* cls,
       );
 
       file->download = NULL;
+
+      if (!(chat->store))
+        break;
+
+      internal_store_add(chat->store, &(file->hash));
+      handle_update_files(chat);
       break;
     } case GNUNET_FS_STATUS_DOWNLOAD_ERROR: {
       break;
@@ -259,17 +317,23 @@ notify_handle_fs_progress(void* cls,
       );
 
       file->unindex = NULL;
-      char *filename = handle_create_file_path(
-        chat, &(file->hash)
-      );
+      remove_handle_file(chat, &(file->hash));
+      break;
+    } case GNUNET_FS_STATUS_UNINDEX_ERROR: {
+      struct GNUNET_CHAT_File *file = info->value.unindex.cctx;
 
-      if (!filename)
+      if ((!file) || (!(chat->store)) ||
+          (GNUNET_YES != internal_store_is_collecting(chat->store, &(file->hash))))
         break;
 
-      if (GNUNET_YES == GNUNET_DISK_file_test_read(filename))
-        remove(filename);
+      // Files which were never indexed, like downloaded ones, can
+      // not be unindexed but still need to be deleted.
+      file->status &= (
+        GNUNET_CHAT_FILE_STATUS_MASK ^ GNUNET_CHAT_FILE_STATUS_UNINDEX
+      );
 
-      GNUNET_free(filename);
+      file->unindex = NULL;
+      remove_handle_file(chat, &(file->hash));
       break;
     } default: {
       break;
@@ -279,6 +343,57 @@ notify_handle_fs_progress(void* cls,
   return NULL;
 }
 
+void
+on_handle_collection (void *cls)
+{
+  GNUNET_assert(cls);
+
+  struct GNUNET_CHAT_Handle* handle = cls;
+
+  handle->collection = NULL;
+
+  handle_collect_files(handle, GNUNET_NO);
+}
+
+enum GNUNET_GenericReturnValue
+it_handle_collect_file (void *cls,
+                        const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((cls) && (hash));
+
+  struct GNUNET_CHAT_Handle *handle = cls;
+  struct GNUNET_CHAT_File *file = GNUNET_CONTAINER_multihashmap_get(
+    handle->files, hash
+  );
+
+  if ((!file) || (!(handle->fs)) || (file->preview) ||
+      (file->publish) || (file->download) || (file->unindex) ||
+      (file->status & GNUNET_CHAT_FILE_STATUS_MASK))
+    return GNUNET_NO;
+
+  char *filename = handle_create_file_path(
+    handle, hash
+  );
+
+  if (!filename)
+    return GNUNET_NO;
+
+  file_close_reader(file);
+
+  file->unindex = GNUNET_FS_unindex_start(
+    handle->fs, filename, file
+  );
+
+  GNUNET_free(filename);
+
+  if (file->unindex)
+    file->status |= GNUNET_CHAT_FILE_STATUS_UNINDEX;
+  else
+    remove_handle_file(handle, hash);
+
+  return GNUNET_YES;
+}
+
 static void
 on_handle_refresh (void *cls)
 {
@@ -313,62 +428,62 @@ on_handle_gnunet_identity (void *cls,
 
   if ((!ctx) || (!ego))
   {
+    internal_startup_end(handle->startup, GNUNET_CHAT_STARTUP_PHASE_IDENTITY);
+
     handle->refreshing = GNUNET_YES;
     goto send_refresh;
   }
 
-  struct GNUNET_CHAT_InternalAccounts *accounts = handle->accounts_head;
+  struct GNUNET_CHAT_InternalAccounts *accounts;
+  accounts = internal_accounts_find_by_ego(handle, ego);
 
-  while (accounts)
-  {
-    if (!(accounts->account))
-      goto skip_account;
+  if (!accounts)
+    goto check_matching_name;
 
-    if (ego != accounts->account->ego)
-      goto check_matching_name;
+  if ((name) && ((!(accounts->account->name)) ||
+      (0 != strcmp(accounts->account->name, name))))
+  {
+    util_set_name_field(name, &(accounts->account->name));
+    internal_accounts_index(accounts);
 
-    if ((name) && ((!(accounts->account->name)) ||
-        (0 != strcmp(accounts->account->name, name))))
-    {
-      util_set_name_field(name, &(accounts->account->name));
-
-      handle_send_internal_message(
-        handle,
-        accounts->account,
-        NULL,
-        GNUNET_CHAT_FLAG_UPDATE_ACCOUNT,
-        NULL,
-        GNUNET_YES
-      );
-    }
-    else if ((!name) && (!(accounts->op)))
-    {
-      if (handle->current == accounts->account)
-	      handle_disconnect(handle);
+    handle_send_internal_message(
+      handle,
+      accounts->account,
+      NULL,
+      GNUNET_CHAT_FLAG_UPDATE_ACCOUNT,
+      NULL,
+      GNUNET_YES
+    );
+  }
+  else if ((!name) && (GNUNET_CHAT_ACCOUNT_NONE == accounts->method))
+  {
+    if (handle->current == accounts->account)
+      handle_disconnect(handle);
 
-      account_destroy(accounts->account);
-      internal_accounts_destroy(accounts);
-    }
-    else if (!name)
-      account_update_ego(accounts->account, handle, NULL);
+    account_destroy(accounts->account);
+    internal_accounts_destroy(accounts);
+  }
+  else if (!name)
+  {
+    account_update_ego(accounts->account, handle, NULL);
+    internal_accounts_index(accounts);
+  }
 
-    goto send_refresh;
+  goto send_refresh;
 
 check_matching_name:
-    if ((name) && (accounts->account->name) && (ego) &&
-	      (0 == strcmp(accounts->account->name, name)))
-    {
-      account_update_ego(accounts->account, handle, ego);
-      goto send_refresh;
-    }
-
-skip_account:
-    accounts = accounts->next;
-  }
-
   if (!name)
     return;
 
+  accounts = internal_accounts_find_by_name(handle, name, GNUNET_NO);
+
+  if (accounts)
+  {
+    account_update_ego(accounts->account, handle, ego);
+    internal_accounts_index(accounts);
+    goto send_refresh;
+  }
+
   accounts = internal_accounts_create(
     handle,
     account_create_from_ego(ego, name)
@@ -400,9 +515,13 @@ cb_account_creation (void *cls,
   accounts->op = NULL;
 
   if ((!(accounts->account)) && (accounts->identifier))
+  {
     accounts->account = account_create(
       accounts->identifier
     );
+
+    internal_accounts_index(accounts);
+  }
   
   internal_accounts_stop_method(accounts);
   
@@ -655,6 +774,153 @@ scan_handle_room_members (void* cls,
     return GNUNET_NO;
 }
 
+int
+it_store_handle_snapshot (void *cls,
+                          const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert((cls) && (key) && (value));
+
+  struct GNUNET_CHAT_InternalSnapshot *snapshot = cls;
+  const struct GNUNET_CHAT_Context *context = value;
+
+  if ((!(context->room)) || (GNUNET_YES == context->deleted))
+    return GNUNET_YES;
+
+  struct GNUNET_PeerIdentity door;
+  
+  if (GNUNET_YES != GNUNET_is_zero(&(context->door)))
+    GNUNET_memcpy(&door, &(context->door), sizeof(door));
+  else if (GNUNET_OK != GNUNET_CRYPTO_get_peer_identity(
+      context->handle->cfg, &door))
+    return GNUNET_YES;
+
+  internal_snapshot_add(
+    snapshot,
+    key,
+    &door,
+    (uint32_t) context->type,
+    context->flags,
+    context->nick,
+    context->topic
+  );
+
+  return GNUNET_YES;
+}
+
+enum GNUNET_GenericReturnValue
+it_restore_handle_snapshot (void *cls,
+                            const struct GNUNET_CHAT_InternalSnapshotRecord *record,
+                            const char *nick,
+                            const char *topic)
+{
+  GNUNET_assert((cls) && (record));
+
+  struct GNUNET_CHAT_Handle *handle = cls;
+
+  if (GNUNET_YES == GNUNET_CONTAINER_multihashmap_contains(
+      handle->contexts, &(record->key)))
+    return GNUNET_YES;
+
+  union GNUNET_MESSENGER_RoomKey key;
+  GNUNET_memcpy(&(key.hash), &(record->key), sizeof(key.hash));
+
+  struct GNUNET_MESSENGER_Room *room = GNUNET_MESSENGER_enter_room(
+    handle->messenger,
+    &(record->door),
+    &key
+  );
+
+  if (!room)
+    return GNUNET_YES;
+
+  struct GNUNET_CHAT_Context *context = context_create_from_room(handle, room);
+  GNUNET_memcpy(&(context->door), &(record->door), sizeof(context->door));
+
+  context->type = (enum GNUNET_CHAT_ContextType) ntohl(record->type);
+  context->flags = ntohl(record->flags);
+
+  util_set_name_field(nick, &(context->nick));
+  util_set_name_field(topic, &(context->topic));
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      handle->contexts, &(record->key), context,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    context_destroy(context);
+    GNUNET_MESSENGER_close_room(room);
+    return GNUNET_YES;
+  }
+
+  GNUNET_CONTAINER_multihashmap_put(
+    handle->restored, &(record->key), context,
+    GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST
+  );
+
+  if (GNUNET_CHAT_CONTEXT_TYPE_GROUP != context->type)
+    return GNUNET_YES;
+
+  struct GNUNET_CHAT_Group *group = group_create_from_context(handle, context);
+
+  if (context->topic)
+    group_publish(group);
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      handle->groups, &(record->key), group,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+    group_destroy(group);
+
+  return GNUNET_YES;
+}
+
+int
+it_reconcile_handle_snapshot (void *cls,
+                              const struct GNUNET_HashCode *key,
+                              void *value)
+{
+  GNUNET_assert((cls) && (key) && (value));
+
+  struct GNUNET_CHAT_Handle *handle = cls;
+  struct GNUNET_CHAT_Context *context = value;
+
+  if (!(handle->contexts))
+    return GNUNET_NO;
+
+  if (GNUNET_YES == context->deleted)
+    return GNUNET_YES;
+
+  // The zone does not contain a record of this context anymore,
+  // so the snapshot was outdated and the context gets deleted.
+  // Its group stays valid for the application until disconnect.
+  if (context->room)
+    context_delete(context, GNUNET_YES);
+  else
+    context->deleted = GNUNET_YES;
+
+  handle_send_internal_message(
+    handle,
+    NULL,
+    context,
+    GNUNET_CHAT_FLAG_UPDATE_CONTEXT,
+    NULL,
+    GNUNET_NO
+  );
+
+  return GNUNET_YES;
+}
+
+void
+on_monitor_namestore_error(void *cls)
+{
+  struct GNUNET_CHAT_Handle *chat = cls;
+
+  GNUNET_assert(chat);
+
+  // The monitor reconnects after errors and only gets granted a
+  // single record again, so the next batch gets requested after.
+  chat->monitor_limit = 1;
+}
+
 void
 on_monitor_namestore_record(void *cls,
                             GNUNET_UNUSED const
@@ -673,29 +939,72 @@ on_monitor_namestore_record(void *cls,
   }
 
   handle_process_records(chat, label, count, data);
+  chat->namestore_records++;
+
+  if (chat->monitor_limit)
+    chat->monitor_limit--;
+
+  if ((!(chat->monitor)) || (chat->monitor_limit))
+    return;
+
+  chat->monitor_limit = chat->monitor_batch;
+  chat->namestore_round_trips++;
 
-  if (chat->monitor)
-    GNUNET_NAMESTORE_zone_monitor_next(chat->monitor, 1);
+  GNUNET_NAMESTORE_zone_monitor_next(chat->monitor, chat->monitor_batch);
 }
 
 void
-on_handle_message_callback(void *cls);
+on_handle_writes_error (void *cls,
+                        enum GNUNET_ErrorCode ec)
+{
+  struct GNUNET_CHAT_Handle *handle = cls;
 
-static enum GNUNET_GenericReturnValue
-it_context_iterate_dependencies(void *cls,
-                                const struct GNUNET_HashCode *key,
-                                void *value)
+  GNUNET_assert(handle);
+
+  handle_send_internal_message(
+    handle,
+    NULL,
+    NULL,
+    GNUNET_CHAT_FLAG_WARNING,
+    GNUNET_ErrorCode_get_hint(ec),
+    GNUNET_YES
+  );
+}
+
+void
+on_handle_write_records (void *cls)
 {
-  struct GNUNET_CHAT_Message *message = (struct GNUNET_CHAT_Message*) value;
+  struct GNUNET_CHAT_Handle *handle = cls;
 
-  if ((message) && (!message->task))
-    message->task = GNUNET_SCHEDULER_add_now(
-      on_handle_message_callback, message
-    );
+  GNUNET_assert(handle);
 
-  return GNUNET_YES;
+  handle->writing = NULL;
+  handle_flush_records(handle);
+}
+
+void
+on_monitor_namestore_sync(void *cls)
+{
+  struct GNUNET_CHAT_Handle *chat = cls;
+
+  GNUNET_assert(chat);
+
+  internal_startup_end(chat->startup, GNUNET_CHAT_STARTUP_PHASE_ZONE);
+
+  if (!(chat->restored))
+    return;
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    chat->restored, it_reconcile_handle_snapshot, chat
+  );
+
+  GNUNET_CONTAINER_multihashmap_destroy(chat->restored);
+  chat->restored = NULL;
 }
 
+void
+on_handle_message_callback(void *cls);
+
 void
 on_handle_internal_message_callback(void *cls)
 {
@@ -821,8 +1130,15 @@ on_handle_message_callback(void *cls)
                                                                &(message->hash)))
         break;
 
+      struct GNUNET_CHAT_InternalStoreEntry *entry = NULL;
+
+      if (context->handle->store)
+        entry = internal_store_acquire(
+          context->handle->store, &(message->msg->body.file.hash)
+        );
+
       GNUNET_CONTAINER_multihashmap_put(
-        context->files, &(message->hash), NULL,
+        context->files, &(message->hash), entry,
         GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST
       );
 
@@ -850,7 +1166,7 @@ on_handle_message_callback(void *cls)
       
       if (!tagging)
       {
-        tagging = internal_tagging_create();
+        tagging = internal_tagging_create(context->handle->tag_index);
 
         if (!tagging)
           break;
@@ -864,7 +1180,19 @@ on_handle_message_callback(void *cls)
         }
       }
 
-      internal_tagging_add(tagging, message);
+      if (GNUNET_OK != internal_tagging_add(tagging, message))
+        break;
+
+      const struct GNUNET_MESSENGER_Contact *target = GNUNET_MESSENGER_get_sender(
+        context->room, &(message->msg->body.tag.hash)
+      );
+
+      struct GNUNET_CHAT_Contact *tagged = target? handle_get_contact_from_messenger(
+        context->handle, target
+      ) : NULL;
+
+      if (tagged)
+        contact_track_tag(tagged, context, message);
       break;
     }
     default:
@@ -1006,23 +1334,37 @@ skip_msg_handing:
 
       break;
     }
+    case GNUNET_MESSENGER_KIND_TALK:
+    {
+      struct GNUNET_CHAT_Discourse *discourse = GNUNET_CONTAINER_multishortmap_get(
+        context->discourses, &(message->msg->body.talk.discourse)
+      );
+
+      // Only new data gets played out, so neither updates of
+      // known messages nor messages from the history.
+      if ((!discourse) || (!(discourse->playout)) ||
+          (message->flags & GNUNET_MESSENGER_FLAG_UPDATE) ||
+          (0 == (message->flags & GNUNET_MESSENGER_FLAG_RECENT)))
+        break;
+
+      internal_playout_add(
+        discourse->playout,
+        &shorthash,
+        GNUNET_TIME_absolute_ntoh(message->msg->header.timestamp),
+        message->msg->body.talk.data,
+        message->msg->body.talk.length
+      );
+      break;
+    }
     default:
       break;
   }
 
 skip_sender_handing:
-  if (!(handle->msg_cb))
-    goto clear_dependencies;
-
-  handle->msg_cb(handle->msg_cls, context, message);
+  context_deliver_message(context, message);
 
 clear_dependencies:
-  GNUNET_CONTAINER_multihashmap_get_multiple(context->dependencies,
-                                             &(message->hash),
-                                             it_context_iterate_dependencies,
-                                             NULL);
-  GNUNET_CONTAINER_multihashmap_remove_all(context->dependencies,
-                                           &(message->hash));
+  internal_dependencies_resolve(context->dependencies, &(message->hash));
 }
 
 void
@@ -1051,19 +1393,24 @@ on_handle_message (void *cls,
     handle->contexts, GNUNET_MESSENGER_room_get_key(room)
   );
 
+  context_materialize(context);
+  internal_startup_end(handle->startup, GNUNET_CHAT_STARTUP_PHASE_MESSENGER);
+
+  const struct GNUNET_TIME_Absolute timestamp = GNUNET_TIME_absolute_ntoh(
+    msg->header.timestamp
+  );
+
+  internal_backfill_complete(context->backfill, hash);
+
   if (GNUNET_MESSENGER_KIND_MERGE == msg->header.kind)
-    context_request_message(context, &(msg->body.merge.previous));
+    context_request_message(context, &(msg->body.merge.previous), timestamp);
 
-  context_request_message(context, &(msg->header.previous));
+  context_request_message(context, &(msg->header.previous), timestamp);
 
   if ((GNUNET_CHAT_KIND_UNKNOWN == util_message_kind_from_kind(msg->header.kind)) ||
       (GNUNET_OK != intern_provide_contact_for_member(handle, sender, NULL)))
     return;
 
-  const struct GNUNET_TIME_Absolute timestamp = GNUNET_TIME_absolute_ntoh(
-    msg->header.timestamp
-  );
-
   struct GNUNET_ShortHashCode shorthash;
   util_shorthash_from_member(sender, &shorthash);
 
@@ -1080,13 +1427,15 @@ on_handle_message (void *cls,
 
   if (!time)
   {
-    time = GNUNET_new(struct GNUNET_TIME_Absolute);
+    time = internal_pool_alloc(handle->timestamp_pool);
     *time = timestamp;
 
     if (GNUNET_OK != GNUNET_CONTAINER_multishortmap_put(
         context->timestamps, &shorthash, time,
         GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
-      GNUNET_free(time);
+      internal_pool_free(handle->timestamp_pool, time);
+    else
+      internal_receipts_update(context->receipts, NULL, timestamp);
   }
   else
   {
@@ -1094,8 +1443,12 @@ on_handle_message (void *cls,
 	    timestamp, *time
     );
 
-    if (GNUNET_TIME_relative_is_zero(delta))
+    if ((GNUNET_TIME_relative_is_zero(delta)) &&
+        (time->abs_value_us != timestamp.abs_value_us))
+    {
+      internal_receipts_update(context->receipts, time, timestamp);
       *time = timestamp;
+    }
   }
 
   const struct GNUNET_HashCode *dependency = NULL;
@@ -1114,6 +1467,7 @@ on_handle_message (void *cls,
     if (0 == (message->flags & GNUNET_MESSENGER_FLAG_UPDATE))
       return;
 
+    context_archive_message(context, message, &shorthash);
     goto handle_callback;
   }
 
@@ -1127,6 +1481,9 @@ on_handle_message (void *cls,
     return;
   }
 
+  internal_timeline_add(context->timeline, message);
+  context_archive_message(context, message, &shorthash);
+
 handle_callback:
   switch (msg->header.kind)
   {
@@ -1152,14 +1509,7 @@ handle_callback:
   if ((dependency) && 
       (GNUNET_YES != GNUNET_CONTAINER_multihashmap_contains(context->messages, dependency)))
   {
-    GNUNET_CONTAINER_multihashmap_put(
-      context->dependencies,
-      dependency,
-      message,
-      GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE
-    );
-
-    GNUNET_MESSENGER_get_message(room, dependency);
+    internal_dependencies_add(context->dependencies, dependency, message);
     return;
   }
 
@@ -1190,6 +1540,18 @@ it_destroy_handle_contacts (GNUNET_UNUSED void *cls,
   return GNUNET_YES;
 }
 
+int
+it_flush_handle_contexts (GNUNET_UNUSED void *cls,
+                          GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_Context *context = value;
+  context_flush_messages(context);
+  return GNUNET_YES;
+}
+
 int
 it_destroy_handle_contexts (GNUNET_UNUSED void *cls,
                             GNUNET_UNUSED const struct GNUNET_HashCode *key,
@@ -35,6 +35,7 @@
 
 #include <libgen.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <strings.h>
 #include <unistd.h>
@@ -53,7 +54,13 @@
 #include "gnunet_chat_ticket.h"
 #include "gnunet_chat_util.h"
 
+#include "internal/gnunet_chat_backfill.h"
+#include "internal/gnunet_chat_dependencies.h"
+#include "internal/gnunet_chat_playout.h"
+#include "internal/gnunet_chat_receipts.h"
+#include "internal/gnunet_chat_store.h"
 #include "internal/gnunet_chat_tagging.h"
+#include "internal/gnunet_chat_timeline.h"
 
 #include "gnunet_chat_lib_intern.c"
 
@@ -153,7 +160,8 @@ GNUNET_CHAT_iterate_accounts (struct GNUNET_CHAT_Handle *handle,
   struct GNUNET_CHAT_InternalAccounts *accounts = handle->accounts_head;
   while (accounts)
   {
-    if ((!(accounts->account)) || (accounts->op))
+    if ((!(accounts->account)) ||
+        (GNUNET_CHAT_ACCOUNT_NONE != accounts->method))
       goto skip_account;
 
     iterations++;
@@ -779,14 +787,15 @@ GNUNET_CHAT_upload_file (struct GNUNET_CHAT_Handle *handle,
   if (file)
     goto file_binding;
 
-  if ((GNUNET_YES == GNUNET_DISK_file_test(filename)) ||
-      (GNUNET_OK != GNUNET_DISK_directory_create_for_file(filename)) ||
-      (GNUNET_OK != GNUNET_DISK_file_copy(path, filename)))
+  if ((!(handle->store)) ||
+      (GNUNET_SYSERR == internal_store_import(handle->store, path, &hash)))
   {
     GNUNET_free(filename);
     return NULL;
   }
 
+  handle_update_files(handle);
+
   char* p = GNUNET_strdup(path);
 
   file = file_create_from_disk(
@@ -864,6 +873,64 @@ GNUNET_CHAT_iterate_files (struct GNUNET_CHAT_Handle *handle,
 }
 
 
+int
+GNUNET_CHAT_iterate_tagged_messages (struct GNUNET_CHAT_Handle *handle,
+                                     const char *tag,
+                                     GNUNET_CHAT_MessageCallback callback,
+                                     void *cls)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  return internal_tag_index_iterate(
+    handle->tag_index,
+    tag,
+    callback,
+    cls
+  );
+}
+
+
+void
+GNUNET_CHAT_set_file_quota (struct GNUNET_CHAT_Handle *handle,
+                            uint64_t quota)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction) || (!(handle->store)))
+    return;
+
+  handle->store->quota = quota;
+  handle_update_files(handle);
+}
+
+
+uint64_t
+GNUNET_CHAT_get_file_usage (const struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (!(handle->store)))
+    return 0;
+
+  return handle->store->usage;
+}
+
+
+int
+GNUNET_CHAT_collect_files (struct GNUNET_CHAT_Handle *handle)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  return handle_collect_files(handle, GNUNET_YES);
+}
+
+
 int
 GNUNET_CHAT_context_iterate_discourses (struct GNUNET_CHAT_Context *context,
                                         GNUNET_CHAT_DiscourseCallback callback,
@@ -871,9 +938,11 @@ GNUNET_CHAT_context_iterate_discourses (struct GNUNET_CHAT_Context *context,
 {
   GNUNET_CHAT_VERSION_ASSERT();
 
-  if ((!context) || (!(context->discourses)))
+  if (!context)
     return GNUNET_SYSERR;
 
+  context_materialize(context);
+
   struct GNUNET_CHAT_ContextIterateDiscourses it;
   it.context = context;
   it.cb = callback;
@@ -912,6 +981,220 @@ GNUNET_CHAT_get_user_pointer (const struct GNUNET_CHAT_Handle *handle)
 }
 
 
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_allocation_stats (const struct GNUNET_CHAT_Handle *handle,
+                                  unsigned long long *objects,
+                                  unsigned long long *allocations)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalPool *pools [] = {
+    handle->message_pool,
+    handle->internal_pool,
+    handle->timestamp_pool,
+  };
+
+  unsigned long long sum_objects = 0;
+  unsigned long long sum_allocations = 0;
+
+  for (size_t i = 0; i < sizeof(pools) / sizeof(*pools); i++)
+  {
+    sum_objects += pools[i]->objects;
+    sum_allocations += pools[i]->allocations;
+  }
+
+  if (objects)
+    *objects = sum_objects;
+  if (allocations)
+    *allocations = sum_allocations;
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_startup_profile (const struct GNUNET_CHAT_Handle *handle,
+                                 unsigned long long *services,
+                                 unsigned long long *identity,
+                                 unsigned long long *zone,
+                                 unsigned long long *messenger)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  unsigned long long *durations [GNUNET_CHAT_STARTUP_PHASE_COUNT];
+  durations[GNUNET_CHAT_STARTUP_PHASE_SERVICES] = services;
+  durations[GNUNET_CHAT_STARTUP_PHASE_IDENTITY] = identity;
+  durations[GNUNET_CHAT_STARTUP_PHASE_ZONE] = zone;
+  durations[GNUNET_CHAT_STARTUP_PHASE_MESSENGER] = messenger;
+
+  struct GNUNET_TIME_Relative duration;
+  for (unsigned int i = 0; i < GNUNET_CHAT_STARTUP_PHASE_COUNT; i++)
+  {
+    internal_startup_get(handle->startup, i, &duration);
+
+    if (durations[i])
+      *(durations[i]) = duration.rel_value_us / 1000LL;
+  }
+
+  if ((!(handle->current)) || (GNUNET_YES != internal_startup_get(
+      handle->startup, GNUNET_CHAT_STARTUP_PHASE_ZONE, NULL)))
+    return GNUNET_NO;
+
+  return GNUNET_YES;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_batch_callback (struct GNUNET_CHAT_Handle *handle,
+                                GNUNET_CHAT_ContextMessageBatchCallback batch_cb,
+                                void *batch_cls,
+                                unsigned int max_size,
+                                unsigned int max_delay)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction) || ((batch_cb) && (!max_size)))
+    return GNUNET_SYSERR;
+
+  if (handle->contexts)
+    GNUNET_CONTAINER_multihashmap_iterate(
+      handle->contexts, it_handle_flush_contexts, NULL
+    );
+
+  handle->batch_cb = batch_cb;
+  handle->batch_cls = batch_cls;
+  handle->batch_size = max_size;
+  handle->batch_delay = GNUNET_TIME_relative_multiply(
+    GNUNET_TIME_relative_get_millisecond_(), max_delay
+  );
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_dependency_limits (struct GNUNET_CHAT_Handle *handle,
+                                   unsigned int max_requests,
+                                   unsigned int timeout)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  handle->dependency_limit = max_requests;
+  handle->dependency_timeout = GNUNET_TIME_relative_multiply(
+    GNUNET_TIME_relative_get_millisecond_(), timeout
+  );
+
+  if (handle->contexts)
+    GNUNET_CONTAINER_multihashmap_iterate(
+      handle->contexts, it_handle_configure_contexts, NULL
+    );
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_message_cache (struct GNUNET_CHAT_Handle *handle,
+                               enum GNUNET_GenericReturnValue enabled)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction) ||
+      ((GNUNET_YES == enabled) && (!(handle->directory))))
+    return GNUNET_SYSERR;
+
+  handle->message_cache = (GNUNET_YES == enabled? GNUNET_YES : GNUNET_NO);
+
+  if (handle->contexts)
+    GNUNET_CONTAINER_multihashmap_iterate(
+      handle->contexts, it_handle_configure_contexts, NULL
+    );
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_set_zone_batch_size (struct GNUNET_CHAT_Handle *handle,
+                                 unsigned int batch_size)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction) || (!batch_size))
+    return GNUNET_SYSERR;
+
+  handle->monitor_batch = batch_size;
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_namestore_stats (const struct GNUNET_CHAT_Handle *handle,
+                                 unsigned long long *round_trips,
+                                 unsigned long long *records)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction))
+    return GNUNET_SYSERR;
+
+  if (round_trips)
+    *round_trips = handle->namestore_round_trips;
+  if (records)
+    *records = handle->namestore_records;
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_get_record_queue_stats (const struct GNUNET_CHAT_Handle *handle,
+                                    unsigned int *pending,
+                                    unsigned long long *written,
+                                    unsigned long long *coalesced,
+                                    unsigned long long *average_latency,
+                                    unsigned long long *maximum_latency)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!handle) || (handle->destruction) || (!(handle->writes)))
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalWrites *writes = handle->writes;
+
+  if (pending)
+    *pending = internal_writes_size(writes);
+
+  if (written)
+    *written = writes->written;
+
+  if (coalesced)
+    *coalesced = writes->coalesced;
+
+  if (average_latency)
+    *average_latency = writes->acknowledged?
+      GNUNET_TIME_relative_divide(
+        writes->latency, writes->acknowledged
+      ).rel_value_us / 1000LL : 0;
+
+  if (maximum_latency)
+    *maximum_latency = (
+      writes->max_latency.rel_value_us / 1000LL
+    );
+
+  return GNUNET_OK;
+}
+
+
 int
 GNUNET_CHAT_iterate_contacts (struct GNUNET_CHAT_Handle *handle,
                               GNUNET_CHAT_ContactCallback callback,
@@ -1521,6 +1804,8 @@ GNUNET_CHAT_member_set_user_pointer (struct GNUNET_CHAT_Group *group,
   if ((!group) || (!(group->context)) || (!member))
     return;
 
+  context_materialize(group->context);
+
   struct GNUNET_ShortHashCode hash;
   util_shorthash_from_member(member->member, &hash);
 
@@ -1539,7 +1824,8 @@ GNUNET_CHAT_member_get_user_pointer (const struct GNUNET_CHAT_Group *group,
 {
   GNUNET_CHAT_VERSION_ASSERT();
 
-  if ((!group) || (!(group->context)) || (!member))
+  if ((!group) || (!(group->context)) || (!member) ||
+      (!(group->context->member_pointers)))
     return NULL;
 
   struct GNUNET_ShortHashCode hash;
@@ -1847,16 +2133,17 @@ GNUNET_CHAT_context_send_file (struct GNUNET_CHAT_Context *context,
   if ((!context) || (!path) || (!(context->room)))
     return NULL;
 
-  struct GNUNET_HashCode hash;
-  if (GNUNET_OK != util_hash_file(path, &hash))
+  char *tmpname = handle_create_temporary_file_path(context->handle);
+
+  if (!tmpname)
     return NULL;
 
-  char *filename = handle_create_file_path(
-    context->handle, &hash
-  );
+  struct GNUNET_HashCode hash;
+  struct GNUNET_CRYPTO_SymmetricSessionKey key;
+  GNUNET_CRYPTO_symmetric_create_session_key(&key);
 
-  if (!filename)
-    return NULL;
+  if (GNUNET_OK != util_hash_encrypt_file(path, tmpname, &hash, &key))
+    goto remove_tmpfile;
 
   struct GNUNET_CHAT_File *file = GNUNET_CONTAINER_multihashmap_get(
     context->handle->files,
@@ -1864,25 +2151,31 @@ GNUNET_CHAT_context_send_file (struct GNUNET_CHAT_Context *context,
   );
 
   if (file)
-    goto file_binding;
-
-  if ((GNUNET_YES == GNUNET_DISK_file_test(filename)) ||
-      (GNUNET_OK != GNUNET_DISK_directory_create_for_file(filename)) ||
-      (GNUNET_OK != GNUNET_DISK_file_copy(path, filename)))
   {
-    GNUNET_free(filename);
-    return NULL;
+    remove(tmpname);
+    GNUNET_free(tmpname);
+    goto file_binding;
   }
 
-  struct GNUNET_CRYPTO_SymmetricSessionKey key;
-  GNUNET_CRYPTO_symmetric_create_session_key(&key);
+  char *filename = handle_create_file_path(
+    context->handle, &hash
+  );
 
-  if (GNUNET_OK != util_encrypt_file(filename, &hash, &key))
+  if (!filename)
+    goto remove_tmpfile;
+
+  // A blob stored already under the same hash has been encrypted
+  // with a different key or not at all, so it can not be shared.
+  if ((!(context->handle->store)) ||
+      (GNUNET_OK != internal_store_insert(context->handle->store, tmpname, &hash)))
   {
     GNUNET_free(filename);
-    return NULL;
+    goto remove_tmpfile;
   }
 
+  GNUNET_free(tmpname);
+  handle_update_files(context->handle);
+
   char* p = GNUNET_strdup(path);
 
   file = file_create_from_disk(
@@ -1934,6 +2227,11 @@ GNUNET_CHAT_context_send_file (struct GNUNET_CHAT_Context *context,
 file_binding:
   file_bind_upload(file, context, callback, cls);
   return file;
+
+remove_tmpfile:
+  remove(tmpname);
+  GNUNET_free(tmpname);
+  return NULL;
 }
 
 
@@ -2007,9 +2305,11 @@ GNUNET_CHAT_context_open_discourse (struct GNUNET_CHAT_Context *context,
 {
   GNUNET_CHAT_VERSION_ASSERT();
 
-  if ((!context) || (!(context->discourses)) || (!(context->room)) || (!id))
+  if ((!context) || (!(context->room)) || (!id))
     return NULL;
 
+  context_materialize(context);
+
   struct GNUNET_ShortHashCode sid;
   util_shorthash_from_discourse_id(id, &sid);
 
@@ -2066,6 +2366,8 @@ GNUNET_CHAT_context_iterate_messages (struct GNUNET_CHAT_Context *context,
   if (!context)
     return GNUNET_SYSERR;
 
+  context_materialize(context);
+
   struct GNUNET_CHAT_ContextIterateMessages it;
   it.context = context;
   it.cb = callback;
@@ -2077,6 +2379,150 @@ GNUNET_CHAT_context_iterate_messages (struct GNUNET_CHAT_Context *context,
 }
 
 
+int
+GNUNET_CHAT_context_iterate_messages_range (struct GNUNET_CHAT_Context *context,
+                                            time_t from,
+                                            time_t to,
+                                            unsigned int limit,
+                                            enum GNUNET_GenericReturnValue reverse,
+                                            GNUNET_CHAT_ContextMessageCallback callback,
+                                            void *cls)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!context)
+    return GNUNET_SYSERR;
+
+  if ((to < 0) || (from > to))
+    return 0;
+
+  context_materialize(context);
+
+  struct GNUNET_TIME_Absolute abs_from = GNUNET_TIME_absolute_from_s(
+    from > 0? (uint64_t) from : 0
+  );
+
+  struct GNUNET_TIME_Absolute abs_to = GNUNET_TIME_absolute_add(
+    GNUNET_TIME_absolute_from_s((uint64_t) to),
+    GNUNET_TIME_relative_subtract(
+      GNUNET_TIME_UNIT_SECONDS,
+      GNUNET_TIME_UNIT_MICROSECONDS
+    )
+  );
+
+  struct GNUNET_CHAT_ContextIterateMessages it;
+  it.context = context;
+  it.cb = callback;
+  it.cls = cls;
+
+  return internal_timeline_iterate(
+    context->timeline,
+    abs_from,
+    abs_to,
+    limit,
+    reverse,
+    it_context_iterate_timeline,
+    &it
+  );
+}
+
+
+int
+GNUNET_CHAT_context_iterate_cached_messages (struct GNUNET_CHAT_Context *context,
+                                             GNUNET_CHAT_ContextMessageCallback callback,
+                                             void *cls)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!context) || (!(context->room)))
+    return GNUNET_SYSERR;
+
+  return context_iterate_archive(context, callback, cls);
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_reserve (struct GNUNET_CHAT_Context *context,
+                             unsigned int expected_messages)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!context)
+    return GNUNET_SYSERR;
+
+  context_materialize(context);
+  context_reserve_messages(context, expected_messages);
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_get_dependency_stats (const struct GNUNET_CHAT_Context *context,
+                                          unsigned int *pending,
+                                          unsigned long long *resolved,
+                                          unsigned long long *expired,
+                                          unsigned long long *average_latency,
+                                          unsigned long long *maximum_latency)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!context)
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalDependencies *dependencies;
+  dependencies = context->dependencies;
+
+  if (pending)
+    *pending = dependencies? internal_dependencies_size(dependencies) : 0;
+
+  if (resolved)
+    *resolved = dependencies? dependencies->resolved : 0;
+
+  if (expired)
+    *expired = dependencies? dependencies->expired : 0;
+
+  if (average_latency)
+    *average_latency = (dependencies) && (dependencies->resolved)?
+      GNUNET_TIME_relative_divide(
+        dependencies->latency, dependencies->resolved
+      ).rel_value_us / 1000LL : 0;
+
+  if (maximum_latency)
+    *maximum_latency = dependencies? (
+      dependencies->max_latency.rel_value_us / 1000LL
+    ) : 0;
+
+  return GNUNET_OK;
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_context_get_sync_progress (const struct GNUNET_CHAT_Context *context,
+                                       unsigned int *pending,
+                                       unsigned int *outstanding,
+                                       unsigned long long *completed)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!context)
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalBackfill *backfill = context->backfill;
+  const unsigned int size = backfill? internal_backfill_size(backfill) : 0;
+
+  if (pending)
+    *pending = size;
+
+  if (outstanding)
+    *outstanding = backfill? backfill->outstanding : 0;
+
+  if (completed)
+    *completed = backfill? backfill->completed : 0;
+
+  return size > 0? GNUNET_NO : GNUNET_YES;
+}
+
+
 int
 GNUNET_CHAT_context_iterate_files (struct GNUNET_CHAT_Context *context,
                                    GNUNET_CHAT_ContextFileCallback callback,
@@ -2087,6 +2533,8 @@ GNUNET_CHAT_context_iterate_files (struct GNUNET_CHAT_Context *context,
   if (!context)
     return GNUNET_SYSERR;
 
+  context_materialize(context);
+
   struct GNUNET_CHAT_ContextIterateFiles it;
   it.context = context;
   it.cb = callback;
@@ -2285,6 +2733,10 @@ GNUNET_CHAT_message_is_tagged (const struct GNUNET_CHAT_Message *message,
   if ((!message) || (!(message->context)))
     return GNUNET_SYSERR;
 
+  // Contexts which are not materialized yet hold no taggings
+  if (!(message->context->taggings))
+    return GNUNET_NO;
+
   const struct GNUNET_CHAT_InternalTagging *tagging = GNUNET_CONTAINER_multihashmap_get(
     message->context->taggings, &(message->hash));
   
@@ -2320,6 +2772,23 @@ GNUNET_CHAT_message_get_read_receipt (struct GNUNET_CHAT_Message *message,
 }
 
 
+int
+GNUNET_CHAT_message_get_read_count (const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!message) || (GNUNET_YES != message_has_msg(message)) || 
+      (!(message->context)))
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_TIME_Absolute timestamp = GNUNET_TIME_absolute_ntoh(
+    message->msg->header.timestamp
+  );
+
+  return (int) internal_receipts_count(message->context->receipts, timestamp);
+}
+
+
 const char*
 GNUNET_CHAT_message_get_text (const struct GNUNET_CHAT_Message *message)
 {
@@ -2412,7 +2881,7 @@ GNUNET_CHAT_message_get_invitation (const struct GNUNET_CHAT_Message *message)
   GNUNET_CHAT_VERSION_ASSERT();
 
   if ((!message) || (GNUNET_YES != message_has_msg(message)) || 
-      (!(message->context)))
+      (!(message->context)) || (!(message->context->invites)))
     return NULL;
 
   if (GNUNET_MESSENGER_KIND_INVITE != message->msg->header.kind)
@@ -2457,7 +2926,7 @@ GNUNET_CHAT_message_get_target (const struct GNUNET_CHAT_Message *message)
   GNUNET_CHAT_VERSION_ASSERT();
 
   if ((!message) || (GNUNET_YES != message_has_msg(message)) || 
-      (!(message->context)))
+      (!(message->context)) || (!(message->context->messages)))
     return NULL;
 
   struct GNUNET_CHAT_Message *target;
@@ -2509,6 +2978,9 @@ GNUNET_CHAT_message_iterate_tags (struct GNUNET_CHAT_Message *message,
   if ((!message) || (!(message->context)))
     return GNUNET_SYSERR;
 
+  if (!(message->context->taggings))
+    return 0;
+
   const struct GNUNET_CHAT_InternalTagging *tagging = GNUNET_CONTAINER_multihashmap_get(
     message->context->taggings, &(message->hash));
   
@@ -2745,6 +3217,30 @@ free_filename:
 }
 
 
+ssize_t
+GNUNET_CHAT_file_read_range (struct GNUNET_CHAT_File *file,
+                             uint64_t offset,
+                             void *buffer,
+                             size_t size)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!file) || (!buffer) ||
+      (file->status & (GNUNET_CHAT_FILE_STATUS_DOWNLOAD |
+                       GNUNET_CHAT_FILE_STATUS_UNINDEX)))
+    return GNUNET_SYSERR;
+
+  if (!size)
+    return 0;
+
+  if ((!(file->reader)) && (file->uri) &&
+      (GNUNET_CHAT_file_get_size(file) != GNUNET_CHAT_file_get_local_size(file)))
+    return GNUNET_SYSERR;
+
+  return file_read_range(file, offset, buffer, size);
+}
+
+
 void
 GNUNET_CHAT_file_close_preview (struct GNUNET_CHAT_File *file)
 {
@@ -2852,6 +3348,7 @@ GNUNET_CHAT_file_start_download (struct GNUNET_CHAT_File *file,
   }
 
   file_bind_downlaod(file, callback, cls);
+  file_close_reader(file);
 
   const uint64_t remaining = (size - offset);
 
@@ -2959,6 +3456,8 @@ GNUNET_CHAT_file_unindex (struct GNUNET_CHAT_File *file,
   if (!filename)
     return GNUNET_SYSERR;
 
+  file_close_reader(file);
+
   file->unindex = GNUNET_FS_unindex_start(
     file->handle->fs, filename, file
   );
@@ -3083,7 +3582,7 @@ GNUNET_CHAT_invitation_is_rejected (const struct GNUNET_CHAT_Invitation *invitat
 {
   GNUNET_CHAT_VERSION_ASSERT();
 
-  if (!invitation)
+  if ((!invitation) || (!(invitation->context->taggings)))
     return GNUNET_NO;
 
   const struct GNUNET_CHAT_InternalTagging *tagging = GNUNET_CONTAINER_multihashmap_get(
@@ -3133,10 +3632,12 @@ GNUNET_CHAT_discourse_is_open (const struct GNUNET_CHAT_Discourse *discourse)
   if (!discourse)
     return GNUNET_SYSERR;
 
+  const struct GNUNET_TIME_Absolute now = GNUNET_TIME_absolute_get();
+
   struct GNUNET_CHAT_DiscourseSubscription *sub;
   for (sub = discourse->head; sub; sub = sub->next)
   {
-    if (GNUNET_TIME_absolute_cmp(sub->end, <, GNUNET_TIME_absolute_get()))
+    if (GNUNET_TIME_absolute_cmp(sub->end, <, now))
       continue;
 
     if (GNUNET_YES == sub->contact->owned)
@@ -3221,7 +3722,6 @@ GNUNET_CHAT_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
   memset(&msg, 0, sizeof(msg));
 
   msg.header.kind = GNUNET_MESSENGER_KIND_TALK;
-  msg.body.talk.data = GNUNET_malloc(size > max_size? max_size : size);
 
   util_shorthash_from_discourse_id(
     &(discourse->id),
@@ -3231,12 +3731,7 @@ GNUNET_CHAT_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
   while (size > 0)
   {
     msg.body.talk.length = (uint16_t) (size > max_size? max_size : size);
-
-    GNUNET_memcpy(
-      msg.body.talk.data,
-      data,
-      msg.body.talk.length
-    );
+    msg.body.talk.data = (char*) data;
 
     size -= msg.body.talk.length;
     data += msg.body.talk.length;
@@ -3244,11 +3739,45 @@ GNUNET_CHAT_discourse_write (struct GNUNET_CHAT_Discourse *discourse,
     GNUNET_MESSENGER_send_message(discourse->context->room, &msg, NULL);
   }
 
-  GNUNET_free(msg.body.talk.data);
   return GNUNET_OK;
 }
 
 
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_discourse_writev (struct GNUNET_CHAT_Discourse *discourse,
+                              const struct iovec *iov,
+                              int iovcnt,
+                              GNUNET_CHAT_DiscourseWriteCallback callback,
+                              void *cls)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!discourse) || (!iov) || (iovcnt <= 0) || 
+      (!(discourse->context)) || (!(discourse->context->room)))
+    return GNUNET_SYSERR;
+
+  for (int i = 0; i < iovcnt; i++)
+    if ((iov[i].iov_len > 0) && (!(iov[i].iov_base)))
+      return GNUNET_SYSERR;
+
+  discourse_writev(discourse, iov, iovcnt, callback, cls);
+  return GNUNET_OK;
+}
+
+
+void
+GNUNET_CHAT_discourse_set_write_window (struct GNUNET_CHAT_Discourse *discourse,
+                                        unsigned int window)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!discourse)
+    return;
+
+  discourse->write_window = window > 0? window : 1;
+}
+
+
 int
 GNUNET_CHAT_discourse_get_fd (const struct GNUNET_CHAT_Discourse *discourse)
 {
@@ -3261,6 +3790,93 @@ GNUNET_CHAT_discourse_get_fd (const struct GNUNET_CHAT_Discourse *discourse)
 }
 
 
+void
+GNUNET_CHAT_discourse_set_playout_delay (struct GNUNET_CHAT_Discourse *discourse,
+                                         unsigned int delay)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if (!discourse)
+    return;
+
+  if (!delay)
+  {
+    if (discourse->playout)
+      internal_playout_destroy(discourse->playout);
+
+    discourse->playout = NULL;
+    return;
+  }
+
+  const struct GNUNET_TIME_Relative playout_delay = GNUNET_TIME_relative_multiply(
+    GNUNET_TIME_UNIT_MILLISECONDS, delay
+  );
+
+  if (discourse->playout)
+    internal_playout_set_delay(discourse->playout, playout_delay);
+  else
+    discourse->playout = internal_playout_create(
+      playout_delay, cb_discourse_playout_error, discourse
+    );
+}
+
+
+enum GNUNET_GenericReturnValue
+GNUNET_CHAT_discourse_set_playout_fd (struct GNUNET_CHAT_Discourse *discourse,
+                                      const struct GNUNET_CHAT_Contact *contact,
+                                      int fd)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!discourse) || (!contact) || (!(contact->member)) ||
+      (!(discourse->playout)))
+    return GNUNET_SYSERR;
+
+  struct GNUNET_ShortHashCode shorthash;
+  util_shorthash_from_member(contact->member, &shorthash);
+
+  return internal_playout_set_fd(discourse->playout, &shorthash, fd);
+}
+
+
+uint64_t
+GNUNET_CHAT_discourse_available (const struct GNUNET_CHAT_Discourse *discourse,
+                                 const struct GNUNET_CHAT_Contact *contact)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!discourse) || (!contact) || (!(contact->member)) ||
+      (!(discourse->playout)))
+    return 0;
+
+  struct GNUNET_ShortHashCode shorthash;
+  util_shorthash_from_member(contact->member, &shorthash);
+
+  return internal_playout_available(discourse->playout, &shorthash);
+}
+
+
+int64_t
+GNUNET_CHAT_discourse_read (struct GNUNET_CHAT_Discourse *discourse,
+                            const struct GNUNET_CHAT_Contact *contact,
+                            char *data,
+                            uint64_t size)
+{
+  GNUNET_CHAT_VERSION_ASSERT();
+
+  if ((!discourse) || (!contact) || (!(contact->member)) || (!data) ||
+      (!(discourse->playout)))
+    return GNUNET_SYSERR;
+
+  struct GNUNET_ShortHashCode shorthash;
+  util_shorthash_from_member(contact->member, &shorthash);
+
+  return (int64_t) internal_playout_read(
+    discourse->playout, &shorthash, data, size
+  );
+}
+
+
 int
 GNUNET_CHAT_discourse_iterate_contacts (struct GNUNET_CHAT_Discourse *discourse,
                                         GNUNET_CHAT_DiscourseContactCallback callback,
@@ -3273,10 +3889,12 @@ GNUNET_CHAT_discourse_iterate_contacts (struct GNUNET_CHAT_Discourse *discourse,
 
   int iterations = 0;
 
+  const struct GNUNET_TIME_Absolute now = GNUNET_TIME_absolute_get();
+
   struct GNUNET_CHAT_DiscourseSubscription *sub;
   for (sub = discourse->head; sub; sub = sub->next)
   {
-    if (GNUNET_TIME_absolute_cmp(sub->end, <, GNUNET_TIME_absolute_get()))
+    if (GNUNET_TIME_absolute_cmp(sub->end, <, now))
       continue;
 
     if (callback)
@@ -44,16 +44,25 @@ task_handle_destruction (void *cls)
 
   struct GNUNET_CHAT_Handle *handle = (struct GNUNET_CHAT_Handle*) cls;
 
+  // Disconnecting stores all queued records, so the namestore must
+  // stay connected until it confirmed all of them.
+  handle->next = NULL;
+
+  if (handle->current)
+    handle_disconnect(handle);
+  else
+    handle_flush_records(handle);
+
   struct GNUNET_CHAT_InternalAccounts *accounts = handle->accounts_head;
   while (accounts)
   {
-    if ((accounts->op) && (GNUNET_CHAT_ACCOUNT_NONE != accounts->method))
+    if (GNUNET_CHAT_ACCOUNT_NONE != accounts->method)
       break;
 
     accounts = accounts->next;
   }
 
-  if (accounts)
+  if ((accounts) || (handle->writes->head))
   {
     handle->destruction = GNUNET_SCHEDULER_add_delayed_with_priority(
       GNUNET_TIME_relative_get_millisecond_(),
@@ -215,6 +224,31 @@ it_handle_find_own_contact (GNUNET_UNUSED void *cls,
   return GNUNET_NO;
 }
 
+enum GNUNET_GenericReturnValue
+it_handle_flush_contexts (GNUNET_UNUSED void *cls,
+                          GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_Context *context = value;
+  context_flush_messages(context);
+  return GNUNET_YES;
+}
+
+enum GNUNET_GenericReturnValue
+it_handle_configure_contexts (GNUNET_UNUSED void *cls,
+                              GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                              void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_Context *context = value;
+  context_configure_dependencies(context);
+  context_configure_archive(context);
+  return GNUNET_YES;
+}
+
 struct GNUNET_CHAT_HandleIterateGroups
 {
   struct GNUNET_CHAT_Handle *handle;
@@ -432,6 +466,20 @@ it_context_iterate_messages (void *cls,
   return it->cb(it->cls, it->context, message);
 }
 
+enum GNUNET_GenericReturnValue
+it_context_iterate_timeline (void *cls,
+                             struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((cls) && (message));
+
+  struct GNUNET_CHAT_ContextIterateMessages *it = cls;
+
+  if (!(it->cb))
+    return GNUNET_YES;
+
+  return it->cb(it->cls, it->context, message);
+}
+
 struct GNUNET_CHAT_ContextIterateFiles
 {
   struct GNUNET_CHAT_Context *context;
@@ -491,6 +539,27 @@ it_context_iterate_discourses (void *cls,
   return it->cb(it->cls, it->context, discourse);
 }
 
+void
+cb_discourse_playout_error (void *cls,
+                            GNUNET_UNUSED const struct GNUNET_ShortHashCode *sender)
+{
+  GNUNET_assert(cls);
+
+  struct GNUNET_CHAT_Discourse *discourse = cls;
+
+  if ((!(discourse->context)) || (!(discourse->context->handle)))
+    return;
+
+  handle_send_internal_message(
+    discourse->context->handle,
+    NULL,
+    discourse->context,
+    GNUNET_CHAT_FLAG_WARNING,
+    "Writing discourse playout failed!",
+    GNUNET_YES
+  );
+}
+
 struct GNUNET_CHAT_MessageIterateReadReceipts
 {
   struct GNUNET_CHAT_Message *message;
@@ -122,4 +122,6 @@ cont_lobby_identity_create (void *cls,
     cont_lobby_write_records,
     lobby
   );
+
+  lobby->handle->namestore_round_trips++;
 }
@@ -24,6 +24,9 @@
 
 #include "gnunet_chat_message.h"
 #include "gnunet_chat_context.h"
+#include "gnunet_chat_handle.h"
+
+#include "internal/gnunet_chat_pool.h"
 
 #include <gnunet/gnunet_messenger_service.h>
 
@@ -33,10 +36,12 @@ message_create_from_msg (struct GNUNET_CHAT_Context *context,
                          enum GNUNET_MESSENGER_MessageFlags flags,
                          const struct GNUNET_MESSENGER_Message *msg)
 {
-  GNUNET_assert((context) && (hash) && (msg));
+  GNUNET_assert((context) && (context->handle) && (hash) && (msg));
 
-  struct GNUNET_CHAT_Message *message = GNUNET_new(struct GNUNET_CHAT_Message);
+  struct GNUNET_CHAT_InternalPool *pool = context->handle->message_pool;
+  struct GNUNET_CHAT_Message *message = internal_pool_alloc(pool);
 
+  message->pool = pool;
   message->account = NULL;
   message->context = context;
   message->task = NULL;
@@ -52,13 +57,18 @@ message_create_from_msg (struct GNUNET_CHAT_Context *context,
 }
 
 struct GNUNET_CHAT_Message*
-message_create_internally (struct GNUNET_CHAT_Account *account,
+message_create_internally (struct GNUNET_CHAT_Handle *handle,
+                           struct GNUNET_CHAT_Account *account,
                            struct GNUNET_CHAT_Context *context,
                            enum GNUNET_CHAT_MessageFlag flag,
                            const char *warning)
 {
-  struct GNUNET_CHAT_Message *message = GNUNET_new(struct GNUNET_CHAT_Message);
+  GNUNET_assert(handle);
+
+  struct GNUNET_CHAT_InternalPool *pool = handle->message_pool;
+  struct GNUNET_CHAT_Message *message = internal_pool_alloc(pool);
 
+  message->pool = pool;
   message->account = account;
   message->context = context;
   message->task = NULL;
@@ -116,5 +126,8 @@ message_destroy (struct GNUNET_CHAT_Message* message)
   if (message->task)
     GNUNET_SCHEDULER_cancel(message->task);
 
-  GNUNET_free(message);
+  if (message->pool)
+    internal_pool_free(message->pool, message);
+  else
+    GNUNET_free(message);
 }
@@ -30,7 +30,9 @@
 #include <gnunet/gnunet_util_lib.h>
 
 struct GNUNET_CHAT_Context;
+struct GNUNET_CHAT_Handle;
 struct GNUNET_CHAT_Message;
+struct GNUNET_CHAT_InternalPool;
 
 struct GNUNET_CHAT_MessageList
 {
@@ -57,6 +59,7 @@ enum GNUNET_CHAT_MessageFlag
 
 struct GNUNET_CHAT_Message
 {
+  struct GNUNET_CHAT_InternalPool *pool;
   struct GNUNET_CHAT_Account *account;
 
   struct GNUNET_CHAT_Context *context;
@@ -93,10 +96,11 @@ message_create_from_msg (struct GNUNET_CHAT_Context *context,
                          const struct GNUNET_MESSENGER_Message *msg);
 
 /**
- * Creates an internal chat message with an optional chat
- * <i>account</i> or <i>context</i>, a custom <i>flag</i> 
- * and an optional <i>warning</i> text.
+ * Creates an internal chat message of a given chat <i>handle</i>
+ * with an optional chat <i>account</i> or <i>context</i>, a custom
+ * <i>flag</i> and an optional <i>warning</i> text.
  *
+ * @param[in,out] handle Chat handle
  * @param[in,out] account Chat account or NULL
  * @param[in,out] context Chat context or NULL
  * @param[in] flag Chat message flag
@@ -104,7 +108,8 @@ message_create_from_msg (struct GNUNET_CHAT_Context *context,
  * @return New internal chat message
  */
 struct GNUNET_CHAT_Message*
-message_create_internally (struct GNUNET_CHAT_Account *account,
+message_create_internally (struct GNUNET_CHAT_Handle *handle,
+                           struct GNUNET_CHAT_Account *account,
                            struct GNUNET_CHAT_Context *context,
                            enum GNUNET_CHAT_MessageFlag flag,
                            const char *warning);
@@ -26,12 +26,16 @@
 
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_messenger_service.h>
+#include <pthread.h>
+#include <unistd.h>
 
 static const char label_prefix_of_contact [] = "contact";
 static const char label_prefix_of_group [] = "group";
 
 static const char identity_prefix_of_lobby [] = "_gnunet_chat_lobby";
 
+static const unsigned int maximum_decryption_workers = 8;
+
 void
 util_shorthash_from_member (const struct GNUNET_MESSENGER_Contact *member,
 			                      struct GNUNET_ShortHashCode *shorthash)
@@ -223,6 +227,241 @@ skip_encryption:
   return GNUNET_OK;
 }
 
+static ssize_t
+read_file_block (struct GNUNET_DISK_FileHandle *file,
+                 void *block,
+                 size_t size)
+{
+  GNUNET_assert((file) && (block));
+
+  size_t offset = 0;
+  ssize_t result;
+
+  while (offset < size)
+  {
+    result = GNUNET_DISK_file_read(
+      file, ((uint8_t*) block) + offset, size - offset
+    );
+
+    if (result < 0)
+      return result;
+    else if (!result)
+      break;
+
+    offset += (size_t) result;
+  }
+
+  return (ssize_t) offset;
+}
+
+enum GNUNET_GenericReturnValue
+util_hash_encrypt_file (const char *source,
+                        const char *target,
+                        struct GNUNET_HashCode *hash,
+                        const struct GNUNET_CRYPTO_SymmetricSessionKey *key)
+{
+  GNUNET_assert((source) && (target) && (hash));
+
+  struct GNUNET_DISK_FileHandle *input = GNUNET_DISK_file_open(
+    source, GNUNET_DISK_OPEN_READ, GNUNET_DISK_PERM_USER_READ
+  );
+
+  if (!input)
+    return GNUNET_SYSERR;
+
+  struct GNUNET_DISK_FileHandle *output = GNUNET_DISK_file_open(
+    target, GNUNET_DISK_OPEN_WRITE | GNUNET_DISK_OPEN_CREATE |
+    GNUNET_DISK_OPEN_TRUNCATE,
+    GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+  );
+
+  if (!output)
+  {
+    GNUNET_DISK_file_close(input);
+    return GNUNET_SYSERR;
+  }
+
+  struct GNUNET_CRYPTO_SymmetricInitializationVector iv;
+  const uint64_t block_size = 1024*1024;
+  ssize_t result = 0;
+
+  struct GNUNET_HashContext *context = GNUNET_CRYPTO_hash_context_start();
+
+  uint8_t *first = GNUNET_malloc(block_size);
+  uint8_t *block = GNUNET_malloc(block_size);
+
+  const ssize_t first_size = read_file_block(input, first, block_size);
+
+  if (first_size < 0)
+  {
+    result = -1;
+    goto cleanup;
+  }
+
+  GNUNET_CRYPTO_hash_context_read(context, first, (size_t) first_size);
+
+  // The first block needs the hash of the whole file for its
+  // initialization vector, so it gets written at the very end.
+  if ((first_size > 0) && 
+      ((off_t) first_size != GNUNET_DISK_file_seek(
+        output, (off_t) first_size, GNUNET_DISK_SEEK_SET)))
+  {
+    result = -1;
+    goto cleanup;
+  }
+
+  memcpy(&iv, first, sizeof(iv));
+
+  struct GNUNET_CRYPTO_SymmetricInitializationVector next;
+  ssize_t size = (first_size == (ssize_t) block_size)? 1 : 0;
+
+  while (size > 0)
+  {
+    size = read_file_block(input, block, block_size);
+
+    if (size <= 0)
+    {
+      result = size;
+      break;
+    }
+
+    GNUNET_CRYPTO_hash_context_read(context, block, (size_t) size);
+    memcpy(&next, block, sizeof(next));
+
+    if ((key) && (0 > GNUNET_CRYPTO_symmetric_encrypt(
+        block, (size_t) size, key, &iv, block)))
+    {
+      result = -1;
+      break;
+    }
+
+    if (size != GNUNET_DISK_file_write(output, block, (size_t) size))
+    {
+      result = -1;
+      break;
+    }
+
+    memcpy(&iv, &next, sizeof(iv));
+  }
+
+cleanup:
+  GNUNET_CRYPTO_hash_context_finish(context, hash);
+
+  if (result < 0)
+    goto close_files;
+
+  if (key)
+    GNUNET_CRYPTO_symmetric_derive_iv(&iv, key, hash, sizeof(hash), NULL);
+
+  if ((key) && (first_size > 0) && (0 > GNUNET_CRYPTO_symmetric_encrypt(
+      first, (size_t) first_size, key, &iv, first)))
+    result = -1;
+  else if ((0 != GNUNET_DISK_file_seek(output, 0, GNUNET_DISK_SEEK_SET)) ||
+           (first_size != GNUNET_DISK_file_write(
+             output, first, (size_t) first_size)))
+    result = -1;
+
+close_files:
+  GNUNET_free(block);
+  GNUNET_free(first);
+
+  if (GNUNET_OK != GNUNET_DISK_file_sync(output))
+    result = -1;
+
+  if (GNUNET_OK != GNUNET_DISK_file_close(output))
+    result = -1;
+
+  GNUNET_DISK_file_close(input);
+
+  if (result < 0)
+    return GNUNET_SYSERR;
+
+  return GNUNET_OK;
+}
+
+struct GNUNET_CHAT_UtilDecryption
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+
+  uint8_t *data;
+  uint64_t size;
+  uint64_t block_size;
+  uint64_t blocks;
+  uint64_t next;
+
+  const struct GNUNET_CRYPTO_SymmetricSessionKey *key;
+  struct GNUNET_CRYPTO_SymmetricInitializationVector *ivs;
+
+  enum GNUNET_GenericReturnValue *done;
+  enum GNUNET_GenericReturnValue failed;
+};
+
+static void*
+decrypt_file_blocks (void *cls)
+{
+  struct GNUNET_CHAT_UtilDecryption *decryption = cls;
+
+  GNUNET_assert(decryption);
+
+  uint64_t index;
+  ssize_t result;
+
+  while (GNUNET_YES)
+  {
+    pthread_mutex_lock(&(decryption->mutex));
+
+    if ((decryption->next >= decryption->blocks) ||
+        (GNUNET_YES == decryption->failed))
+    {
+      pthread_mutex_unlock(&(decryption->mutex));
+      break;
+    }
+
+    index = decryption->next++;
+    pthread_mutex_unlock(&(decryption->mutex));
+
+    const uint64_t offset = decryption->block_size * index;
+    const uint64_t remaining = (decryption->size - offset);
+    void* location = decryption->data + offset;
+
+    result = GNUNET_CRYPTO_symmetric_decrypt(
+      location,
+      remaining >= decryption->block_size? decryption->block_size : remaining,
+      decryption->key,
+      &(decryption->ivs[index]),
+      location
+    );
+
+    pthread_mutex_lock(&(decryption->mutex));
+
+    decryption->done[index] = GNUNET_YES;
+
+    if (result < 0)
+      decryption->failed = GNUNET_YES;
+
+    pthread_cond_broadcast(&(decryption->cond));
+    pthread_mutex_unlock(&(decryption->mutex));
+  }
+
+  return NULL;
+}
+
+static unsigned int
+get_decryption_workers (uint64_t blocks)
+{
+  const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned int workers = maximum_decryption_workers;
+
+  if ((cores > 0) && ((unsigned long) cores < workers))
+    workers = (unsigned int) cores;
+
+  if (blocks < workers)
+    workers = (unsigned int) blocks;
+
+  return workers;
+}
+
 enum GNUNET_GenericReturnValue
 util_decrypt_file (const char *filename,
                    const struct GNUNET_HashCode *hash,
@@ -254,44 +493,123 @@ util_decrypt_file (const char *filename,
     return GNUNET_SYSERR;
   }
 
-  struct GNUNET_CRYPTO_SymmetricInitializationVector iv;
   const uint64_t block_size = 1024*1024;
   struct GNUNET_HashCode check;
   ssize_t result = 0;
 
+  memset(&check, 0, sizeof(check));
+
   const uint64_t blocks = ((size + block_size - 1) / block_size);
 
-  if (!key)
+  if ((!key) || (!blocks))
     goto skip_decryption;
 
-  for (uint64_t index = 0; index < blocks; index++)
-  {
-    const uint64_t offset = block_size * index;
+  struct GNUNET_CHAT_UtilDecryption decryption;
+  decryption.data = data;
+  decryption.size = size;
+  decryption.block_size = block_size;
+  decryption.blocks = blocks;
+  decryption.next = 0;
+  decryption.key = key;
+  decryption.failed = GNUNET_NO;
+
+  decryption.ivs = GNUNET_new_array(
+    blocks, struct GNUNET_CRYPTO_SymmetricInitializationVector
+  );
 
-    const uint64_t remaining = (size - offset);
-    void* location = ((uint8_t*) data) + offset;
+  decryption.done = GNUNET_new_array(
+    blocks, enum GNUNET_GenericReturnValue
+  );
 
-    if (index > 0)
-      memcpy(&iv, ((uint8_t*) data) + (block_size * (index - 1)), sizeof(iv));
-    else
-      GNUNET_CRYPTO_symmetric_derive_iv(&iv, key, hash, sizeof(hash), NULL);
+  GNUNET_CRYPTO_symmetric_derive_iv(
+    &(decryption.ivs[0]), key, hash, sizeof(hash), NULL
+  );
 
+  // Each block uses the start of the previous plaintext block as its
+  // initialization vector. Decrypting just those few bytes upfront
+  // makes all blocks independent of each other.
+  for (uint64_t index = 1; index < blocks; index++)
+  {
     result = GNUNET_CRYPTO_symmetric_decrypt(
-      location,
-      remaining >= block_size? block_size : remaining,
+      ((uint8_t*) data) + (block_size * (index - 1)),
+      sizeof(decryption.ivs[index]),
       key,
-      &iv,
-      location
+      &(decryption.ivs[index - 1]),
+      &(decryption.ivs[index])
     );
 
     if (result < 0)
+      goto free_decryption;
+  }
+
+  pthread_mutex_init(&(decryption.mutex), NULL);
+  pthread_cond_init(&(decryption.cond), NULL);
+
+  const unsigned int workers = get_decryption_workers(blocks);
+  pthread_t *threads = GNUNET_new_array(workers, pthread_t);
+  unsigned int started = 0;
+
+  while ((workers > 1) && (started < workers))
+  {
+    if (0 != pthread_create(&(threads[started]), NULL,
+                            decrypt_file_blocks, &decryption))
+      break;
+
+    started++;
+  }
+
+  if (!started)
+    decrypt_file_blocks(&decryption);
+
+  struct GNUNET_HashContext *context = GNUNET_CRYPTO_hash_context_start();
+
+  for (uint64_t index = 0; index < blocks; index++)
+  {
+    pthread_mutex_lock(&(decryption.mutex));
+
+    while ((GNUNET_YES != decryption.done[index]) &&
+           (GNUNET_YES != decryption.failed))
+      pthread_cond_wait(&(decryption.cond), &(decryption.mutex));
+
+    pthread_mutex_unlock(&(decryption.mutex));
+
+    if (GNUNET_YES == decryption.failed)
       break;
+
+    const uint64_t offset = block_size * index;
+    const uint64_t remaining = (size - offset);
+
+    GNUNET_CRYPTO_hash_context_read(
+      context,
+      ((uint8_t*) data) + offset,
+      remaining >= block_size? block_size : remaining
+    );
   }
 
+  for (unsigned int i = 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+
+  GNUNET_CRYPTO_hash_context_finish(context, &check);
+
+  if (GNUNET_YES == decryption.failed)
+    result = -1;
+
+  GNUNET_free(threads);
+
+  pthread_cond_destroy(&(decryption.cond));
+  pthread_mutex_destroy(&(decryption.mutex));
+
+free_decryption:
+  GNUNET_free(decryption.done);
+  GNUNET_free(decryption.ivs);
+
+  goto check_hash;
+
 skip_decryption:
   GNUNET_CRYPTO_hash(data, size, &check);
 
-  if (0 != GNUNET_CRYPTO_hash_cmp(hash, &check))
+check_hash:
+  if ((result >= 0) && (0 != GNUNET_CRYPTO_hash_cmp(hash, &check)))
     result = -1;
 
   if (GNUNET_OK != GNUNET_DISK_file_unmap(mapping))
@@ -355,6 +673,58 @@ util_get_filename (const char *directory,
   return result;
 }
 
+enum GNUNET_GenericReturnValue
+util_load_stats (const char *directory,
+                 const char *subdir,
+                 const struct GNUNET_HashCode *hash,
+                 void *data,
+                 size_t size)
+{
+  GNUNET_assert((directory) && (subdir) && (hash) && (data));
+
+  char *filename;
+  util_get_filename(directory, subdir, hash, &filename);
+
+  enum GNUNET_GenericReturnValue result = GNUNET_SYSERR;
+
+  if (GNUNET_YES != GNUNET_DISK_file_test_read(filename))
+    goto cleanup;
+
+  if ((ssize_t) size == GNUNET_DISK_fn_read(filename, data, size))
+    result = GNUNET_OK;
+
+cleanup:
+  GNUNET_free(filename);
+  return result;
+}
+
+enum GNUNET_GenericReturnValue
+util_store_stats (const char *directory,
+                  const char *subdir,
+                  const struct GNUNET_HashCode *hash,
+                  const void *data,
+                  size_t size)
+{
+  GNUNET_assert((directory) && (subdir) && (hash) && (data));
+
+  char *filename;
+  util_get_filename(directory, subdir, hash, &filename);
+
+  enum GNUNET_GenericReturnValue result = GNUNET_SYSERR;
+
+  if (GNUNET_OK != GNUNET_DISK_directory_create_for_file(filename))
+    goto cleanup;
+
+  result = GNUNET_DISK_fn_write(
+    filename, data, size,
+    GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+  );
+
+cleanup:
+  GNUNET_free(filename);
+  return result;
+}
+
 char*
 util_get_lower(const char *name)
 {
@@ -122,6 +122,26 @@ util_encrypt_file (const char *filename,
                    const struct GNUNET_HashCode *hash,
                    const struct GNUNET_CRYPTO_SymmetricSessionKey *key);
 
+/**
+ * Reads a file under a given <i>source</i> path in blocks and
+ * writes its encrypted content to a file under a <i>target</i>
+ * path with a selected symmetric <i>key</i> in a single pass.
+ * The <i>hash</i> of the original file gets computed on the
+ * way and the result is the same as using #util_hash_file,
+ * copying the file and calling #util_encrypt_file on the copy.
+ *
+ * @param[in] source Source file name
+ * @param[in] target Target file name
+ * @param[out] hash Hash of source file
+ * @param[in] key Symmetric key or NULL
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+util_hash_encrypt_file (const char *source,
+                        const char *target,
+                        struct GNUNET_HashCode *hash,
+                        const struct GNUNET_CRYPTO_SymmetricSessionKey *key);
+
 /**
  * Decrypts a file inplace under a given <i>filename</i>
  * with a selected symmetric <i>key</i> and its <i>hash</i>
@@ -169,6 +189,44 @@ util_get_filename (const char *directory,
                    const struct GNUNET_HashCode *hash,
                    char **filename);
 
+/**
+ * Loads persisted statistics of a given <i>size</i> stored for
+ * a <i>hash</i> inside of a <i>directory</i> and its
+ * <i>subdir</i> into <i>data</i>.
+ *
+ * @param[in] directory Directory path
+ * @param[in] subdir Subdirectory
+ * @param[in] hash Hash
+ * @param[out] data Statistics data
+ * @param[in] size Size of data
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+util_load_stats (const char *directory,
+                 const char *subdir,
+                 const struct GNUNET_HashCode *hash,
+                 void *data,
+                 size_t size);
+
+/**
+ * Stores statistics <i>data</i> of a given <i>size</i> for a
+ * <i>hash</i> inside of a <i>directory</i> and its <i>subdir</i>
+ * persistently.
+ *
+ * @param[in] directory Directory path
+ * @param[in] subdir Subdirectory
+ * @param[in] hash Hash
+ * @param[in] data Statistics data
+ * @param[in] size Size of data
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+util_store_stats (const char *directory,
+                  const char *subdir,
+                  const struct GNUNET_HashCode *hash,
+                  const void *data,
+                  size_t size);
+
 /**
  * Allocates a new string representing the lower case versionn
  * of a given <i>name</i> to work properly with the EGO naming
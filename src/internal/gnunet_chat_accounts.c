@@ -27,6 +27,7 @@
 #include "../gnunet_chat_handle.h"
 
 #include <gnunet/gnunet_common.h>
+#include <string.h>
 
 struct GNUNET_CHAT_InternalAccounts*
 internal_accounts_create(struct GNUNET_CHAT_Handle *handle,
@@ -48,20 +49,71 @@ internal_accounts_create(struct GNUNET_CHAT_Handle *handle,
   accounts->op = NULL;
   accounts->method = GNUNET_CHAT_ACCOUNT_NONE;
 
+  accounts->queued = GNUNET_NO;
+  accounts->running = GNUNET_NO;
+
+  accounts->name_indexed = GNUNET_NO;
+  accounts->ego_indexed = GNUNET_NO;
+
   GNUNET_CONTAINER_DLL_insert(
     accounts->handle->accounts_head,
     accounts->handle->accounts_tail,
     accounts
   );
 
+  internal_accounts_index(accounts);
   return accounts;
 }
 
+static void
+unindex_accounts (struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert((accounts) && (accounts->handle));
+
+  if (GNUNET_YES == accounts->name_indexed)
+    GNUNET_CONTAINER_multihashmap_remove(
+      accounts->handle->accounts_names,
+      &(accounts->name_hash),
+      accounts
+    );
+
+  if (GNUNET_YES == accounts->ego_indexed)
+    GNUNET_CONTAINER_multihashmap_remove(
+      accounts->handle->accounts_egos,
+      &(accounts->ego_hash),
+      accounts
+    );
+
+  accounts->name_indexed = GNUNET_NO;
+  accounts->ego_indexed = GNUNET_NO;
+}
+
+static void
+release_accounts_method (struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert((accounts) && (accounts->handle));
+
+  if (GNUNET_YES == accounts->queued)
+    internal_accounts_dequeue(accounts);
+
+  if (GNUNET_YES != accounts->running)
+    return;
+
+  GNUNET_assert(accounts->handle->accounts_running > 0);
+
+  accounts->running = GNUNET_NO;
+  accounts->handle->accounts_running--;
+
+  handle_process_accounts(accounts->handle);
+}
+
 void
 internal_accounts_destroy(struct GNUNET_CHAT_InternalAccounts *accounts)
 {
   GNUNET_assert((accounts) && (accounts->handle));
 
+  unindex_accounts(accounts);
+
   GNUNET_CONTAINER_DLL_remove(
     accounts->handle->accounts_head,
     accounts->handle->accounts_tail,
@@ -74,6 +126,10 @@ internal_accounts_destroy(struct GNUNET_CHAT_InternalAccounts *accounts)
   if (accounts->op)
     GNUNET_IDENTITY_cancel(accounts->op);
 
+  accounts->op = NULL;
+
+  release_accounts_method(accounts);
+
   GNUNET_free(accounts);
 }
 
@@ -111,4 +167,240 @@ internal_accounts_stop_method(struct GNUNET_CHAT_InternalAccounts *accounts)
   }
 
   accounts->method = GNUNET_CHAT_ACCOUNT_NONE;
+
+  release_accounts_method(accounts);
+}
+
+void
+internal_accounts_enqueue(struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert(
+    (accounts) &&
+    (accounts->handle) &&
+    (GNUNET_CHAT_ACCOUNT_NONE != accounts->method) &&
+    (GNUNET_YES != accounts->queued) &&
+    (GNUNET_YES != accounts->running)
+  );
+
+  GNUNET_CONTAINER_MDLL_insert_tail(
+    pending,
+    accounts->handle->accounts_pending_head,
+    accounts->handle->accounts_pending_tail,
+    accounts
+  );
+
+  accounts->queued = GNUNET_YES;
+}
+
+void
+internal_accounts_dequeue(struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert((accounts) && (accounts->handle));
+
+  if (GNUNET_YES != accounts->queued)
+    return;
+
+  GNUNET_CONTAINER_MDLL_remove(
+    pending,
+    accounts->handle->accounts_pending_head,
+    accounts->handle->accounts_pending_tail,
+    accounts
+  );
+
+  accounts->queued = GNUNET_NO;
+}
+
+void
+internal_accounts_index(struct GNUNET_CHAT_InternalAccounts *accounts)
+{
+  GNUNET_assert((accounts) && (accounts->handle));
+
+  unindex_accounts(accounts);
+
+  if (!(accounts->account))
+    return;
+
+  const char *name = account_get_name(accounts->account);
+  const struct GNUNET_IDENTITY_Ego *ego = accounts->account->ego;
+
+  if (!name)
+    goto index_ego;
+
+  GNUNET_CRYPTO_hash(name, strlen(name), &(accounts->name_hash));
+
+  if (GNUNET_OK == GNUNET_CONTAINER_multihashmap_put(
+      accounts->handle->accounts_names,
+      &(accounts->name_hash),
+      accounts,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE))
+    accounts->name_indexed = GNUNET_YES;
+
+index_ego:
+  if (!ego)
+    return;
+
+  GNUNET_CRYPTO_hash(&ego, sizeof(ego), &(accounts->ego_hash));
+
+  if (GNUNET_OK == GNUNET_CONTAINER_multihashmap_put(
+      accounts->handle->accounts_egos,
+      &(accounts->ego_hash),
+      accounts,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE))
+    accounts->ego_indexed = GNUNET_YES;
+}
+
+struct GNUNET_CHAT_InternalAccountsSearch
+{
+  const char *name;
+  const struct GNUNET_IDENTITY_Ego *ego;
+  const struct GNUNET_CHAT_Account *account;
+  enum GNUNET_GenericReturnValue skip_op;
+
+  struct GNUNET_CHAT_InternalAccounts *accounts;
+};
+
+static enum GNUNET_GenericReturnValue
+it_find_accounts_by_name (void *cls,
+                          const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalAccountsSearch *search = cls;
+  struct GNUNET_CHAT_InternalAccounts *accounts = value;
+
+  if ((!(accounts->account)) || ((GNUNET_YES == search->skip_op) &&
+      (GNUNET_CHAT_ACCOUNT_NONE != accounts->method)))
+    return GNUNET_YES;
+
+  const char *name = account_get_name(accounts->account);
+
+  if ((!name) || (0 != strcmp(name, search->name)))
+    return GNUNET_YES;
+
+  search->accounts = accounts;
+  return GNUNET_NO;
+}
+
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_name(const struct GNUNET_CHAT_Handle *handle,
+                               const char *name,
+                               enum GNUNET_GenericReturnValue skip_op)
+{
+  GNUNET_assert((handle) && (handle->accounts_names) && (name));
+
+  struct GNUNET_HashCode key;
+  GNUNET_CRYPTO_hash(name, strlen(name), &key);
+
+  struct GNUNET_CHAT_InternalAccountsSearch search;
+  search.name = name;
+  search.ego = NULL;
+  search.account = NULL;
+  search.skip_op = skip_op;
+  search.accounts = NULL;
+
+  GNUNET_CONTAINER_multihashmap_get_multiple(
+    handle->accounts_names,
+    &key,
+    it_find_accounts_by_name,
+    &search
+  );
+
+  return search.accounts;
+}
+
+static enum GNUNET_GenericReturnValue
+it_find_accounts_by_account (void *cls,
+                             const struct GNUNET_HashCode *key,
+                             void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalAccountsSearch *search = cls;
+  struct GNUNET_CHAT_InternalAccounts *accounts = value;
+
+  if (search->account != accounts->account)
+    return GNUNET_YES;
+
+  search->accounts = accounts;
+  return GNUNET_NO;
+}
+
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_account(const struct GNUNET_CHAT_Handle *handle,
+                                  const struct GNUNET_CHAT_Account *account)
+{
+  GNUNET_assert((handle) && (handle->accounts_names) && (account));
+
+  const char *name = account_get_name(account);
+
+  if (!name)
+    return NULL;
+
+  struct GNUNET_HashCode key;
+  GNUNET_CRYPTO_hash(name, strlen(name), &key);
+
+  struct GNUNET_CHAT_InternalAccountsSearch search;
+  search.name = name;
+  search.ego = NULL;
+  search.account = account;
+  search.skip_op = GNUNET_NO;
+  search.accounts = NULL;
+
+  // Multiple accounts may share the same name, so every entry
+  // under the key needs to be compared instead of the first match.
+  GNUNET_CONTAINER_multihashmap_get_multiple(
+    handle->accounts_names,
+    &key,
+    it_find_accounts_by_account,
+    &search
+  );
+
+  return search.accounts;
+}
+
+static enum GNUNET_GenericReturnValue
+it_find_accounts_by_ego (void *cls,
+                         const struct GNUNET_HashCode *key,
+                         void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalAccountsSearch *search = cls;
+  struct GNUNET_CHAT_InternalAccounts *accounts = value;
+
+  if ((!(accounts->account)) || (search->ego != accounts->account->ego))
+    return GNUNET_YES;
+
+  search->accounts = accounts;
+  return GNUNET_NO;
+}
+
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_ego(const struct GNUNET_CHAT_Handle *handle,
+                              const struct GNUNET_IDENTITY_Ego *ego)
+{
+  GNUNET_assert((handle) && (handle->accounts_egos));
+
+  if (!ego)
+    return NULL;
+
+  struct GNUNET_HashCode key;
+  GNUNET_CRYPTO_hash(&ego, sizeof(ego), &key);
+
+  struct GNUNET_CHAT_InternalAccountsSearch search;
+  search.name = NULL;
+  search.ego = ego;
+  search.account = NULL;
+  search.skip_op = GNUNET_NO;
+  search.accounts = NULL;
+
+  GNUNET_CONTAINER_multihashmap_get_multiple(
+    handle->accounts_egos,
+    &key,
+    it_find_accounts_by_ego,
+    &search
+  );
+
+  return search.accounts;
 }
@@ -49,8 +49,20 @@ struct GNUNET_CHAT_InternalAccounts
   struct GNUNET_IDENTITY_Operation *op;
   enum GNUNET_CHAT_AccountMethod method;
 
+  enum GNUNET_GenericReturnValue queued;
+  enum GNUNET_GenericReturnValue running;
+
+  struct GNUNET_HashCode name_hash;
+  struct GNUNET_HashCode ego_hash;
+
+  enum GNUNET_GenericReturnValue name_indexed;
+  enum GNUNET_GenericReturnValue ego_indexed;
+
   struct GNUNET_CHAT_InternalAccounts *next;
   struct GNUNET_CHAT_InternalAccounts *prev;
+
+  struct GNUNET_CHAT_InternalAccounts *next_pending;
+  struct GNUNET_CHAT_InternalAccounts *prev_pending;
 };
 
 /**
@@ -77,7 +89,8 @@ internal_accounts_create(struct GNUNET_CHAT_Handle *handle,
 /**
  * Destroys and frees an internal <i>accounts</i> 
  * resource while implicitly removing it from its 
- * chat handles list of accounts.
+ * chat handles list of accounts, its indices and
+ * its queue of pending operations.
  *
  * @param[out] accounts Internal account resource
  */
@@ -103,9 +116,85 @@ internal_accounts_start_method(struct GNUNET_CHAT_InternalAccounts *accounts,
  * resource to a neutral method state and stops
  * its current operation.
  *
+ * If the operation was running, the chat handle
+ * gets the chance to start its next pending
+ * operation in place of it.
+ *
  * @param[in,out] accounts Internal account resource
  */
 void
 internal_accounts_stop_method(struct GNUNET_CHAT_InternalAccounts *accounts);
 
+/**
+ * Appends a given internal <i>accounts</i>
+ * resource with a selected method to the queue
+ * of pending operations from its chat handle.
+ *
+ * @param[in,out] accounts Internal account resource
+ */
+void
+internal_accounts_enqueue(struct GNUNET_CHAT_InternalAccounts *accounts);
+
+/**
+ * Removes a given internal <i>accounts</i>
+ * resource from the queue of pending operations
+ * from its chat handle.
+ *
+ * @param[in,out] accounts Internal account resource
+ */
+void
+internal_accounts_dequeue(struct GNUNET_CHAT_InternalAccounts *accounts);
+
+/**
+ * Updates the entries of a given internal
+ * <i>accounts</i> resource in the indices of its
+ * chat handle after the name or the ego of its
+ * account has changed.
+ *
+ * @param[in,out] accounts Internal account resource
+ */
+void
+internal_accounts_index(struct GNUNET_CHAT_InternalAccounts *accounts);
+
+/**
+ * Searches for an internal accounts resource of
+ * a given chat <i>handle</i> by the <i>name</i>
+ * of its account.
+ *
+ * @param[in] handle Chat handle
+ * @param[in] name Chat account name
+ * @param[in] skip_op Whether to skip accounts with pending operation
+ * @return Internal account resource or NULL
+ */
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_name(const struct GNUNET_CHAT_Handle *handle,
+                               const char *name,
+                               enum GNUNET_GenericReturnValue skip_op);
+
+/**
+ * Searches for the internal accounts resource of
+ * a given chat <i>handle</i> which holds a specific
+ * chat <i>account</i>.
+ *
+ * @param[in] handle Chat handle
+ * @param[in] account Chat account
+ * @return Internal account resource or NULL
+ */
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_account(const struct GNUNET_CHAT_Handle *handle,
+                                  const struct GNUNET_CHAT_Account *account);
+
+/**
+ * Searches for an internal accounts resource of
+ * a given chat <i>handle</i> by the <i>ego</i>
+ * of its account.
+ *
+ * @param[in] handle Chat handle
+ * @param[in] ego Identity ego
+ * @return Internal account resource or NULL
+ */
+struct GNUNET_CHAT_InternalAccounts*
+internal_accounts_find_by_ego(const struct GNUNET_CHAT_Handle *handle,
+                              const struct GNUNET_IDENTITY_Ego *ego);
+
 #endif /* GNUNET_CHAT_ACCOUNTS_H_ */
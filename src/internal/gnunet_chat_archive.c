@@ -0,0 +1,582 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_archive.c
+ */
+
+#include "gnunet_chat_archive.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_messenger_service.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const unsigned int initial_map_size_of_archive = 8;
+static const size_t max_text_size_of_archive = 4096;
+
+struct GNUNET_CHAT_InternalArchive*
+internal_archive_create (const char *filename)
+{
+  GNUNET_assert(filename);
+
+  struct GNUNET_CHAT_InternalArchive* archive = GNUNET_new(struct GNUNET_CHAT_InternalArchive);
+
+  archive->filename = GNUNET_strdup(filename);
+  archive->file = NULL;
+
+  archive->entries = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_archive, GNUNET_NO);
+  archive->records = 0;
+
+  archive->loaded = GNUNET_NO;
+  return archive;
+}
+
+static void
+clear_archive_entry_msg (struct GNUNET_CHAT_InternalArchiveEntry *entry)
+{
+  GNUNET_assert(entry);
+
+  switch (entry->msg.header.kind)
+  {
+    case GNUNET_MESSENGER_KIND_TEXT:
+      if (entry->msg.body.text.text)
+        GNUNET_free(entry->msg.body.text.text);
+      break;
+    case GNUNET_MESSENGER_KIND_TAG:
+      if (entry->msg.body.tag.tag)
+        GNUNET_free(entry->msg.body.tag.tag);
+      break;
+    default:
+      break;
+  }
+
+  memset(&(entry->msg), 0, sizeof(entry->msg));
+}
+
+static enum GNUNET_GenericReturnValue
+it_destroy_archive_entries (GNUNET_UNUSED void *cls,
+                            GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                            void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_InternalArchiveEntry *entry = value;
+
+  GNUNET_assert(!(entry->message));
+
+  clear_archive_entry_msg(entry);
+  GNUNET_free(entry);
+  return GNUNET_YES;
+}
+
+static const char*
+get_archive_msg_text (const struct GNUNET_MESSENGER_Message *msg)
+{
+  GNUNET_assert(msg);
+
+  const char *text;
+
+  switch (msg->header.kind)
+  {
+    case GNUNET_MESSENGER_KIND_TEXT:
+      text = msg->body.text.text;
+      break;
+    case GNUNET_MESSENGER_KIND_TAG:
+      text = msg->body.tag.tag;
+      break;
+    default:
+      return NULL;
+  }
+
+  if ((!text) || (strlen(text) > max_text_size_of_archive))
+    return NULL;
+
+  return text;
+}
+
+static void*
+encode_archive_record (const struct GNUNET_HashCode *hash,
+                       const struct GNUNET_ShortHashCode *sender,
+                       enum GNUNET_MESSENGER_MessageFlags flags,
+                       const struct GNUNET_MESSENGER_Message *msg,
+                       size_t *size)
+{
+  GNUNET_assert((hash) && (msg) && (size));
+
+  const struct GNUNET_HashCode *target = NULL;
+  const char *text = get_archive_msg_text(msg);
+
+  switch (msg->header.kind)
+  {
+    case GNUNET_MESSENGER_KIND_TEXT:
+      break;
+    case GNUNET_MESSENGER_KIND_TAG:
+      target = &(msg->body.tag.hash);
+      break;
+    case GNUNET_MESSENGER_KIND_DELETION:
+      target = &(msg->body.deletion.hash);
+      break;
+    default:
+      return NULL;
+  }
+
+  const size_t text_size = text? strlen(text) : 0;
+
+  struct GNUNET_CHAT_InternalArchiveRecord *record = GNUNET_malloc(
+    sizeof(*record) + text_size
+  );
+
+  GNUNET_memcpy(&(record->hash), hash, sizeof(record->hash));
+
+  if (target)
+    GNUNET_memcpy(&(record->target), target, sizeof(record->target));
+  else
+    memset(&(record->target), 0, sizeof(record->target));
+
+  if (sender)
+    GNUNET_memcpy(&(record->sender), sender, sizeof(record->sender));
+  else
+    memset(&(record->sender), 0, sizeof(record->sender));
+
+  record->timestamp = msg->header.timestamp;
+  record->kind = htonl((uint32_t) msg->header.kind);
+  record->flags = htonl((uint32_t) flags);
+  record->text_size = htonl((uint32_t) text_size);
+
+  if (text_size)
+    GNUNET_memcpy(record + 1, text, text_size);
+
+  *size = sizeof(*record) + text_size;
+  return record;
+}
+
+static void
+apply_archive_record (struct GNUNET_CHAT_InternalArchive *archive,
+                      const struct GNUNET_CHAT_InternalArchiveRecord *record,
+                      const char *text)
+{
+  GNUNET_assert((archive) && (record));
+
+  struct GNUNET_CHAT_InternalArchiveEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(
+    archive->entries, &(record->hash)
+  );
+
+  if (!entry)
+  {
+    entry = GNUNET_new(struct GNUNET_CHAT_InternalArchiveEntry);
+
+    GNUNET_memcpy(&(entry->hash), &(record->hash), sizeof(entry->hash));
+    entry->message = NULL;
+
+    if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+        archive->entries, &(entry->hash), entry,
+        GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+    {
+      GNUNET_free(entry);
+      return;
+    }
+  }
+  else if (entry->message)
+  {
+    // The message of the entry refers to its msg and might have been
+    // passed to the application already, so only the flags get updated.
+    entry->flags = (enum GNUNET_MESSENGER_MessageFlags) ntohl(record->flags);
+    return;
+  }
+  else
+    clear_archive_entry_msg(entry);
+
+  GNUNET_memcpy(&(entry->sender), &(record->sender), sizeof(entry->sender));
+  entry->flags = (enum GNUNET_MESSENGER_MessageFlags) ntohl(record->flags);
+
+  const size_t text_size = ntohl(record->text_size);
+
+  entry->msg.header.kind = (enum GNUNET_MESSENGER_MessageKind) ntohl(record->kind);
+  entry->msg.header.timestamp = record->timestamp;
+
+  switch (entry->msg.header.kind)
+  {
+    case GNUNET_MESSENGER_KIND_TEXT:
+      entry->msg.body.text.text = text_size? GNUNET_strndup(text, text_size) : NULL;
+      break;
+    case GNUNET_MESSENGER_KIND_TAG:
+      GNUNET_memcpy(&(entry->msg.body.tag.hash), &(record->target),
+                    sizeof(entry->msg.body.tag.hash));
+      entry->msg.body.tag.tag = text_size? GNUNET_strndup(text, text_size) : NULL;
+      break;
+    case GNUNET_MESSENGER_KIND_DELETION:
+      GNUNET_memcpy(&(entry->msg.body.deletion.hash), &(record->target),
+                    sizeof(entry->msg.body.deletion.hash));
+      break;
+    default:
+      break;
+  }
+}
+
+struct GNUNET_CHAT_InternalArchiveCompact
+{
+  struct GNUNET_DISK_FileHandle *file;
+  enum GNUNET_GenericReturnValue result;
+};
+
+static enum GNUNET_GenericReturnValue
+it_compact_archive_entries (void *cls,
+                            GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                            void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalArchiveCompact *compact = cls;
+  const struct GNUNET_CHAT_InternalArchiveEntry *entry = value;
+
+  if (entry->flags & GNUNET_MESSENGER_FLAG_DELETE)
+    return GNUNET_YES;
+
+  size_t size;
+  void *record = encode_archive_record(
+    &(entry->hash), &(entry->sender), entry->flags, &(entry->msg), &size
+  );
+
+  if (!record)
+    return GNUNET_YES;
+
+  if ((ssize_t) size != GNUNET_DISK_file_write(compact->file, record, size))
+    compact->result = GNUNET_SYSERR;
+
+  GNUNET_free(record);
+  return (GNUNET_OK == compact->result? GNUNET_YES : GNUNET_NO);
+}
+
+static enum GNUNET_GenericReturnValue
+it_count_archive_entries (void *cls,
+                          GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  unsigned int *live = cls;
+  const struct GNUNET_CHAT_InternalArchiveEntry *entry = value;
+
+  if (0 == (entry->flags & GNUNET_MESSENGER_FLAG_DELETE))
+    (*live)++;
+
+  return GNUNET_YES;
+}
+
+static void
+compact_archive_file (struct GNUNET_CHAT_InternalArchive *archive)
+{
+  GNUNET_assert(archive);
+
+  unsigned int live = 0;
+  GNUNET_CONTAINER_multihashmap_iterate(
+    archive->entries, it_count_archive_entries, &live
+  );
+
+  if (archive->records <= live * 2)
+    return;
+
+  char *compacted;
+  GNUNET_asprintf(&compacted, "%s.tmp", archive->filename);
+
+  struct GNUNET_CHAT_InternalArchiveCompact compact;
+  compact.file = GNUNET_DISK_file_open(
+    compacted,
+    GNUNET_DISK_OPEN_WRITE | GNUNET_DISK_OPEN_CREATE | GNUNET_DISK_OPEN_TRUNCATE,
+    GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+  );
+
+  compact.result = GNUNET_OK;
+
+  if (!(compact.file))
+    goto free_filename;
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    archive->entries, it_compact_archive_entries, &compact
+  );
+
+  GNUNET_DISK_file_close(compact.file);
+
+  if ((GNUNET_OK != compact.result) ||
+      (0 != rename(compacted, archive->filename)))
+    remove(compacted);
+
+free_filename:
+  GNUNET_free(compacted);
+}
+
+void
+internal_archive_destroy (struct GNUNET_CHAT_InternalArchive *archive)
+{
+  GNUNET_assert(
+    (archive) &&
+    (archive->filename) &&
+    (archive->entries)
+  );
+
+  if (archive->file)
+    GNUNET_DISK_file_close(archive->file);
+
+  if (GNUNET_YES == archive->loaded)
+    compact_archive_file(archive);
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    archive->entries, it_destroy_archive_entries, NULL
+  );
+
+  GNUNET_CONTAINER_multihashmap_destroy(archive->entries);
+  GNUNET_free(archive->filename);
+
+  GNUNET_free(archive);
+}
+
+enum GNUNET_GenericReturnValue
+internal_archive_load (struct GNUNET_CHAT_InternalArchive *archive)
+{
+  GNUNET_assert((archive) && (archive->filename));
+
+  if (GNUNET_YES == archive->loaded)
+    return GNUNET_OK;
+
+  archive->loaded = GNUNET_YES;
+  archive->records = 0;
+
+  if (GNUNET_YES != GNUNET_DISK_file_test_read(archive->filename))
+    return GNUNET_OK;
+
+  uint64_t size;
+  if (GNUNET_OK != GNUNET_DISK_file_size(archive->filename, &size,
+                                         GNUNET_NO, GNUNET_YES))
+    return GNUNET_SYSERR;
+
+  if (!size)
+    return GNUNET_OK;
+
+  struct GNUNET_DISK_FileHandle *file = GNUNET_DISK_file_open(
+    archive->filename, GNUNET_DISK_OPEN_READ, GNUNET_DISK_PERM_USER_READ
+  );
+
+  if (!file)
+    return GNUNET_SYSERR;
+
+  enum GNUNET_GenericReturnValue result = GNUNET_SYSERR;
+
+  struct GNUNET_DISK_MapHandle *map;
+  const char *data = GNUNET_DISK_file_map(
+    file, &map, GNUNET_DISK_MAP_TYPE_READ, (size_t) size
+  );
+
+  if (!data)
+    goto close_file;
+
+  const struct GNUNET_CHAT_InternalArchiveRecord *record;
+  size_t offset = 0;
+
+  while (offset + sizeof(*record) <= size)
+  {
+    record = (const struct GNUNET_CHAT_InternalArchiveRecord*) (data + offset);
+
+    const size_t text_size = ntohl(record->text_size);
+
+    if ((text_size > max_text_size_of_archive) ||
+        (offset + sizeof(*record) + text_size > size))
+      break;
+
+    apply_archive_record(archive, record, (const char*) (record + 1));
+    archive->records++;
+
+    offset += sizeof(*record) + text_size;
+  }
+
+  GNUNET_DISK_file_unmap(map);
+  result = GNUNET_OK;
+
+close_file:
+  GNUNET_DISK_file_close(file);
+  return result;
+}
+
+static enum GNUNET_GenericReturnValue
+is_archive_entry_current (const struct GNUNET_CHAT_InternalArchiveEntry *entry,
+                          enum GNUNET_MESSENGER_MessageFlags flags,
+                          const struct GNUNET_MESSENGER_Message *msg)
+{
+  GNUNET_assert((entry) && (msg));
+
+  if ((entry->msg.header.kind != msg->header.kind) ||
+      ((entry->flags & GNUNET_MESSENGER_FLAG_DELETE) !=
+       (flags & GNUNET_MESSENGER_FLAG_DELETE)))
+    return GNUNET_NO;
+
+  const char *entry_text = get_archive_msg_text(&(entry->msg));
+  const char *text = get_archive_msg_text(msg);
+
+  if ((!entry_text) || (!text))
+    return (entry_text == text? GNUNET_YES : GNUNET_NO);
+
+  return (0 == strcmp(entry_text, text)? GNUNET_YES : GNUNET_NO);
+}
+
+enum GNUNET_GenericReturnValue
+internal_archive_append (struct GNUNET_CHAT_InternalArchive *archive,
+                         const struct GNUNET_HashCode *hash,
+                         const struct GNUNET_ShortHashCode *sender,
+                         enum GNUNET_MESSENGER_MessageFlags flags,
+                         const struct GNUNET_MESSENGER_Message *msg)
+{
+  GNUNET_assert((archive) && (hash) && (msg));
+
+  if (GNUNET_OK != internal_archive_load(archive))
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalArchiveEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(archive->entries, hash);
+
+  if ((entry) && (GNUNET_YES == is_archive_entry_current(entry, flags, msg)))
+    return GNUNET_NO;
+
+  size_t size;
+  struct GNUNET_CHAT_InternalArchiveRecord *record = encode_archive_record(
+    hash, sender, flags, msg, &size
+  );
+
+  if (!record)
+    return GNUNET_NO;
+
+  enum GNUNET_GenericReturnValue result = GNUNET_SYSERR;
+
+  if ((!(archive->file)) &&
+      (GNUNET_OK == GNUNET_DISK_directory_create_for_file(archive->filename)))
+    archive->file = GNUNET_DISK_file_open(
+      archive->filename,
+      GNUNET_DISK_OPEN_WRITE | GNUNET_DISK_OPEN_CREATE | GNUNET_DISK_OPEN_APPEND,
+      GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+    );
+
+  if ((!(archive->file)) ||
+      ((ssize_t) size != GNUNET_DISK_file_write(archive->file, record, size)))
+    goto free_record;
+
+  apply_archive_record(archive, record, (const char*) (record + 1));
+  archive->records++;
+
+  result = GNUNET_OK;
+
+free_record:
+  GNUNET_free(record);
+  return result;
+}
+
+struct GNUNET_CHAT_InternalArchiveCollect
+{
+  struct GNUNET_CHAT_InternalArchiveEntry **entries;
+  unsigned int count;
+};
+
+static enum GNUNET_GenericReturnValue
+it_collect_archive_entries (void *cls,
+                            GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                            void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalArchiveCollect *collect = cls;
+  collect->entries[collect->count++] = value;
+  return GNUNET_YES;
+}
+
+static int
+compare_archive_entries (const void *a,
+                         const void *b)
+{
+  const struct GNUNET_CHAT_InternalArchiveEntry *entry_a = *(
+    (const struct GNUNET_CHAT_InternalArchiveEntry**) a
+  );
+
+  const struct GNUNET_CHAT_InternalArchiveEntry *entry_b = *(
+    (const struct GNUNET_CHAT_InternalArchiveEntry**) b
+  );
+
+  const uint64_t timestamp_a = GNUNET_TIME_absolute_ntoh(
+    entry_a->msg.header.timestamp
+  ).abs_value_us;
+
+  const uint64_t timestamp_b = GNUNET_TIME_absolute_ntoh(
+    entry_b->msg.header.timestamp
+  ).abs_value_us;
+
+  if (timestamp_a < timestamp_b)
+    return -1;
+  else if (timestamp_a > timestamp_b)
+    return 1;
+
+  return GNUNET_CRYPTO_hash_cmp(&(entry_a->hash), &(entry_b->hash));
+}
+
+int
+internal_archive_iterate (const struct GNUNET_CHAT_InternalArchive *archive,
+                          GNUNET_CHAT_ArchiveCallback cb,
+                          void *cls)
+{
+  GNUNET_assert((archive) && (archive->entries));
+
+  const unsigned int size = GNUNET_CONTAINER_multihashmap_size(
+    archive->entries
+  );
+
+  if (!size)
+    return 0;
+
+  struct GNUNET_CHAT_InternalArchiveCollect collect;
+  collect.entries = GNUNET_new_array(
+    size, struct GNUNET_CHAT_InternalArchiveEntry*
+  );
+
+  collect.count = 0;
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    archive->entries, it_collect_archive_entries, &collect
+  );
+
+  qsort(
+    collect.entries,
+    collect.count,
+    sizeof(*(collect.entries)),
+    compare_archive_entries
+  );
+
+  int result = 0;
+
+  for (unsigned int i = 0; i < collect.count; i++)
+  {
+    result++;
+
+    if ((cb) && (GNUNET_YES != cb(cls, collect.entries[i])))
+      break;
+  }
+
+  GNUNET_free(collect.entries);
+  return result;
+}
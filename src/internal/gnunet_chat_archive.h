@@ -0,0 +1,142 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_archive.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_ARCHIVE_H_
+#define GNUNET_CHAT_INTERNAL_ARCHIVE_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_messenger_service.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_Message;
+
+GNUNET_NETWORK_STRUCT_BEGIN
+
+struct GNUNET_CHAT_InternalArchiveRecord
+{
+  struct GNUNET_HashCode hash;
+  struct GNUNET_HashCode target;
+  struct GNUNET_ShortHashCode sender;
+  struct GNUNET_TIME_AbsoluteNBO timestamp;
+  uint32_t kind GNUNET_PACKED;
+  uint32_t flags GNUNET_PACKED;
+  uint32_t text_size GNUNET_PACKED;
+};
+
+GNUNET_NETWORK_STRUCT_END
+
+struct GNUNET_CHAT_InternalArchiveEntry
+{
+  struct GNUNET_HashCode hash;
+  struct GNUNET_ShortHashCode sender;
+  enum GNUNET_MESSENGER_MessageFlags flags;
+
+  struct GNUNET_MESSENGER_Message msg;
+  struct GNUNET_CHAT_Message *message;
+};
+
+struct GNUNET_CHAT_InternalArchive
+{
+  char *filename;
+  struct GNUNET_DISK_FileHandle *file;
+
+  struct GNUNET_CONTAINER_MultiHashMap *entries;
+  unsigned int records;
+
+  enum GNUNET_GenericReturnValue loaded;
+};
+
+typedef enum GNUNET_GenericReturnValue
+(*GNUNET_CHAT_ArchiveCallback) (void *cls,
+                                struct GNUNET_CHAT_InternalArchiveEntry *entry);
+
+/**
+ * Creates an archive structure to cache the metadata of
+ * messages in an append-only file with a given
+ * <i>filename</i>. The file gets only read once the
+ * archive is loaded.
+ *
+ * @param[in] filename Path of the archive file
+ * @return New chat archive
+ */
+struct GNUNET_CHAT_InternalArchive*
+internal_archive_create (const char *filename);
+
+/**
+ * Destroys an <i>archive</i> structure to cache the metadata
+ * of messages. The file gets compacted if it contains more
+ * outdated records than current ones.
+ *
+ * @param[out] archive Chat archive
+ */
+void
+internal_archive_destroy (struct GNUNET_CHAT_InternalArchive *archive);
+
+/**
+ * Loads all records from the file of a selected <i>archive</i>
+ * structure into its index unless it has been loaded before.
+ *
+ * @param[in,out] archive Chat archive
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_archive_load (struct GNUNET_CHAT_InternalArchive *archive);
+
+/**
+ * Appends a record of a messenger message <i>msg</i> with its
+ * <i>hash</i>, <i>flags</i> and the shorthash of its <i>sender</i>
+ * to the file of a selected <i>archive</i> structure. Only kinds
+ * of messages relevant to render a chat history get archived.
+ *
+ * @param[in,out] archive Chat archive
+ * @param[in] hash Message hash
+ * @param[in] sender Shorthash of the sender or NULL
+ * @param[in] flags Message flags
+ * @param[in] msg Messenger message
+ * @return #GNUNET_OK on success, #GNUNET_NO if the message does not
+ *   get archived and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_archive_append (struct GNUNET_CHAT_InternalArchive *archive,
+                         const struct GNUNET_HashCode *hash,
+                         const struct GNUNET_ShortHashCode *sender,
+                         enum GNUNET_MESSENGER_MessageFlags flags,
+                         const struct GNUNET_MESSENGER_Message *msg);
+
+/**
+ * Iterates through the loaded entries of a selected <i>archive</i>
+ * structure ordered by their timestamp forwarding them to a custom
+ * callback with its closure.
+ *
+ * @param[in] archive Chat archive
+ * @param[in] cb Callback for iteration
+ * @param[in,out] cls Closure for iteration
+ * @return Amount of entries iterated or #GNUNET_SYSERR on error
+ */
+int
+internal_archive_iterate (const struct GNUNET_CHAT_InternalArchive *archive,
+                          GNUNET_CHAT_ArchiveCallback cb,
+                          void *cls);
+
+#endif /* GNUNET_CHAT_INTERNAL_ARCHIVE_H_ */
@@ -0,0 +1,328 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_backfill.c
+ */
+
+#include "gnunet_chat_backfill.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+static const unsigned int initial_map_size_of_backfill = 8;
+
+struct GNUNET_CHAT_InternalBackfill*
+internal_backfill_create (unsigned int initial_size,
+                          unsigned int limit,
+                          unsigned int attempts,
+                          struct GNUNET_TIME_Relative timeout,
+                          GNUNET_CHAT_BackfillCallback cb,
+                          void *cls)
+{
+  GNUNET_assert((limit > 0) && (attempts > 0) && (cb));
+
+  struct GNUNET_CHAT_InternalBackfill* backfill = GNUNET_new(struct GNUNET_CHAT_InternalBackfill);
+
+  if (initial_size < initial_map_size_of_backfill)
+    initial_size = initial_map_size_of_backfill;
+
+  backfill->requests = GNUNET_CONTAINER_multihashmap_create(
+    initial_size, GNUNET_NO);
+  backfill->queue = GNUNET_CONTAINER_heap_create(
+    GNUNET_CONTAINER_HEAP_ORDER_MAX);
+
+  backfill->head = NULL;
+  backfill->tail = NULL;
+  backfill->outstanding = 0;
+
+  backfill->limit = limit;
+  backfill->attempts = attempts;
+  backfill->timeout = timeout;
+
+  backfill->cb = cb;
+  backfill->cls = cls;
+
+  backfill->task = NULL;
+  backfill->immediate = GNUNET_NO;
+
+  backfill->completed = 0;
+  backfill->expired = 0;
+
+  return backfill;
+}
+
+void
+internal_backfill_destroy (struct GNUNET_CHAT_InternalBackfill *backfill)
+{
+  GNUNET_assert(
+    (backfill) &&
+    (backfill->requests) &&
+    (backfill->queue)
+  );
+
+  internal_backfill_clear(backfill);
+
+  GNUNET_CONTAINER_heap_destroy(backfill->queue);
+  GNUNET_CONTAINER_multihashmap_destroy(backfill->requests);
+
+  GNUNET_free(backfill);
+}
+
+static void
+task_backfill_requests (void *cls);
+
+static void
+schedule_backfill_task (struct GNUNET_CHAT_InternalBackfill *backfill)
+{
+  GNUNET_assert(backfill);
+
+  enum GNUNET_GenericReturnValue immediate = GNUNET_NO;
+
+  if ((backfill->outstanding < backfill->limit) &&
+      (GNUNET_CONTAINER_heap_get_size(backfill->queue) > 0))
+    immediate = GNUNET_YES;
+
+  if (backfill->task)
+  {
+    if ((GNUNET_YES != immediate) || (GNUNET_YES == backfill->immediate))
+      return;
+
+    GNUNET_SCHEDULER_cancel(backfill->task);
+    backfill->task = NULL;
+  }
+
+  backfill->immediate = immediate;
+
+  if (GNUNET_YES == immediate)
+    backfill->task = GNUNET_SCHEDULER_add_with_priority(
+      GNUNET_SCHEDULER_PRIORITY_BACKGROUND,
+      task_backfill_requests,
+      backfill
+    );
+  else if (backfill->head)
+    backfill->task = GNUNET_SCHEDULER_add_at(
+      GNUNET_TIME_absolute_add(backfill->head->sent, backfill->timeout),
+      task_backfill_requests,
+      backfill
+    );
+}
+
+static void
+remove_outstanding_request (struct GNUNET_CHAT_InternalBackfill *backfill,
+                            struct GNUNET_CHAT_InternalBackfillRequest *request)
+{
+  GNUNET_assert((backfill) && (request) && (!(request->node)));
+
+  GNUNET_CONTAINER_DLL_remove(
+    backfill->head,
+    backfill->tail,
+    request
+  );
+
+  backfill->outstanding--;
+
+  GNUNET_CONTAINER_multihashmap_remove(
+    backfill->requests, &(request->hash), request
+  );
+
+  GNUNET_free(request);
+}
+
+static void
+task_backfill_requests (void *cls)
+{
+  struct GNUNET_CHAT_InternalBackfill *backfill = cls;
+
+  GNUNET_assert(backfill);
+
+  backfill->task = NULL;
+
+  struct GNUNET_CHAT_InternalBackfillRequest *request;
+  while ((backfill->head) && (GNUNET_TIME_absolute_is_past(
+      GNUNET_TIME_absolute_add(backfill->head->sent, backfill->timeout))))
+  {
+    request = backfill->head;
+
+    if (request->attempts >= backfill->attempts)
+    {
+      backfill->expired++;
+      remove_outstanding_request(backfill, request);
+      continue;
+    }
+
+    // Requests without an answer might have been lost on the way,
+    // so they get queued again until all attempts are used up.
+    GNUNET_CONTAINER_DLL_remove(
+      backfill->head,
+      backfill->tail,
+      request
+    );
+
+    backfill->outstanding--;
+
+    request->node = GNUNET_CONTAINER_heap_insert(
+      backfill->queue, request, request->timestamp.abs_value_us
+    );
+  }
+
+  while ((backfill->outstanding < backfill->limit) &&
+         (GNUNET_CONTAINER_heap_get_size(backfill->queue) > 0))
+  {
+    request = GNUNET_CONTAINER_heap_remove_root(backfill->queue);
+    request->node = NULL;
+    request->sent = GNUNET_TIME_absolute_get();
+    request->attempts++;
+
+    GNUNET_CONTAINER_DLL_insert_tail(
+      backfill->head,
+      backfill->tail,
+      request
+    );
+
+    backfill->outstanding++;
+    backfill->cb(backfill->cls, &(request->hash));
+  }
+
+  schedule_backfill_task(backfill);
+}
+
+void
+internal_backfill_request (struct GNUNET_CHAT_InternalBackfill *backfill,
+                           const struct GNUNET_HashCode *hash,
+                           struct GNUNET_TIME_Absolute timestamp)
+{
+  GNUNET_assert((backfill) && (hash));
+
+  struct GNUNET_CHAT_InternalBackfillRequest *request;
+  request = GNUNET_CONTAINER_multihashmap_get(backfill->requests, hash);
+
+  if (request)
+  {
+    if ((!(request->node)) ||
+        (request->timestamp.abs_value_us >= timestamp.abs_value_us))
+      return;
+
+    request->timestamp = timestamp;
+
+    GNUNET_CONTAINER_heap_update_cost(
+      request->node, timestamp.abs_value_us
+    );
+
+    return;
+  }
+
+  request = GNUNET_new(struct GNUNET_CHAT_InternalBackfillRequest);
+
+  GNUNET_memcpy(&(request->hash), hash, sizeof(request->hash));
+  request->timestamp = timestamp;
+  request->attempts = 0;
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      backfill->requests, hash, request,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    GNUNET_free(request);
+    return;
+  }
+
+  request->node = GNUNET_CONTAINER_heap_insert(
+    backfill->queue, request, timestamp.abs_value_us
+  );
+
+  schedule_backfill_task(backfill);
+}
+
+enum GNUNET_GenericReturnValue
+internal_backfill_complete (struct GNUNET_CHAT_InternalBackfill *backfill,
+                            const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((backfill) && (hash));
+
+  struct GNUNET_CHAT_InternalBackfillRequest *request;
+  request = GNUNET_CONTAINER_multihashmap_get(backfill->requests, hash);
+
+  if (!request)
+    return GNUNET_NO;
+
+  backfill->completed++;
+
+  if (request->node)
+  {
+    GNUNET_CONTAINER_heap_remove_node(request->node);
+
+    GNUNET_CONTAINER_multihashmap_remove(
+      backfill->requests, hash, request
+    );
+
+    GNUNET_free(request);
+    return GNUNET_YES;
+  }
+
+  remove_outstanding_request(backfill, request);
+  schedule_backfill_task(backfill);
+  return GNUNET_YES;
+}
+
+void
+internal_backfill_clear (struct GNUNET_CHAT_InternalBackfill *backfill)
+{
+  GNUNET_assert(backfill);
+
+  if (backfill->task)
+  {
+    GNUNET_SCHEDULER_cancel(backfill->task);
+    backfill->task = NULL;
+  }
+
+  struct GNUNET_CHAT_InternalBackfillRequest *request;
+  while (GNUNET_CONTAINER_heap_get_size(backfill->queue) > 0)
+  {
+    request = GNUNET_CONTAINER_heap_remove_root(backfill->queue);
+    GNUNET_free(request);
+  }
+
+  while (backfill->head)
+  {
+    request = backfill->head;
+
+    GNUNET_CONTAINER_DLL_remove(
+      backfill->head,
+      backfill->tail,
+      request
+    );
+
+    GNUNET_free(request);
+  }
+
+  backfill->outstanding = 0;
+
+  GNUNET_CONTAINER_multihashmap_clear(backfill->requests);
+}
+
+unsigned int
+internal_backfill_size (const struct GNUNET_CHAT_InternalBackfill *backfill)
+{
+  GNUNET_assert(backfill);
+
+  return GNUNET_CONTAINER_multihashmap_size(backfill->requests);
+}
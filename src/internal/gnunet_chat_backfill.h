@@ -0,0 +1,151 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_backfill.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_BACKFILL_H_
+#define GNUNET_CHAT_INTERNAL_BACKFILL_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+typedef void
+(*GNUNET_CHAT_BackfillCallback) (void *cls,
+                                 const struct GNUNET_HashCode *hash);
+
+struct GNUNET_CHAT_InternalBackfillRequest
+{
+  struct GNUNET_HashCode hash;
+  struct GNUNET_TIME_Absolute timestamp;
+  struct GNUNET_TIME_Absolute sent;
+  unsigned int attempts;
+
+  struct GNUNET_CONTAINER_HeapNode *node;
+
+  struct GNUNET_CHAT_InternalBackfillRequest *next;
+  struct GNUNET_CHAT_InternalBackfillRequest *prev;
+};
+
+struct GNUNET_CHAT_InternalBackfill
+{
+  struct GNUNET_CONTAINER_MultiHashMap *requests;
+  struct GNUNET_CONTAINER_Heap *queue;
+
+  struct GNUNET_CHAT_InternalBackfillRequest *head;
+  struct GNUNET_CHAT_InternalBackfillRequest *tail;
+  unsigned int outstanding;
+
+  unsigned int limit;
+  unsigned int attempts;
+  struct GNUNET_TIME_Relative timeout;
+
+  GNUNET_CHAT_BackfillCallback cb;
+  void *cls;
+
+  struct GNUNET_SCHEDULER_Task *task;
+  enum GNUNET_GenericReturnValue immediate;
+
+  unsigned long long completed;
+  unsigned long long expired;
+};
+
+/**
+ * Creates a backfill structure to request missing messages
+ * of a room newest first. At most <i>limit</i> requests are
+ * outstanding at the same time and requests without an answer
+ * after a given <i>timeout</i> get queued again until they
+ * were sent a maximum amount of <i>attempts</i>.
+ *
+ * @param[in] initial_size Expected amount of missing messages
+ * @param[in] limit Maximum amount of outstanding requests
+ * @param[in] attempts Maximum amount of attempts per request
+ * @param[in] timeout Timeout of outstanding requests
+ * @param[in] cb Callback to request a missing message
+ * @param[in,out] cls Closure for the callback
+ * @return New chat backfill
+ */
+struct GNUNET_CHAT_InternalBackfill*
+internal_backfill_create (unsigned int initial_size,
+                          unsigned int limit,
+                          unsigned int attempts,
+                          struct GNUNET_TIME_Relative timeout,
+                          GNUNET_CHAT_BackfillCallback cb,
+                          void *cls);
+
+/**
+ * Destroys a <i>backfill</i> structure and drops all of its
+ * requests.
+ *
+ * @param[out] backfill Chat backfill
+ */
+void
+internal_backfill_destroy (struct GNUNET_CHAT_InternalBackfill *backfill);
+
+/**
+ * Queues a request for a missing message with a given <i>hash</i>
+ * in a selected <i>backfill</i> structure. The <i>timestamp</i> of
+ * the message referring to it decides the order of requests, so
+ * newer gaps in the history get filled first.
+ *
+ * @param[in,out] backfill Chat backfill
+ * @param[in] hash Hash of the missing message
+ * @param[in] timestamp Timestamp of the referring message
+ */
+void
+internal_backfill_request (struct GNUNET_CHAT_InternalBackfill *backfill,
+                           const struct GNUNET_HashCode *hash,
+                           struct GNUNET_TIME_Absolute timestamp);
+
+/**
+ * Marks a message with a given <i>hash</i> as received in a
+ * selected <i>backfill</i> structure, so its request gets
+ * completed.
+ *
+ * @param[in,out] backfill Chat backfill
+ * @param[in] hash Hash of the received message
+ * @return #GNUNET_YES if the message was requested, otherwise #GNUNET_NO
+ */
+enum GNUNET_GenericReturnValue
+internal_backfill_complete (struct GNUNET_CHAT_InternalBackfill *backfill,
+                            const struct GNUNET_HashCode *hash);
+
+/**
+ * Drops all requests from a selected <i>backfill</i> structure.
+ *
+ * @param[in,out] backfill Chat backfill
+ */
+void
+internal_backfill_clear (struct GNUNET_CHAT_InternalBackfill *backfill);
+
+/**
+ * Returns the amount of missing messages in a selected
+ * <i>backfill</i> structure which are queued or requested.
+ *
+ * @param[in] backfill Chat backfill
+ * @return Amount of missing messages
+ */
+unsigned int
+internal_backfill_size (const struct GNUNET_CHAT_InternalBackfill *backfill);
+
+#endif /* GNUNET_CHAT_INTERNAL_BACKFILL_H_ */
@@ -0,0 +1,280 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_block_reader.c
+ */
+
+#include "gnunet_chat_block_reader.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const uint64_t block_size_of_reader = 1024*1024;
+
+struct GNUNET_CHAT_InternalBlockReader*
+internal_block_reader_create (const char *filename,
+                              const struct GNUNET_HashCode *hash,
+                              const struct GNUNET_CRYPTO_SymmetricSessionKey *key)
+{
+  GNUNET_assert((filename) && (hash));
+
+  uint64_t size;
+
+  if (GNUNET_OK != GNUNET_DISK_file_size(filename, &size, GNUNET_NO, GNUNET_YES))
+    return NULL;
+
+  struct GNUNET_DISK_FileHandle *file = GNUNET_DISK_file_open(
+    filename, GNUNET_DISK_OPEN_READ, GNUNET_DISK_PERM_USER_READ
+  );
+
+  if (!file)
+    return NULL;
+
+  struct GNUNET_CHAT_InternalBlockReader* reader = GNUNET_new(struct GNUNET_CHAT_InternalBlockReader);
+
+  reader->file = file;
+  reader->size = size;
+
+  GNUNET_memcpy(&(reader->hash), hash, sizeof(reader->hash));
+
+  if (key)
+  {
+    GNUNET_memcpy(&(reader->key), key, sizeof(reader->key));
+    reader->encrypted = GNUNET_YES;
+  }
+  else
+    reader->encrypted = GNUNET_NO;
+
+  reader->ivs = NULL;
+  reader->ivs_count = 0;
+  reader->ivs_size = 0;
+
+  memset(reader->blocks, 0, sizeof(reader->blocks));
+  reader->usage = 0;
+
+  return reader;
+}
+
+void
+internal_block_reader_destroy (struct GNUNET_CHAT_InternalBlockReader *reader)
+{
+  GNUNET_assert((reader) && (reader->file));
+
+  for (unsigned int i = 0; i < GNUNET_CHAT_INTERNAL_BLOCK_READER_CACHE; i++)
+    if (reader->blocks[i].data)
+      GNUNET_free(reader->blocks[i].data);
+
+  if (reader->ivs)
+    GNUNET_array_grow(reader->ivs, reader->ivs_size, 0);
+
+  GNUNET_DISK_file_close(reader->file);
+  GNUNET_free(reader);
+}
+
+static enum GNUNET_GenericReturnValue
+read_reader_data (struct GNUNET_CHAT_InternalBlockReader *reader,
+                  uint64_t offset,
+                  void *data,
+                  size_t size)
+{
+  GNUNET_assert((reader) && (data));
+
+  if ((off_t) offset != GNUNET_DISK_file_seek(
+      reader->file, (off_t) offset, GNUNET_DISK_SEEK_SET))
+    return GNUNET_SYSERR;
+
+  size_t done = 0;
+  ssize_t result;
+
+  while (done < size)
+  {
+    result = GNUNET_DISK_file_read(
+      reader->file, ((uint8_t*) data) + done, size - done
+    );
+
+    if (result <= 0)
+      return GNUNET_SYSERR;
+
+    done += (size_t) result;
+  }
+
+  return GNUNET_OK;
+}
+
+static enum GNUNET_GenericReturnValue
+prepare_reader_ivs (struct GNUNET_CHAT_InternalBlockReader *reader,
+                    uint64_t index)
+{
+  GNUNET_assert((reader) && (GNUNET_YES == reader->encrypted));
+
+  if (index < reader->ivs_count)
+    return GNUNET_OK;
+
+  if (index >= reader->ivs_size)
+    GNUNET_array_grow(reader->ivs, reader->ivs_size, index + 1);
+
+  const struct GNUNET_HashCode *hash = &(reader->hash);
+
+  if (!(reader->ivs_count))
+  {
+    GNUNET_CRYPTO_symmetric_derive_iv(
+      &(reader->ivs[0]), &(reader->key), hash, sizeof(hash), NULL
+    );
+
+    reader->ivs_count = 1;
+  }
+
+  struct GNUNET_CRYPTO_SymmetricInitializationVector prefix;
+
+  // The initialization vector of each block is the start of the
+  // previous block in plaintext, so only that prefix gets decrypted.
+  while (reader->ivs_count <= index)
+  {
+    const uint64_t previous = reader->ivs_count - 1;
+
+    if (GNUNET_OK != read_reader_data(reader, block_size_of_reader * previous,
+                                      &prefix, sizeof(prefix)))
+      return GNUNET_SYSERR;
+
+    if (0 > GNUNET_CRYPTO_symmetric_decrypt(
+        &prefix, sizeof(prefix), &(reader->key),
+        &(reader->ivs[previous]), &(reader->ivs[reader->ivs_count])))
+      return GNUNET_SYSERR;
+
+    reader->ivs_count++;
+  }
+
+  return GNUNET_OK;
+}
+
+static struct GNUNET_CHAT_InternalBlock*
+load_reader_block (struct GNUNET_CHAT_InternalBlockReader *reader,
+                   uint64_t index)
+{
+  GNUNET_assert(reader);
+
+  struct GNUNET_CHAT_InternalBlock *block = NULL;
+
+  for (unsigned int i = 0; i < GNUNET_CHAT_INTERNAL_BLOCK_READER_CACHE; i++)
+  {
+    if ((reader->blocks[i].data) && (reader->blocks[i].index == index))
+    {
+      block = &(reader->blocks[i]);
+      goto use_block;
+    }
+
+    if ((!block) || (!(reader->blocks[i].data)) ||
+        ((block->data) && (reader->blocks[i].used < block->used)))
+      block = &(reader->blocks[i]);
+  }
+
+  if (GNUNET_OK != prepare_reader_ivs(reader, index))
+    return NULL;
+
+  const uint64_t offset = block_size_of_reader * index;
+  const uint64_t remaining = reader->size - offset;
+
+  if (!(block->data))
+    block->data = GNUNET_malloc(block_size_of_reader);
+
+  block->index = index;
+  block->size = remaining >= block_size_of_reader?
+    block_size_of_reader : remaining;
+
+  if ((GNUNET_OK != read_reader_data(reader, offset, block->data, block->size)) ||
+      (0 > GNUNET_CRYPTO_symmetric_decrypt(
+        block->data, block->size, &(reader->key),
+        &(reader->ivs[index]), block->data)))
+  {
+    GNUNET_free(block->data);
+    block->data = NULL;
+    return NULL;
+  }
+
+  if ((reader->ivs_count == index + 1) &&
+      (block->size == block_size_of_reader) &&
+      (offset + block->size < reader->size))
+  {
+    if (reader->ivs_count >= reader->ivs_size)
+      GNUNET_array_grow(reader->ivs, reader->ivs_size, reader->ivs_count + 1);
+
+    GNUNET_memcpy(
+      &(reader->ivs[reader->ivs_count]),
+      block->data,
+      sizeof(reader->ivs[reader->ivs_count])
+    );
+
+    reader->ivs_count++;
+  }
+
+use_block:
+  block->used = ++(reader->usage);
+  return block;
+}
+
+ssize_t
+internal_block_reader_read (struct GNUNET_CHAT_InternalBlockReader *reader,
+                            uint64_t offset,
+                            void *buffer,
+                            size_t size)
+{
+  GNUNET_assert((reader) && (buffer));
+
+  if (offset >= reader->size)
+    return 0;
+
+  if (size > reader->size - offset)
+    size = (size_t) (reader->size - offset);
+
+  if (GNUNET_YES != reader->encrypted)
+  {
+    if (GNUNET_OK != read_reader_data(reader, offset, buffer, size))
+      return GNUNET_SYSERR;
+
+    return (ssize_t) size;
+  }
+
+  struct GNUNET_CHAT_InternalBlock *block;
+  size_t done = 0;
+
+  while (done < size)
+  {
+    const uint64_t position = offset + done;
+    const uint64_t index = position / block_size_of_reader;
+
+    block = load_reader_block(reader, index);
+
+    if (!block)
+      return GNUNET_SYSERR;
+
+    const uint64_t inner = position - block_size_of_reader * index;
+    uint64_t amount = block->size - inner;
+
+    if (amount > size - done)
+      amount = size - done;
+
+    GNUNET_memcpy(((uint8_t*) buffer) + done, block->data + inner, amount);
+    done += amount;
+  }
+
+  return (ssize_t) done;
+}
@@ -0,0 +1,104 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_block_reader.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_BLOCK_READER_H_
+#define GNUNET_CHAT_INTERNAL_BLOCK_READER_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+
+#define GNUNET_CHAT_INTERNAL_BLOCK_READER_CACHE 4
+
+struct GNUNET_CHAT_InternalBlock
+{
+  uint64_t index;
+  uint64_t size;
+  uint8_t *data;
+
+  unsigned long long used;
+};
+
+struct GNUNET_CHAT_InternalBlockReader
+{
+  struct GNUNET_DISK_FileHandle *file;
+  uint64_t size;
+
+  struct GNUNET_HashCode hash;
+  struct GNUNET_CRYPTO_SymmetricSessionKey key;
+  enum GNUNET_GenericReturnValue encrypted;
+
+  struct GNUNET_CRYPTO_SymmetricInitializationVector *ivs;
+  unsigned int ivs_count;
+  unsigned int ivs_size;
+
+  struct GNUNET_CHAT_InternalBlock blocks [
+    GNUNET_CHAT_INTERNAL_BLOCK_READER_CACHE
+  ];
+
+  unsigned long long usage;
+};
+
+/**
+ * Opens a block reader structure to access the content of a
+ * stored file under a given <i>filename</i> encrypted with a
+ * selected symmetric <i>key</i> and its <i>hash</i> without
+ * decrypting the whole file.
+ *
+ * @param[in] filename File name
+ * @param[in] hash Hash of file
+ * @param[in] key Symmetric key or NULL
+ * @return New chat block reader or NULL on failure
+ */
+struct GNUNET_CHAT_InternalBlockReader*
+internal_block_reader_create (const char *filename,
+                              const struct GNUNET_HashCode *hash,
+                              const struct GNUNET_CRYPTO_SymmetricSessionKey *key);
+
+/**
+ * Closes a <i>reader</i> structure and frees its cached blocks.
+ *
+ * @param[out] reader Chat block reader
+ */
+void
+internal_block_reader_destroy (struct GNUNET_CHAT_InternalBlockReader *reader);
+
+/**
+ * Reads up to <i>size</i> bytes of decrypted content starting
+ * at a given <i>offset</i> via a selected <i>reader</i> into
+ * a <i>buffer</i>. Only the blocks covering the requested range
+ * get decrypted while the most recently used blocks are kept.
+ *
+ * @param[in,out] reader Chat block reader
+ * @param[in] offset Offset in the decrypted content
+ * @param[out] buffer Buffer
+ * @param[in] size Size of buffer
+ * @return Amount of bytes read or #GNUNET_SYSERR on failure
+ */
+ssize_t
+internal_block_reader_read (struct GNUNET_CHAT_InternalBlockReader *reader,
+                            uint64_t offset,
+                            void *buffer,
+                            size_t size);
+
+#endif /* GNUNET_CHAT_INTERNAL_BLOCK_READER_H_ */
@@ -0,0 +1,467 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_dependencies.c
+ */
+
+#include "gnunet_chat_dependencies.h"
+#include "gnunet_chat_message.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+static const unsigned int initial_map_size_of_dependencies = 8;
+
+struct GNUNET_CHAT_DependencyRelease
+{
+  struct GNUNET_CHAT_Message **messages;
+  unsigned int count;
+};
+
+struct GNUNET_CHAT_InternalDependencies*
+internal_dependencies_create (unsigned int initial_size,
+                              GNUNET_CHAT_DependencyFetchCallback fetch_cb,
+                              GNUNET_CHAT_DependencyReleaseCallback release_cb,
+                              void *cls)
+{
+  GNUNET_assert((fetch_cb) && (release_cb));
+
+  struct GNUNET_CHAT_InternalDependencies* dependencies = GNUNET_new(struct GNUNET_CHAT_InternalDependencies);
+
+  if (initial_size < initial_map_size_of_dependencies)
+    initial_size = initial_map_size_of_dependencies;
+
+  dependencies->waits = GNUNET_CONTAINER_multihashmap_create(
+    initial_size, GNUNET_NO);
+
+  dependencies->head = NULL;
+  dependencies->tail = NULL;
+
+  dependencies->pending_head = NULL;
+  dependencies->pending_tail = NULL;
+
+  dependencies->fetch_cb = fetch_cb;
+  dependencies->release_cb = release_cb;
+  dependencies->cls = cls;
+
+  dependencies->limit = 0;
+  dependencies->timeout = GNUNET_TIME_UNIT_FOREVER_REL;
+
+  dependencies->window = GNUNET_TIME_absolute_get_zero_();
+  dependencies->fetches = 0;
+
+  dependencies->fetch_task = NULL;
+  dependencies->expire_task = NULL;
+
+  dependencies->resolved = 0;
+  dependencies->expired = 0;
+  dependencies->latency = GNUNET_TIME_relative_get_zero_();
+  dependencies->max_latency = GNUNET_TIME_relative_get_zero_();
+
+  return dependencies;
+}
+
+void
+internal_dependencies_destroy (struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(
+    (dependencies) &&
+    (dependencies->waits)
+  );
+
+  internal_dependencies_clear(dependencies);
+
+  GNUNET_CONTAINER_multihashmap_destroy(dependencies->waits);
+
+  GNUNET_free(dependencies);
+}
+
+static void
+task_fetch_dependencies (void *cls);
+
+static void
+task_expire_dependencies (void *cls);
+
+static enum GNUNET_GenericReturnValue
+take_fetch_slot (struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(dependencies);
+
+  if (!(dependencies->limit))
+    return GNUNET_YES;
+
+  const struct GNUNET_TIME_Absolute end = GNUNET_TIME_absolute_add(
+    dependencies->window, GNUNET_TIME_UNIT_SECONDS
+  );
+
+  if (GNUNET_TIME_absolute_is_past(end))
+  {
+    dependencies->window = GNUNET_TIME_absolute_get();
+    dependencies->fetches = 0;
+  }
+
+  if (dependencies->fetches >= dependencies->limit)
+    return GNUNET_NO;
+
+  dependencies->fetches++;
+  return GNUNET_YES;
+}
+
+static void
+schedule_fetch_task (struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(dependencies);
+
+  if ((dependencies->fetch_task) || (!(dependencies->pending_head)))
+    return;
+
+  dependencies->fetch_task = GNUNET_SCHEDULER_add_at(
+    GNUNET_TIME_absolute_add(dependencies->window, GNUNET_TIME_UNIT_SECONDS),
+    task_fetch_dependencies,
+    dependencies
+  );
+}
+
+static void
+schedule_expire_task (struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(dependencies);
+
+  if ((dependencies->expire_task) || (!(dependencies->head)) ||
+      (GNUNET_TIME_relative_is_forever(dependencies->timeout)))
+    return;
+
+  dependencies->expire_task = GNUNET_SCHEDULER_add_at(
+    GNUNET_TIME_absolute_add(dependencies->head->start, dependencies->timeout),
+    task_expire_dependencies,
+    dependencies
+  );
+}
+
+static void
+request_wait (struct GNUNET_CHAT_InternalDependencies *dependencies,
+              struct GNUNET_CHAT_InternalDependencyWait *wait)
+{
+  GNUNET_assert((dependencies) && (wait));
+
+  if (GNUNET_YES != take_fetch_slot(dependencies))
+  {
+    GNUNET_CONTAINER_MDLL_insert_tail(
+      pending,
+      dependencies->pending_head,
+      dependencies->pending_tail,
+      wait
+    );
+
+    schedule_fetch_task(dependencies);
+    return;
+  }
+
+  wait->requested = GNUNET_YES;
+  dependencies->fetch_cb(dependencies->cls, &(wait->hash));
+}
+
+static void
+remove_wait (struct GNUNET_CHAT_InternalDependencies *dependencies,
+             struct GNUNET_CHAT_InternalDependencyWait *wait,
+             struct GNUNET_CHAT_DependencyRelease *release)
+{
+  GNUNET_assert((dependencies) && (wait));
+
+  GNUNET_CONTAINER_multihashmap_remove(
+    dependencies->waits, &(wait->hash), wait
+  );
+
+  GNUNET_CONTAINER_DLL_remove(
+    dependencies->head,
+    dependencies->tail,
+    wait
+  );
+
+  if (GNUNET_YES != wait->requested)
+    GNUNET_CONTAINER_MDLL_remove(
+      pending,
+      dependencies->pending_head,
+      dependencies->pending_tail,
+      wait
+    );
+
+  for (unsigned int i = 0; (release) && (i < wait->count); i++)
+    GNUNET_array_append(
+      release->messages, release->count, wait->dependents[i]
+    );
+
+  GNUNET_array_grow(wait->dependents, wait->count, 0);
+  GNUNET_free(wait);
+}
+
+static void
+resolve_wait (struct GNUNET_CHAT_InternalDependencies *dependencies,
+              struct GNUNET_CHAT_InternalDependencyWait *wait,
+              struct GNUNET_CHAT_DependencyRelease *release)
+{
+  GNUNET_assert((dependencies) && (wait) && (release));
+
+  const struct GNUNET_TIME_Relative latency = GNUNET_TIME_absolute_get_duration(
+    wait->start
+  );
+
+  dependencies->resolved++;
+  dependencies->latency = GNUNET_TIME_relative_add(
+    dependencies->latency, latency
+  );
+
+  if (latency.rel_value_us > dependencies->max_latency.rel_value_us)
+    dependencies->max_latency = latency;
+
+  remove_wait(dependencies, wait, release);
+}
+
+static unsigned int
+release_messages (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                  struct GNUNET_CHAT_DependencyRelease *release)
+{
+  GNUNET_assert((dependencies) && (release));
+
+  // The callback may destroy the dependencies, so it must not be
+  // accessed anymore from here on.
+  GNUNET_CHAT_DependencyReleaseCallback release_cb = dependencies->release_cb;
+  void *cls = dependencies->cls;
+
+  for (unsigned int i = 0; i < release->count; i++)
+    release_cb(cls, release->messages[i]);
+
+  const unsigned int count = release->count;
+  GNUNET_array_grow(release->messages, release->count, 0);
+  return count;
+}
+
+static void
+task_fetch_dependencies (void *cls)
+{
+  struct GNUNET_CHAT_InternalDependencies *dependencies = cls;
+
+  GNUNET_assert(dependencies);
+
+  dependencies->fetch_task = NULL;
+
+  struct GNUNET_CHAT_InternalDependencyWait *wait;
+  while ((dependencies->pending_head) &&
+         (GNUNET_YES == take_fetch_slot(dependencies)))
+  {
+    wait = dependencies->pending_head;
+
+    GNUNET_CONTAINER_MDLL_remove(
+      pending,
+      dependencies->pending_head,
+      dependencies->pending_tail,
+      wait
+    );
+
+    wait->requested = GNUNET_YES;
+    dependencies->fetch_cb(dependencies->cls, &(wait->hash));
+  }
+
+  schedule_fetch_task(dependencies);
+}
+
+static void
+task_expire_dependencies (void *cls)
+{
+  struct GNUNET_CHAT_InternalDependencies *dependencies = cls;
+
+  GNUNET_assert(dependencies);
+
+  dependencies->expire_task = NULL;
+
+  struct GNUNET_CHAT_DependencyRelease release;
+  release.messages = NULL;
+  release.count = 0;
+
+  struct GNUNET_TIME_Absolute deadline;
+  while (dependencies->head)
+  {
+    deadline = GNUNET_TIME_absolute_add(
+      dependencies->head->start, dependencies->timeout
+    );
+
+    if (! GNUNET_TIME_absolute_is_past(deadline))
+      break;
+
+    // Released messages get delivered right away, so the wait gets
+    // dropped entirely instead of releasing them again later.
+    dependencies->expired++;
+    remove_wait(dependencies, dependencies->head, &release);
+  }
+
+  schedule_expire_task(dependencies);
+  release_messages(dependencies, &release);
+}
+
+void
+internal_dependencies_configure (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                                 unsigned int limit,
+                                 struct GNUNET_TIME_Relative timeout)
+{
+  GNUNET_assert(dependencies);
+
+  dependencies->limit = limit;
+
+  if (GNUNET_TIME_relative_is_zero(timeout))
+    dependencies->timeout = GNUNET_TIME_UNIT_FOREVER_REL;
+  else
+    dependencies->timeout = timeout;
+
+  if (dependencies->expire_task)
+  {
+    GNUNET_SCHEDULER_cancel(dependencies->expire_task);
+    dependencies->expire_task = NULL;
+  }
+
+  schedule_expire_task(dependencies);
+
+  if (dependencies->fetch_task)
+  {
+    GNUNET_SCHEDULER_cancel(dependencies->fetch_task);
+    dependencies->fetch_task = NULL;
+  }
+
+  if (dependencies->pending_head)
+    dependencies->fetch_task = GNUNET_SCHEDULER_add_now(
+      task_fetch_dependencies, dependencies
+    );
+}
+
+void
+internal_dependencies_add (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                           const struct GNUNET_HashCode *hash,
+                           struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((dependencies) && (hash) && (message));
+
+  struct GNUNET_CHAT_InternalDependencyWait *wait;
+  wait = GNUNET_CONTAINER_multihashmap_get(dependencies->waits, hash);
+
+  if (wait)
+    goto add_dependent;
+
+  wait = GNUNET_new(struct GNUNET_CHAT_InternalDependencyWait);
+
+  GNUNET_memcpy(&(wait->hash), hash, sizeof(wait->hash));
+  wait->start = GNUNET_TIME_absolute_get();
+  wait->requested = GNUNET_NO;
+
+  wait->dependents = NULL;
+  wait->count = 0;
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      dependencies->waits, hash, wait,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    GNUNET_free(wait);
+    return;
+  }
+
+  GNUNET_CONTAINER_DLL_insert_tail(
+    dependencies->head,
+    dependencies->tail,
+    wait
+  );
+
+  request_wait(dependencies, wait);
+  schedule_expire_task(dependencies);
+
+add_dependent:
+  for (unsigned int i = 0; i < wait->count; i++)
+    if (wait->dependents[i] == message)
+      return;
+
+  GNUNET_array_append(wait->dependents, wait->count, message);
+}
+
+unsigned int
+internal_dependencies_resolve (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                               const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((dependencies) && (hash));
+
+  struct GNUNET_CHAT_InternalDependencyWait *wait;
+  wait = GNUNET_CONTAINER_multihashmap_get(dependencies->waits, hash);
+
+  if (!wait)
+    return 0;
+
+  struct GNUNET_CHAT_DependencyRelease release;
+  release.messages = NULL;
+  release.count = 0;
+
+  resolve_wait(dependencies, wait, &release);
+
+  return release_messages(dependencies, &release);
+}
+
+static enum GNUNET_GenericReturnValue
+it_remove_dependency_wait (void *cls,
+                           GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                           void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalDependencies *dependencies = cls;
+  struct GNUNET_CHAT_InternalDependencyWait *wait = value;
+
+  remove_wait(dependencies, wait, NULL);
+  return GNUNET_YES;
+}
+
+void
+internal_dependencies_clear (struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(dependencies);
+
+  if (dependencies->fetch_task)
+  {
+    GNUNET_SCHEDULER_cancel(dependencies->fetch_task);
+    dependencies->fetch_task = NULL;
+  }
+
+  if (dependencies->expire_task)
+  {
+    GNUNET_SCHEDULER_cancel(dependencies->expire_task);
+    dependencies->expire_task = NULL;
+  }
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    dependencies->waits, it_remove_dependency_wait, dependencies
+  );
+}
+
+unsigned int
+internal_dependencies_size (const struct GNUNET_CHAT_InternalDependencies *dependencies)
+{
+  GNUNET_assert(dependencies);
+
+  return GNUNET_CONTAINER_multihashmap_size(
+    dependencies->waits
+  );
+}
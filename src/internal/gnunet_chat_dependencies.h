@@ -0,0 +1,180 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_dependencies.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_DEPENDENCIES_H_
+#define GNUNET_CHAT_INTERNAL_DEPENDENCIES_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_Message;
+
+typedef void
+(*GNUNET_CHAT_DependencyFetchCallback) (void *cls,
+                                        const struct GNUNET_HashCode *hash);
+
+typedef void
+(*GNUNET_CHAT_DependencyReleaseCallback) (void *cls,
+                                          struct GNUNET_CHAT_Message *message);
+
+struct GNUNET_CHAT_InternalDependencyWait
+{
+  struct GNUNET_HashCode hash;
+  struct GNUNET_TIME_Absolute start;
+  enum GNUNET_GenericReturnValue requested;
+
+  struct GNUNET_CHAT_Message **dependents;
+  unsigned int count;
+
+  struct GNUNET_CHAT_InternalDependencyWait *next;
+  struct GNUNET_CHAT_InternalDependencyWait *prev;
+
+  struct GNUNET_CHAT_InternalDependencyWait *next_pending;
+  struct GNUNET_CHAT_InternalDependencyWait *prev_pending;
+};
+
+struct GNUNET_CHAT_InternalDependencies
+{
+  struct GNUNET_CONTAINER_MultiHashMap *waits;
+
+  struct GNUNET_CHAT_InternalDependencyWait *head;
+  struct GNUNET_CHAT_InternalDependencyWait *tail;
+
+  struct GNUNET_CHAT_InternalDependencyWait *pending_head;
+  struct GNUNET_CHAT_InternalDependencyWait *pending_tail;
+
+  GNUNET_CHAT_DependencyFetchCallback fetch_cb;
+  GNUNET_CHAT_DependencyReleaseCallback release_cb;
+  void *cls;
+
+  unsigned int limit;
+  struct GNUNET_TIME_Relative timeout;
+
+  struct GNUNET_TIME_Absolute window;
+  unsigned int fetches;
+
+  struct GNUNET_SCHEDULER_Task *fetch_task;
+  struct GNUNET_SCHEDULER_Task *expire_task;
+
+  unsigned long long resolved;
+  unsigned long long expired;
+  struct GNUNET_TIME_Relative latency;
+  struct GNUNET_TIME_Relative max_latency;
+};
+
+/**
+ * Creates a dependencies structure to resolve messages which
+ * depend on other messages not being available yet. Missing
+ * messages get requested via <i>fetch_cb</i> and waiting messages
+ * get passed to <i>release_cb</i> once they can be processed.
+ *
+ * @param[in] initial_size Expected amount of missing messages
+ * @param[in] fetch_cb Callback to request missing messages
+ * @param[in] release_cb Callback to process waiting messages
+ * @param[in,out] cls Closure for both callbacks
+ * @return New chat dependencies
+ */
+struct GNUNET_CHAT_InternalDependencies*
+internal_dependencies_create (unsigned int initial_size,
+                              GNUNET_CHAT_DependencyFetchCallback fetch_cb,
+                              GNUNET_CHAT_DependencyReleaseCallback release_cb,
+                              void *cls);
+
+/**
+ * Destroys a <i>dependencies</i> structure dropping all of its
+ * waiting messages without releasing them.
+ *
+ * @param[out] dependencies Chat dependencies
+ */
+void
+internal_dependencies_destroy (struct GNUNET_CHAT_InternalDependencies *dependencies);
+
+/**
+ * Configures a <i>dependencies</i> structure to request at most
+ * <i>limit</i> missing messages per second and to release waiting
+ * messages after a given <i>timeout</i> even if their dependency
+ * is still missing. Those messages do not get released again
+ * when their dependency arrives later. A <i>limit</i> of zero
+ * disables the rate limit and a zero <i>timeout</i> lets messages
+ * wait forever.
+ *
+ * @param[in,out] dependencies Chat dependencies
+ * @param[in] limit Maximum amount of requests per second
+ * @param[in] timeout Timeout for waiting messages
+ */
+void
+internal_dependencies_configure (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                                 unsigned int limit,
+                                 struct GNUNET_TIME_Relative timeout);
+
+/**
+ * Adds a <i>message</i> to a selected <i>dependencies</i> structure
+ * to wait for another message with a given <i>hash</i>. The missing
+ * message gets requested only once no matter how many messages wait
+ * for it.
+ *
+ * @param[in,out] dependencies Chat dependencies
+ * @param[in] hash Hash of the missing message
+ * @param[in,out] message Waiting chat message
+ */
+void
+internal_dependencies_add (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                           const struct GNUNET_HashCode *hash,
+                           struct GNUNET_CHAT_Message *message);
+
+/**
+ * Resolves the dependency on a message with a given <i>hash</i> from
+ * a selected <i>dependencies</i> structure. All messages waiting for it
+ * get released in the order they were added.
+ *
+ * @param[in,out] dependencies Chat dependencies
+ * @param[in] hash Hash of the available message
+ * @return Amount of released messages
+ */
+unsigned int
+internal_dependencies_resolve (struct GNUNET_CHAT_InternalDependencies *dependencies,
+                               const struct GNUNET_HashCode *hash);
+
+/**
+ * Drops all waiting messages from a selected <i>dependencies</i>
+ * structure without releasing them.
+ *
+ * @param[in,out] dependencies Chat dependencies
+ */
+void
+internal_dependencies_clear (struct GNUNET_CHAT_InternalDependencies *dependencies);
+
+/**
+ * Returns the amount of missing messages in a selected
+ * <i>dependencies</i> structure.
+ *
+ * @param[in] dependencies Chat dependencies
+ * @return Amount of missing messages
+ */
+unsigned int
+internal_dependencies_size (const struct GNUNET_CHAT_InternalDependencies *dependencies);
+
+#endif /* GNUNET_CHAT_INTERNAL_DEPENDENCIES_H_ */
@@ -0,0 +1,549 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_playout.c
+ */
+
+#include "gnunet_chat_playout.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+static const unsigned int initial_map_size_of_playout = 4;
+static const size_t maximum_buffer_of_playout = 4 * 1024 * 1024;
+
+struct GNUNET_CHAT_InternalPlayout*
+internal_playout_create (struct GNUNET_TIME_Relative delay,
+                         GNUNET_CHAT_PlayoutErrorCallback error_cb,
+                         void *cls)
+{
+  GNUNET_assert(error_cb);
+
+  struct GNUNET_CHAT_InternalPlayout* playout = GNUNET_new(struct GNUNET_CHAT_InternalPlayout);
+
+  playout->streams = GNUNET_CONTAINER_multishortmap_create(
+    initial_map_size_of_playout, GNUNET_NO);
+
+  playout->delay = delay;
+
+  playout->error_cb = error_cb;
+  playout->cls = cls;
+
+  playout->task = NULL;
+
+  return playout;
+}
+
+static enum GNUNET_GenericReturnValue
+it_destroy_playout_streams (GNUNET_UNUSED void *cls,
+                            GNUNET_UNUSED const struct GNUNET_ShortHashCode *key,
+                            void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_InternalPlayoutStream *stream = value;
+  struct GNUNET_CHAT_InternalPlayoutChunk *chunk;
+
+  while (stream->head)
+  {
+    chunk = stream->head;
+
+    GNUNET_CONTAINER_DLL_remove(stream->head, stream->tail, chunk);
+    GNUNET_free(chunk);
+  }
+
+  if (stream->task)
+    GNUNET_SCHEDULER_cancel(stream->task);
+
+  // The file descriptor is owned by the application, so only
+  // its handle gets freed without closing it.
+  if (stream->handle)
+    GNUNET_free(stream->handle);
+
+  if (stream->buffer)
+    GNUNET_free(stream->buffer);
+
+  GNUNET_free(stream);
+  return GNUNET_YES;
+}
+
+void
+internal_playout_destroy (struct GNUNET_CHAT_InternalPlayout *playout)
+{
+  GNUNET_assert((playout) && (playout->streams));
+
+  if (playout->task)
+    GNUNET_SCHEDULER_cancel(playout->task);
+
+  GNUNET_CONTAINER_multishortmap_iterate(
+    playout->streams, it_destroy_playout_streams, NULL
+  );
+
+  GNUNET_CONTAINER_multishortmap_destroy(playout->streams);
+
+  GNUNET_free(playout);
+}
+
+static int64_t
+get_playout_deadline (const struct GNUNET_CHAT_InternalPlayout *playout,
+                      const struct GNUNET_CHAT_InternalPlayoutStream *stream,
+                      const struct GNUNET_CHAT_InternalPlayoutChunk *chunk)
+{
+  GNUNET_assert((playout) && (stream) && (chunk));
+
+  return (
+    (int64_t) chunk->timestamp.abs_value_us + stream->offset +
+    (int64_t) playout->delay.rel_value_us
+  );
+}
+
+static void
+cb_playout_stream_writable (void *cls);
+
+static void
+watch_playout_stream (struct GNUNET_CHAT_InternalPlayoutStream *stream)
+{
+  GNUNET_assert(stream);
+
+  if ((stream->task) || (!(stream->handle)) ||
+      (stream->buffer_start >= stream->buffer_end))
+    return;
+
+  stream->task = GNUNET_SCHEDULER_add_write_file(
+    GNUNET_TIME_UNIT_FOREVER_REL,
+    stream->handle,
+    cb_playout_stream_writable,
+    stream
+  );
+}
+
+static void
+detach_playout_stream (struct GNUNET_CHAT_InternalPlayoutStream *stream)
+{
+  GNUNET_assert(stream);
+
+  if (stream->task)
+  {
+    GNUNET_SCHEDULER_cancel(stream->task);
+    stream->task = NULL;
+  }
+
+  if (stream->handle)
+  {
+    GNUNET_free(stream->handle);
+    stream->handle = NULL;
+  }
+
+  stream->fd = -1;
+}
+
+static enum GNUNET_GenericReturnValue
+check_playout_stream (struct GNUNET_CHAT_InternalPlayoutStream *stream,
+                      ssize_t written)
+{
+  GNUNET_assert((stream) && (stream->playout));
+
+  if ((written >= 0) ||
+      (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno))
+    return GNUNET_OK;
+
+  // Data stays available via reading from the stream instead of
+  // getting buffered for a file descriptor which can not recover.
+  detach_playout_stream(stream);
+
+  stream->playout->error_cb(stream->playout->cls, &(stream->sender));
+  return GNUNET_SYSERR;
+}
+
+static void
+flush_playout_stream (struct GNUNET_CHAT_InternalPlayoutStream *stream)
+{
+  GNUNET_assert(stream);
+
+  if ((-1 == stream->fd) || (stream->buffer_start >= stream->buffer_end))
+    return;
+
+  const ssize_t written = write(
+    stream->fd,
+    stream->buffer + stream->buffer_start,
+    stream->buffer_end - stream->buffer_start
+  );
+
+  if (GNUNET_OK != check_playout_stream(stream, written))
+    return;
+
+  if (written > 0)
+    stream->buffer_start += (size_t) written;
+
+  if (stream->buffer_start < stream->buffer_end)
+  {
+    watch_playout_stream(stream);
+    return;
+  }
+
+  stream->buffer_start = 0;
+  stream->buffer_end = 0;
+}
+
+static void
+cb_playout_stream_writable (void *cls)
+{
+  struct GNUNET_CHAT_InternalPlayoutStream *stream = cls;
+
+  GNUNET_assert(stream);
+
+  stream->task = NULL;
+
+  flush_playout_stream(stream);
+}
+
+static void
+append_playout_stream (struct GNUNET_CHAT_InternalPlayoutStream *stream,
+                       const char *data,
+                       size_t size)
+{
+  GNUNET_assert((stream) && (data));
+
+  size_t used = stream->buffer_end - stream->buffer_start;
+
+  if (used + size > maximum_buffer_of_playout)
+  {
+    stream->dropped++;
+    return;
+  }
+
+  if ((-1 != stream->fd) && (!used))
+  {
+    const ssize_t written = write(stream->fd, data, size);
+
+    check_playout_stream(stream, written);
+
+    if (written > 0)
+    {
+      data += written;
+      size -= (size_t) written;
+    }
+
+    if (!size)
+      return;
+  }
+
+  if (stream->buffer_end + size > stream->buffer_size)
+  {
+    memmove(stream->buffer, stream->buffer + stream->buffer_start, used);
+
+    stream->buffer_start = 0;
+    stream->buffer_end = used;
+  }
+
+  if (stream->buffer_end + size > stream->buffer_size)
+  {
+    stream->buffer_size = stream->buffer_end + size;
+    stream->buffer = GNUNET_realloc(stream->buffer, stream->buffer_size);
+  }
+
+  GNUNET_memcpy(stream->buffer + stream->buffer_end, data, size);
+  stream->buffer_end += size;
+
+  watch_playout_stream(stream);
+}
+
+struct GNUNET_CHAT_PlayoutRelease
+{
+  struct GNUNET_CHAT_InternalPlayout *playout;
+  int64_t now;
+  int64_t next;
+};
+
+static enum GNUNET_GenericReturnValue
+it_release_playout_streams (void *cls,
+                            GNUNET_UNUSED const struct GNUNET_ShortHashCode *key,
+                            void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_PlayoutRelease *release = cls;
+  struct GNUNET_CHAT_InternalPlayoutStream *stream = value;
+  struct GNUNET_CHAT_InternalPlayoutChunk *chunk;
+
+  flush_playout_stream(stream);
+
+  int64_t deadline;
+
+  while (stream->head)
+  {
+    chunk = stream->head;
+    deadline = get_playout_deadline(release->playout, stream, chunk);
+
+    if (deadline > release->now)
+    {
+      if ((!(release->next)) || (deadline < release->next))
+        release->next = deadline;
+
+      break;
+    }
+
+    GNUNET_CONTAINER_DLL_remove(stream->head, stream->tail, chunk);
+
+    stream->last = chunk->timestamp;
+    append_playout_stream(stream, chunk->data, chunk->size);
+
+    GNUNET_free(chunk);
+  }
+
+  return GNUNET_YES;
+}
+
+static void
+task_playout_release (void *cls);
+
+static void
+release_playout_streams (struct GNUNET_CHAT_InternalPlayout *playout)
+{
+  GNUNET_assert(playout);
+
+  if (playout->task)
+  {
+    GNUNET_SCHEDULER_cancel(playout->task);
+    playout->task = NULL;
+  }
+
+  struct GNUNET_CHAT_PlayoutRelease release;
+  release.playout = playout;
+  release.now = (int64_t) GNUNET_TIME_absolute_get().abs_value_us;
+  release.next = 0;
+
+  GNUNET_CONTAINER_multishortmap_iterate(
+    playout->streams, it_release_playout_streams, &release
+  );
+
+  if (!(release.next))
+    return;
+
+  struct GNUNET_TIME_Absolute next;
+  next.abs_value_us = (uint64_t) release.next;
+
+  playout->task = GNUNET_SCHEDULER_add_at(
+    next, task_playout_release, playout
+  );
+}
+
+static void
+task_playout_release (void *cls)
+{
+  struct GNUNET_CHAT_InternalPlayout *playout = cls;
+
+  GNUNET_assert(playout);
+
+  playout->task = NULL;
+
+  release_playout_streams(playout);
+}
+
+void
+internal_playout_set_delay (struct GNUNET_CHAT_InternalPlayout *playout,
+                            struct GNUNET_TIME_Relative delay)
+{
+  GNUNET_assert(playout);
+
+  playout->delay = delay;
+
+  release_playout_streams(playout);
+}
+
+static struct GNUNET_CHAT_InternalPlayoutStream*
+get_playout_stream (struct GNUNET_CHAT_InternalPlayout *playout,
+                    const struct GNUNET_ShortHashCode *sender)
+{
+  GNUNET_assert((playout) && (sender));
+
+  struct GNUNET_CHAT_InternalPlayoutStream *stream;
+  stream = GNUNET_CONTAINER_multishortmap_get(playout->streams, sender);
+
+  if (stream)
+    return stream;
+
+  stream = GNUNET_new(struct GNUNET_CHAT_InternalPlayoutStream);
+
+  stream->playout = playout;
+  GNUNET_memcpy(&(stream->sender), sender, sizeof(stream->sender));
+
+  stream->head = NULL;
+  stream->tail = NULL;
+
+  stream->offset = 0;
+  stream->synced = GNUNET_NO;
+  stream->last = GNUNET_TIME_absolute_get_zero_();
+
+  stream->buffer = NULL;
+  stream->buffer_size = 0;
+  stream->buffer_start = 0;
+  stream->buffer_end = 0;
+
+  stream->fd = -1;
+  stream->handle = NULL;
+  stream->task = NULL;
+
+  stream->dropped = 0;
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multishortmap_put(
+      playout->streams, sender, stream,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    GNUNET_free(stream);
+    return NULL;
+  }
+
+  return stream;
+}
+
+enum GNUNET_GenericReturnValue
+internal_playout_add (struct GNUNET_CHAT_InternalPlayout *playout,
+                      const struct GNUNET_ShortHashCode *sender,
+                      struct GNUNET_TIME_Absolute timestamp,
+                      const char *data,
+                      uint16_t size)
+{
+  GNUNET_assert((playout) && (sender) && ((data) || (!size)));
+
+  struct GNUNET_CHAT_InternalPlayoutStream *stream = get_playout_stream(
+    playout, sender
+  );
+
+  if (!stream)
+    return GNUNET_SYSERR;
+
+  if (GNUNET_TIME_absolute_cmp(timestamp, <=, stream->last))
+  {
+    stream->dropped++;
+    return GNUNET_NO;
+  }
+
+  // The lowest offset between arrival and timestamp seen so far
+  // approximates the clock offset of the sender without delay.
+  const int64_t offset = (
+    (int64_t) GNUNET_TIME_absolute_get().abs_value_us -
+    (int64_t) timestamp.abs_value_us
+  );
+
+  if ((GNUNET_YES != stream->synced) || (offset < stream->offset))
+  {
+    stream->offset = offset;
+    stream->synced = GNUNET_YES;
+  }
+
+  struct GNUNET_CHAT_InternalPlayoutChunk *chunk = GNUNET_malloc(
+    sizeof(*chunk) + size
+  );
+
+  chunk->timestamp = timestamp;
+  chunk->size = size;
+
+  if (size)
+    GNUNET_memcpy(chunk->data, data, size);
+
+  struct GNUNET_CHAT_InternalPlayoutChunk *prev = stream->tail;
+
+  while ((prev) && (GNUNET_TIME_absolute_cmp(prev->timestamp, >, timestamp)))
+    prev = prev->prev;
+
+  GNUNET_CONTAINER_DLL_insert_after(stream->head, stream->tail, prev, chunk);
+
+  release_playout_streams(playout);
+
+  return GNUNET_OK;
+}
+
+enum GNUNET_GenericReturnValue
+internal_playout_set_fd (struct GNUNET_CHAT_InternalPlayout *playout,
+                         const struct GNUNET_ShortHashCode *sender,
+                         int fd)
+{
+  GNUNET_assert((playout) && (sender));
+
+  struct GNUNET_CHAT_InternalPlayoutStream *stream = get_playout_stream(
+    playout, sender
+  );
+
+  if (!stream)
+    return GNUNET_SYSERR;
+
+  detach_playout_stream(stream);
+
+  stream->fd = fd;
+
+  if (-1 != fd)
+    stream->handle = GNUNET_DISK_get_handle_from_int_fd(fd);
+
+  flush_playout_stream(stream);
+  return GNUNET_OK;
+}
+
+uint64_t
+internal_playout_available (const struct GNUNET_CHAT_InternalPlayout *playout,
+                            const struct GNUNET_ShortHashCode *sender)
+{
+  GNUNET_assert((playout) && (sender));
+
+  const struct GNUNET_CHAT_InternalPlayoutStream *stream;
+  stream = GNUNET_CONTAINER_multishortmap_get(playout->streams, sender);
+
+  if (!stream)
+    return 0;
+
+  return stream->buffer_end - stream->buffer_start;
+}
+
+uint64_t
+internal_playout_read (struct GNUNET_CHAT_InternalPlayout *playout,
+                       const struct GNUNET_ShortHashCode *sender,
+                       char *data,
+                       uint64_t size)
+{
+  GNUNET_assert((playout) && (sender) && (data));
+
+  struct GNUNET_CHAT_InternalPlayoutStream *stream;
+  stream = GNUNET_CONTAINER_multishortmap_get(playout->streams, sender);
+
+  if (!stream)
+    return 0;
+
+  const uint64_t available = stream->buffer_end - stream->buffer_start;
+
+  if (size > available)
+    size = available;
+
+  GNUNET_memcpy(data, stream->buffer + stream->buffer_start, size);
+  stream->buffer_start += size;
+
+  if (stream->buffer_start >= stream->buffer_end)
+  {
+    stream->buffer_start = 0;
+    stream->buffer_end = 0;
+  }
+
+  return size;
+}
@@ -0,0 +1,189 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_playout.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_PLAYOUT_H_
+#define GNUNET_CHAT_INTERNAL_PLAYOUT_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+typedef void
+(*GNUNET_CHAT_PlayoutErrorCallback) (void *cls,
+                                     const struct GNUNET_ShortHashCode *sender);
+
+struct GNUNET_CHAT_InternalPlayout;
+
+struct GNUNET_CHAT_InternalPlayoutChunk
+{
+  struct GNUNET_TIME_Absolute timestamp;
+
+  struct GNUNET_CHAT_InternalPlayoutChunk *prev;
+  struct GNUNET_CHAT_InternalPlayoutChunk *next;
+
+  uint16_t size;
+  char data [];
+};
+
+struct GNUNET_CHAT_InternalPlayoutStream
+{
+  struct GNUNET_CHAT_InternalPlayout *playout;
+  struct GNUNET_ShortHashCode sender;
+
+  struct GNUNET_CHAT_InternalPlayoutChunk *head;
+  struct GNUNET_CHAT_InternalPlayoutChunk *tail;
+
+  int64_t offset;
+  enum GNUNET_GenericReturnValue synced;
+  struct GNUNET_TIME_Absolute last;
+
+  char *buffer;
+  size_t buffer_size;
+  size_t buffer_start;
+  size_t buffer_end;
+
+  int fd;
+  struct GNUNET_DISK_FileHandle *handle;
+  struct GNUNET_SCHEDULER_Task *task;
+
+  unsigned long long dropped;
+};
+
+struct GNUNET_CHAT_InternalPlayout
+{
+  struct GNUNET_CONTAINER_MultiShortmap *streams;
+  struct GNUNET_TIME_Relative delay;
+
+  GNUNET_CHAT_PlayoutErrorCallback error_cb;
+  void *cls;
+
+  struct GNUNET_SCHEDULER_Task *task;
+};
+
+/**
+ * Creates a playout structure to buffer chunks of data from
+ * different senders, reordering them by their timestamps and
+ * releasing them after a given playout <i>delay</i>. If writing
+ * into the file descriptor of a sender fails, it gets detached
+ * and <i>error_cb</i> gets called.
+ *
+ * @param[in] delay Playout delay
+ * @param[in] error_cb Callback for failing file descriptors
+ * @param[in,out] cls Closure for the callback
+ * @return New chat playout
+ */
+struct GNUNET_CHAT_InternalPlayout*
+internal_playout_create (struct GNUNET_TIME_Relative delay,
+                         GNUNET_CHAT_PlayoutErrorCallback error_cb,
+                         void *cls);
+
+/**
+ * Destroys a <i>playout</i> structure dropping all of its
+ * buffered data.
+ *
+ * @param[out] playout Chat playout
+ */
+void
+internal_playout_destroy (struct GNUNET_CHAT_InternalPlayout *playout);
+
+/**
+ * Changes the playout <i>delay</i> of a selected <i>playout</i>
+ * structure.
+ *
+ * @param[in,out] playout Chat playout
+ * @param[in] delay Playout delay
+ */
+void
+internal_playout_set_delay (struct GNUNET_CHAT_InternalPlayout *playout,
+                            struct GNUNET_TIME_Relative delay);
+
+/**
+ * Adds a chunk of <i>data</i> with a given <i>size</i> from a
+ * <i>sender</i> to a selected <i>playout</i> structure using
+ * its <i>timestamp</i>. Chunks not newer than the latest released
+ * chunk of the same sender get dropped.
+ *
+ * @param[in,out] playout Chat playout
+ * @param[in] sender Sender identifier
+ * @param[in] timestamp Timestamp of the chunk
+ * @param[in] data Chunk data
+ * @param[in] size Chunk size
+ * @return #GNUNET_OK on success, #GNUNET_NO if the chunk got
+ *   dropped and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_playout_add (struct GNUNET_CHAT_InternalPlayout *playout,
+                      const struct GNUNET_ShortHashCode *sender,
+                      struct GNUNET_TIME_Absolute timestamp,
+                      const char *data,
+                      uint16_t size);
+
+/**
+ * Sets a file descriptor <i>fd</i> for the released data from
+ * a <i>sender</i> in a selected <i>playout</i> structure. The
+ * data gets written to the file descriptor instead of getting
+ * buffered for reading. Data which can not be written right
+ * away gets written once the file descriptor is writable.
+ *
+ * @param[in,out] playout Chat playout
+ * @param[in] sender Sender identifier
+ * @param[in] fd File descriptor or -1
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_playout_set_fd (struct GNUNET_CHAT_InternalPlayout *playout,
+                         const struct GNUNET_ShortHashCode *sender,
+                         int fd);
+
+/**
+ * Returns the amount of released bytes from a <i>sender</i>
+ * available to read from a selected <i>playout</i> structure.
+ *
+ * @param[in] playout Chat playout
+ * @param[in] sender Sender identifier
+ * @return Amount of available bytes
+ */
+uint64_t
+internal_playout_available (const struct GNUNET_CHAT_InternalPlayout *playout,
+                            const struct GNUNET_ShortHashCode *sender);
+
+/**
+ * Reads up to <i>size</i> released bytes from a <i>sender</i>
+ * out of a selected <i>playout</i> structure into a given
+ * <i>data</i> buffer.
+ *
+ * @param[in,out] playout Chat playout
+ * @param[in] sender Sender identifier
+ * @param[out] data Data buffer
+ * @param[in] size Buffer size
+ * @return Amount of bytes read
+ */
+uint64_t
+internal_playout_read (struct GNUNET_CHAT_InternalPlayout *playout,
+                       const struct GNUNET_ShortHashCode *sender,
+                       char *data,
+                       uint64_t size);
+
+#endif /* GNUNET_CHAT_INTERNAL_PLAYOUT_H_ */
@@ -0,0 +1,335 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_poller.c
+ */
+
+#include "gnunet_chat_poller.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_disk_lib.h>
+#include <gnunet/gnunet_network_lib.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#define MAX_POLLER_EVENTS 32
+
+static void
+schedule_poller_task (struct GNUNET_CHAT_InternalPoller *poller);
+
+struct GNUNET_CHAT_InternalPoller*
+internal_poller_create (void)
+{
+  struct GNUNET_CHAT_InternalPoller* poller = GNUNET_new(struct GNUNET_CHAT_InternalPoller);
+
+  poller->head = NULL;
+  poller->tail = NULL;
+
+  poller->count = 0;
+  poller->dispatching = GNUNET_NO;
+
+  poller->epoll = -1;
+  poller->epoll_handle = NULL;
+
+#ifdef __linux__
+  poller->epoll = epoll_create1(EPOLL_CLOEXEC);
+
+  if (-1 != poller->epoll)
+    poller->epoll_handle = GNUNET_DISK_get_handle_from_int_fd(poller->epoll);
+
+  if ((-1 != poller->epoll) && (!(poller->epoll_handle)))
+  {
+    close(poller->epoll);
+    poller->epoll = -1;
+  }
+#endif
+
+  poller->task = NULL;
+  return poller;
+}
+
+void
+internal_poller_destroy (struct GNUNET_CHAT_InternalPoller *poller)
+{
+  GNUNET_assert((poller) && (GNUNET_YES != poller->dispatching));
+
+  if (poller->task)
+    GNUNET_SCHEDULER_cancel(poller->task);
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry;
+  while (poller->head)
+  {
+    entry = poller->head;
+
+    GNUNET_CONTAINER_DLL_remove(
+      poller->head,
+      poller->tail,
+      entry
+    );
+
+    GNUNET_free(entry);
+  }
+
+  if (poller->epoll_handle)
+    GNUNET_DISK_file_close(poller->epoll_handle);
+
+  GNUNET_free(poller);
+}
+
+static void
+sweep_poller_entries (struct GNUNET_CHAT_InternalPoller *poller)
+{
+  GNUNET_assert(poller);
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry = poller->head;
+  struct GNUNET_CHAT_InternalPollerEntry *next;
+
+  while (entry)
+  {
+    next = entry->next;
+
+    if (!(entry->callback))
+    {
+      GNUNET_CONTAINER_DLL_remove(
+        poller->head,
+        poller->tail,
+        entry
+      );
+
+      GNUNET_free(entry);
+    }
+
+    entry = next;
+  }
+}
+
+static void
+cb_poller_epoll (void *cls)
+{
+  struct GNUNET_CHAT_InternalPoller *poller = cls;
+
+  GNUNET_assert(poller);
+
+  poller->task = NULL;
+
+#ifdef __linux__
+  struct epoll_event events [MAX_POLLER_EVENTS];
+  const int count = epoll_wait(poller->epoll, events, MAX_POLLER_EVENTS, 0);
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry;
+  poller->dispatching = GNUNET_YES;
+
+  // Entries removed by a callback stay allocated until all
+  // events of this round have been dispatched.
+  for (int i = 0; i < count; i++)
+  {
+    entry = events[i].data.ptr;
+
+    if (entry->callback)
+      entry->callback(entry->cls, entry->fd);
+  }
+
+  poller->dispatching = GNUNET_NO;
+  sweep_poller_entries(poller);
+#endif
+
+  schedule_poller_task(poller);
+}
+
+static void
+cb_poller_select (void *cls)
+{
+  struct GNUNET_CHAT_InternalPoller *poller = cls;
+
+  GNUNET_assert(poller);
+
+  poller->task = NULL;
+
+  const struct GNUNET_SCHEDULER_TaskContext *context;
+  context = GNUNET_SCHEDULER_get_task_context();
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry;
+  poller->dispatching = GNUNET_YES;
+
+  for (entry = poller->head; entry; entry = entry->next)
+  {
+    if ((!(entry->callback)) || (!(context)) || (!(context->read_ready)))
+      continue;
+
+    if (GNUNET_YES != GNUNET_NETWORK_fdset_test_native(
+        context->read_ready, entry->fd))
+      continue;
+
+    entry->callback(entry->cls, entry->fd);
+  }
+
+  poller->dispatching = GNUNET_NO;
+  sweep_poller_entries(poller);
+
+  schedule_poller_task(poller);
+}
+
+static void
+schedule_poller_task (struct GNUNET_CHAT_InternalPoller *poller)
+{
+  GNUNET_assert(poller);
+
+  if ((poller->task) || (GNUNET_YES == poller->dispatching) ||
+      (!(poller->count)))
+    return;
+
+  if (poller->epoll_handle)
+  {
+    poller->task = GNUNET_SCHEDULER_add_read_file(
+      GNUNET_TIME_UNIT_FOREVER_REL,
+      poller->epoll_handle,
+      cb_poller_epoll,
+      poller
+    );
+
+    return;
+  }
+
+  struct GNUNET_NETWORK_FDSet *rs = GNUNET_NETWORK_fdset_create();
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry;
+  for (entry = poller->head; entry; entry = entry->next)
+    if (entry->callback)
+      GNUNET_NETWORK_fdset_set_native(rs, entry->fd);
+
+  poller->task = GNUNET_SCHEDULER_add_select(
+    GNUNET_SCHEDULER_PRIORITY_DEFAULT,
+    GNUNET_TIME_UNIT_FOREVER_REL,
+    rs,
+    NULL,
+    cb_poller_select,
+    poller
+  );
+
+  GNUNET_NETWORK_fdset_destroy(rs);
+}
+
+static void
+reschedule_poller_task (struct GNUNET_CHAT_InternalPoller *poller)
+{
+  GNUNET_assert(poller);
+
+  // The epoll file descriptor covers changes of the registered
+  // file descriptors, only the fallback needs a new task.
+  if ((poller->task) && ((!(poller->epoll_handle)) || (!(poller->count))))
+  {
+    GNUNET_SCHEDULER_cancel(poller->task);
+    poller->task = NULL;
+  }
+
+  schedule_poller_task(poller);
+}
+
+enum GNUNET_GenericReturnValue
+internal_poller_add (struct GNUNET_CHAT_InternalPoller *poller,
+                     int fd,
+                     GNUNET_CHAT_PollerCallback callback,
+                     void *cls)
+{
+  GNUNET_assert((poller) && (callback));
+
+  if (-1 == fd)
+    return GNUNET_SYSERR;
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry = GNUNET_new(
+    struct GNUNET_CHAT_InternalPollerEntry
+  );
+
+  entry->fd = fd;
+  entry->callback = callback;
+  entry->cls = cls;
+
+#ifdef __linux__
+  if (-1 != poller->epoll)
+  {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+
+    event.events = EPOLLIN;
+    event.data.ptr = entry;
+
+    if (0 != epoll_ctl(poller->epoll, EPOLL_CTL_ADD, fd, &event))
+    {
+      GNUNET_free(entry);
+      return GNUNET_SYSERR;
+    }
+  }
+#endif
+
+  GNUNET_CONTAINER_DLL_insert_tail(
+    poller->head,
+    poller->tail,
+    entry
+  );
+
+  poller->count++;
+
+  reschedule_poller_task(poller);
+  return GNUNET_OK;
+}
+
+void
+internal_poller_remove (struct GNUNET_CHAT_InternalPoller *poller,
+                        int fd)
+{
+  GNUNET_assert(poller);
+
+  struct GNUNET_CHAT_InternalPollerEntry *entry;
+  for (entry = poller->head; entry; entry = entry->next)
+    if ((entry->callback) && (fd == entry->fd))
+      break;
+
+  if (!entry)
+    return;
+
+#ifdef __linux__
+  if (-1 != poller->epoll)
+    epoll_ctl(poller->epoll, EPOLL_CTL_DEL, fd, NULL);
+#endif
+
+  poller->count--;
+
+  if (GNUNET_YES == poller->dispatching)
+    entry->callback = NULL;
+  else
+  {
+    GNUNET_CONTAINER_DLL_remove(
+      poller->head,
+      poller->tail,
+      entry
+    );
+
+    GNUNET_free(entry);
+  }
+
+  reschedule_poller_task(poller);
+}
@@ -0,0 +1,112 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_poller.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_POLLER_H_
+#define GNUNET_CHAT_INTERNAL_POLLER_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_disk_lib.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+typedef void
+(*GNUNET_CHAT_PollerCallback) (void *cls,
+                               int fd);
+
+struct GNUNET_CHAT_InternalPollerEntry
+{
+  struct GNUNET_CHAT_InternalPollerEntry *prev;
+  struct GNUNET_CHAT_InternalPollerEntry *next;
+
+  int fd;
+
+  GNUNET_CHAT_PollerCallback callback;
+  void *cls;
+};
+
+struct GNUNET_CHAT_InternalPoller
+{
+  struct GNUNET_CHAT_InternalPollerEntry *head;
+  struct GNUNET_CHAT_InternalPollerEntry *tail;
+
+  unsigned int count;
+  enum GNUNET_GenericReturnValue dispatching;
+
+  int epoll;
+  struct GNUNET_DISK_FileHandle *epoll_handle;
+
+  struct GNUNET_SCHEDULER_Task *task;
+};
+
+/**
+ * Creates a poller structure to wait for multiple file
+ * descriptors becoming readable through a single scheduler
+ * task, using epoll where it is available.
+ *
+ * @return New chat poller
+ */
+struct GNUNET_CHAT_InternalPoller*
+internal_poller_create (void);
+
+/**
+ * Destroys a <i>poller</i> structure, cancelling its task and
+ * dropping all of its registered file descriptors.
+ *
+ * @param[out] poller Chat poller
+ */
+void
+internal_poller_destroy (struct GNUNET_CHAT_InternalPoller *poller);
+
+/**
+ * Registers a file descriptor <i>fd</i> in a selected
+ * <i>poller</i> structure, so that a custom <i>callback</i>
+ * gets called with its closure whenever the file descriptor
+ * is readable. The callback needs to consume the available
+ * data, otherwise it will be called again.
+ *
+ * @param[in,out] poller Chat poller
+ * @param[in] fd File descriptor
+ * @param[in] callback Callback for readability
+ * @param[in,out] cls Closure for readability
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_poller_add (struct GNUNET_CHAT_InternalPoller *poller,
+                     int fd,
+                     GNUNET_CHAT_PollerCallback callback,
+                     void *cls);
+
+/**
+ * Unregisters a file descriptor <i>fd</i> from a selected
+ * <i>poller</i> structure. Its callback will not be called
+ * anymore afterwards.
+ *
+ * @param[in,out] poller Chat poller
+ * @param[in] fd File descriptor
+ */
+void
+internal_poller_remove (struct GNUNET_CHAT_InternalPoller *poller,
+                        int fd);
+
+#endif /* GNUNET_CHAT_INTERNAL_POLLER_H_ */
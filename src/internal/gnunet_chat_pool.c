@@ -0,0 +1,151 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_pool.c
+ */
+
+#include "gnunet_chat_pool.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <stdint.h>
+#include <string.h>
+
+struct GNUNET_CHAT_InternalPool*
+internal_pool_create (size_t element_size,
+                      unsigned int slab_length)
+{
+  GNUNET_assert((element_size > 0) && (slab_length > 0));
+
+  struct GNUNET_CHAT_InternalPool* pool = GNUNET_new(struct GNUNET_CHAT_InternalPool);
+
+  if (element_size < sizeof(void*))
+    element_size = sizeof(void*);
+
+  const size_t alignment = sizeof(uint64_t);
+
+  pool->element_size = ((element_size + alignment - 1) / alignment) * alignment;
+  pool->slab_length = slab_length;
+
+  pool->head = NULL;
+  pool->tail = NULL;
+
+  pool->free_list = NULL;
+  pool->used = 0;
+
+  pool->objects = 0;
+  pool->allocations = 0;
+
+  return pool;
+}
+
+static void
+release_pool_slabs (struct GNUNET_CHAT_InternalPool *pool)
+{
+  GNUNET_assert(pool);
+
+  struct GNUNET_CHAT_InternalPoolSlab *slab;
+  while (pool->head)
+  {
+    slab = pool->head;
+
+    GNUNET_CONTAINER_DLL_remove(
+      pool->head,
+      pool->tail,
+      slab
+    );
+
+    GNUNET_free(slab);
+  }
+
+  pool->free_list = NULL;
+  pool->used = 0;
+}
+
+void
+internal_pool_destroy (struct GNUNET_CHAT_InternalPool *pool)
+{
+  GNUNET_assert(pool);
+
+  release_pool_slabs(pool);
+
+  GNUNET_free(pool);
+}
+
+static void
+grow_pool_slabs (struct GNUNET_CHAT_InternalPool *pool)
+{
+  GNUNET_assert(pool);
+
+  struct GNUNET_CHAT_InternalPoolSlab *slab = GNUNET_malloc(
+    sizeof(*slab) + pool->element_size * pool->slab_length
+  );
+
+  pool->allocations++;
+
+  GNUNET_CONTAINER_DLL_insert(
+    pool->head,
+    pool->tail,
+    slab
+  );
+
+  uint8_t *elements = (uint8_t*) (slab + 1);
+
+  for (unsigned int i = pool->slab_length; i > 0; i--)
+  {
+    void **element = (void**) (elements + pool->element_size * (i - 1));
+
+    *element = pool->free_list;
+    pool->free_list = element;
+  }
+}
+
+void*
+internal_pool_alloc (struct GNUNET_CHAT_InternalPool *pool)
+{
+  GNUNET_assert(pool);
+
+  if (!(pool->free_list))
+    grow_pool_slabs(pool);
+
+  void **element = pool->free_list;
+  pool->free_list = *element;
+
+  pool->objects++;
+  pool->used++;
+
+  memset(element, 0, pool->element_size);
+  return element;
+}
+
+void
+internal_pool_free (struct GNUNET_CHAT_InternalPool *pool,
+                    void *object)
+{
+  GNUNET_assert((pool) && (object) && (pool->used > 0));
+
+  void **element = object;
+
+  *element = pool->free_list;
+  pool->free_list = element;
+
+  pool->used--;
+}
@@ -0,0 +1,95 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_pool.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_POOL_H_
+#define GNUNET_CHAT_INTERNAL_POOL_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_InternalPoolSlab
+{
+  struct GNUNET_CHAT_InternalPoolSlab *next;
+  struct GNUNET_CHAT_InternalPoolSlab *prev;
+};
+
+struct GNUNET_CHAT_InternalPool
+{
+  size_t element_size;
+  unsigned int slab_length;
+
+  struct GNUNET_CHAT_InternalPoolSlab *head;
+  struct GNUNET_CHAT_InternalPoolSlab *tail;
+
+  void *free_list;
+  unsigned int used;
+
+  unsigned long long objects;
+  unsigned long long allocations;
+};
+
+/**
+ * Creates a pool structure to allocate objects of a fixed
+ * <i>element_size</i> from slabs holding <i>slab_length</i>
+ * objects each.
+ *
+ * @param[in] element_size Size of objects
+ * @param[in] slab_length Amount of objects per slab
+ * @return New chat pool
+ */
+struct GNUNET_CHAT_InternalPool*
+internal_pool_create (size_t element_size,
+                      unsigned int slab_length);
+
+/**
+ * Destroys a <i>pool</i> structure releasing all of its slabs
+ * at once. Objects allocated from the pool get invalid.
+ *
+ * @param[out] pool Chat pool
+ */
+void
+internal_pool_destroy (struct GNUNET_CHAT_InternalPool *pool);
+
+/**
+ * Allocates a zeroed object from a selected <i>pool</i>
+ * structure.
+ *
+ * @param[in,out] pool Chat pool
+ * @return New object
+ */
+void*
+internal_pool_alloc (struct GNUNET_CHAT_InternalPool *pool);
+
+/**
+ * Returns an <i>object</i> to a selected <i>pool</i> structure
+ * which it was allocated from before.
+ *
+ * @param[in,out] pool Chat pool
+ * @param[in,out] object Object
+ */
+void
+internal_pool_free (struct GNUNET_CHAT_InternalPool *pool,
+                    void *object);
+
+#endif /* GNUNET_CHAT_INTERNAL_POOL_H_ */
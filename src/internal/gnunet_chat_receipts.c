@@ -0,0 +1,141 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_receipts.c
+ */
+
+#include "gnunet_chat_receipts.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const unsigned int initial_array_size_of_receipts = 8;
+
+struct GNUNET_CHAT_InternalReceipts*
+internal_receipts_create (unsigned int initial_size)
+{
+  struct GNUNET_CHAT_InternalReceipts* receipts = GNUNET_new(struct GNUNET_CHAT_InternalReceipts);
+
+  if (initial_size < initial_array_size_of_receipts)
+    initial_size = initial_array_size_of_receipts;
+
+  receipts->timestamps = NULL;
+  receipts->count = 0;
+  receipts->size = 0;
+
+  GNUNET_array_grow(receipts->timestamps, receipts->size, initial_size);
+  return receipts;
+}
+
+void
+internal_receipts_destroy (struct GNUNET_CHAT_InternalReceipts *receipts)
+{
+  GNUNET_assert(receipts);
+
+  GNUNET_array_grow(receipts->timestamps, receipts->size, 0);
+
+  GNUNET_free(receipts);
+}
+
+static unsigned int
+find_lower_bound (const struct GNUNET_CHAT_InternalReceipts *receipts,
+                  struct GNUNET_TIME_Absolute timestamp)
+{
+  GNUNET_assert(receipts);
+
+  unsigned int lower = 0;
+  unsigned int upper = receipts->count;
+
+  while (lower < upper)
+  {
+    const unsigned int middle = lower + (upper - lower) / 2;
+
+    if (receipts->timestamps[middle].abs_value_us < timestamp.abs_value_us)
+      lower = middle + 1;
+    else
+      upper = middle;
+  }
+
+  return lower;
+}
+
+void
+internal_receipts_update (struct GNUNET_CHAT_InternalReceipts *receipts,
+                          const struct GNUNET_TIME_Absolute *previous,
+                          struct GNUNET_TIME_Absolute timestamp)
+{
+  GNUNET_assert(receipts);
+
+  unsigned int index;
+
+  if (previous)
+  {
+    index = find_lower_bound(receipts, *previous);
+
+    if ((index < receipts->count) &&
+        (receipts->timestamps[index].abs_value_us == previous->abs_value_us))
+    {
+      receipts->count--;
+
+      memmove(
+        receipts->timestamps + index,
+        receipts->timestamps + index + 1,
+        (receipts->count - index) * sizeof(*(receipts->timestamps))
+      );
+    }
+  }
+
+  if (receipts->count >= receipts->size)
+    GNUNET_array_grow(
+      receipts->timestamps,
+      receipts->size,
+      receipts->size? receipts->size * 2 : initial_array_size_of_receipts
+    );
+
+  index = find_lower_bound(receipts, timestamp);
+
+  memmove(
+    receipts->timestamps + index + 1,
+    receipts->timestamps + index,
+    (receipts->count - index) * sizeof(*(receipts->timestamps))
+  );
+
+  receipts->timestamps[index] = timestamp;
+  receipts->count++;
+}
+
+void
+internal_receipts_clear (struct GNUNET_CHAT_InternalReceipts *receipts)
+{
+  GNUNET_assert(receipts);
+
+  receipts->count = 0;
+}
+
+unsigned int
+internal_receipts_count (const struct GNUNET_CHAT_InternalReceipts *receipts,
+                         struct GNUNET_TIME_Absolute timestamp)
+{
+  GNUNET_assert(receipts);
+
+  return receipts->count - find_lower_bound(receipts, timestamp);
+}
@@ -0,0 +1,95 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_receipts.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_RECEIPTS_H_
+#define GNUNET_CHAT_INTERNAL_RECEIPTS_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_InternalReceipts
+{
+  struct GNUNET_TIME_Absolute *timestamps;
+  unsigned int count;
+  unsigned int size;
+};
+
+/**
+ * Creates a receipts structure to keep the latest timestamps
+ * of members sorted for counting read receipts.
+ *
+ * @param[in] initial_size Expected amount of members
+ * @return New chat receipts
+ */
+struct GNUNET_CHAT_InternalReceipts*
+internal_receipts_create (unsigned int initial_size);
+
+/**
+ * Destroys a <i>receipts</i> structure to keep the latest
+ * timestamps of members sorted.
+ *
+ * @param[out] receipts Chat receipts
+ */
+void
+internal_receipts_destroy (struct GNUNET_CHAT_InternalReceipts *receipts);
+
+/**
+ * Updates the latest timestamp of a member in a selected
+ * <i>receipts</i> structure from its <i>previous</i> value
+ * to a new <i>timestamp</i>. If <i>previous</i> is NULL, the
+ * member gets added instead.
+ *
+ * @param[in,out] receipts Chat receipts
+ * @param[in] previous Previous timestamp of the member or NULL
+ * @param[in] timestamp New timestamp of the member
+ */
+void
+internal_receipts_update (struct GNUNET_CHAT_InternalReceipts *receipts,
+                          const struct GNUNET_TIME_Absolute *previous,
+                          struct GNUNET_TIME_Absolute timestamp);
+
+/**
+ * Removes all timestamps from a selected <i>receipts</i>
+ * structure.
+ *
+ * @param[in,out] receipts Chat receipts
+ */
+void
+internal_receipts_clear (struct GNUNET_CHAT_InternalReceipts *receipts);
+
+/**
+ * Returns the amount of members in a selected <i>receipts</i>
+ * structure with a latest timestamp not before a given
+ * <i>timestamp</i>.
+ *
+ * @param[in] receipts Chat receipts
+ * @param[in] timestamp Timestamp
+ * @return Amount of members
+ */
+unsigned int
+internal_receipts_count (const struct GNUNET_CHAT_InternalReceipts *receipts,
+                         struct GNUNET_TIME_Absolute timestamp);
+
+#endif /* GNUNET_CHAT_INTERNAL_RECEIPTS_H_ */
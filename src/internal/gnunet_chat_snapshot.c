@@ -0,0 +1,240 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_snapshot.c
+ */
+
+#include "gnunet_chat_snapshot.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const size_t max_name_size_of_snapshot = UINT16_MAX;
+
+struct GNUNET_CHAT_InternalSnapshot*
+internal_snapshot_create (const char *filename)
+{
+  GNUNET_assert(filename);
+
+  struct GNUNET_CHAT_InternalSnapshot* snapshot = GNUNET_new(struct GNUNET_CHAT_InternalSnapshot);
+
+  snapshot->filename = GNUNET_strdup(filename);
+
+  snapshot->buffer = NULL;
+  snapshot->size = 0;
+  snapshot->count = 0;
+
+  return snapshot;
+}
+
+void
+internal_snapshot_destroy (struct GNUNET_CHAT_InternalSnapshot *snapshot)
+{
+  GNUNET_assert((snapshot) && (snapshot->filename));
+
+  if (snapshot->buffer)
+    GNUNET_free(snapshot->buffer);
+
+  GNUNET_free(snapshot->filename);
+  GNUNET_free(snapshot);
+}
+
+static uint16_t
+get_snapshot_name_size (const char *name)
+{
+  if (!name)
+    return 0;
+
+  const size_t size = strlen(name) + 1;
+
+  if (size > max_name_size_of_snapshot)
+    return 0;
+
+  return (uint16_t) size;
+}
+
+void
+internal_snapshot_add (struct GNUNET_CHAT_InternalSnapshot *snapshot,
+                       const struct GNUNET_HashCode *key,
+                       const struct GNUNET_PeerIdentity *door,
+                       uint32_t type,
+                       uint32_t flags,
+                       const char *nick,
+                       const char *topic)
+{
+  GNUNET_assert((snapshot) && (key) && (door));
+
+  const uint16_t nick_size = get_snapshot_name_size(nick);
+  const uint16_t topic_size = get_snapshot_name_size(topic);
+
+  struct GNUNET_CHAT_InternalSnapshotRecord record;
+  GNUNET_memcpy(&(record.key), key, sizeof(record.key));
+  GNUNET_memcpy(&(record.door), door, sizeof(record.door));
+
+  record.type = htonl(type);
+  record.flags = htonl(flags);
+  record.nick_size = htons(nick_size);
+  record.topic_size = htons(topic_size);
+
+  const size_t offset = snapshot->size;
+  const size_t size = sizeof(record) + nick_size + topic_size;
+
+  snapshot->buffer = GNUNET_realloc(snapshot->buffer, offset + size);
+  snapshot->size = offset + size;
+
+  char *data = snapshot->buffer + offset;
+
+  GNUNET_memcpy(data, &record, sizeof(record));
+  data += sizeof(record);
+
+  if (nick_size)
+    GNUNET_memcpy(data, nick, nick_size);
+
+  data += nick_size;
+
+  if (topic_size)
+    GNUNET_memcpy(data, topic, topic_size);
+
+  snapshot->count++;
+}
+
+enum GNUNET_GenericReturnValue
+internal_snapshot_store (const struct GNUNET_CHAT_InternalSnapshot *snapshot)
+{
+  GNUNET_assert((snapshot) && (snapshot->filename));
+
+  struct GNUNET_CHAT_InternalSnapshotHeader header;
+  header.magic = htonl(GNUNET_CHAT_INTERNAL_SNAPSHOT_MAGIC);
+  header.version = htonl(GNUNET_CHAT_INTERNAL_SNAPSHOT_VERSION);
+  header.count = htonl(snapshot->count);
+
+  const size_t size = sizeof(header) + snapshot->size;
+  char *data = GNUNET_malloc(size);
+
+  GNUNET_memcpy(data, &header, sizeof(header));
+
+  if (snapshot->size)
+    GNUNET_memcpy(data + sizeof(header), snapshot->buffer, snapshot->size);
+
+  enum GNUNET_GenericReturnValue result = GNUNET_SYSERR;
+
+  if (GNUNET_OK != GNUNET_DISK_directory_create_for_file(snapshot->filename))
+    goto free_data;
+
+  result = GNUNET_DISK_fn_write(
+    snapshot->filename, data, size,
+    GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+  );
+
+free_data:
+  GNUNET_free(data);
+  return result;
+}
+
+static const char*
+get_snapshot_name (const char *data,
+                   uint16_t size)
+{
+  if ((!size) || ('\0' != data[size - 1]))
+    return NULL;
+
+  return data;
+}
+
+int
+internal_snapshot_iterate (const struct GNUNET_CHAT_InternalSnapshot *snapshot,
+                           GNUNET_CHAT_SnapshotCallback cb,
+                           void *cls)
+{
+  GNUNET_assert((snapshot) && (snapshot->filename));
+
+  if (GNUNET_YES != GNUNET_DISK_file_test_read(snapshot->filename))
+    return 0;
+
+  uint64_t size;
+  if (GNUNET_OK != GNUNET_DISK_file_size(snapshot->filename, &size,
+                                         GNUNET_NO, GNUNET_YES))
+    return GNUNET_SYSERR;
+
+  const struct GNUNET_CHAT_InternalSnapshotHeader *header;
+
+  if (size < sizeof(*header))
+    return 0;
+
+  struct GNUNET_DISK_FileHandle *file = GNUNET_DISK_file_open(
+    snapshot->filename, GNUNET_DISK_OPEN_READ, GNUNET_DISK_PERM_USER_READ
+  );
+
+  if (!file)
+    return GNUNET_SYSERR;
+
+  int result = GNUNET_SYSERR;
+
+  struct GNUNET_DISK_MapHandle *map;
+  const char *data = GNUNET_DISK_file_map(
+    file, &map, GNUNET_DISK_MAP_TYPE_READ, (size_t) size
+  );
+
+  if (!data)
+    goto close_file;
+
+  header = (const struct GNUNET_CHAT_InternalSnapshotHeader*) data;
+  result = 0;
+
+  if ((GNUNET_CHAT_INTERNAL_SNAPSHOT_MAGIC != ntohl(header->magic)) ||
+      (GNUNET_CHAT_INTERNAL_SNAPSHOT_VERSION != ntohl(header->version)))
+    goto unmap_file;
+
+  const unsigned int count = ntohl(header->count);
+
+  const struct GNUNET_CHAT_InternalSnapshotRecord *record;
+  size_t offset = sizeof(*header);
+
+  while ((offset + sizeof(*record) <= size) && ((unsigned int) result < count))
+  {
+    record = (const struct GNUNET_CHAT_InternalSnapshotRecord*) (data + offset);
+
+    const uint16_t nick_size = ntohs(record->nick_size);
+    const uint16_t topic_size = ntohs(record->topic_size);
+
+    if (offset + sizeof(*record) + nick_size + topic_size > size)
+      break;
+
+    const char *names = (const char*) (record + 1);
+
+    result++;
+
+    if ((cb) && (GNUNET_YES != cb(cls, record,
+                                  get_snapshot_name(names, nick_size),
+                                  get_snapshot_name(names + nick_size, topic_size))))
+      break;
+
+    offset += sizeof(*record) + nick_size + topic_size;
+  }
+
+unmap_file:
+  GNUNET_DISK_file_unmap(map);
+
+close_file:
+  GNUNET_DISK_file_close(file);
+  return result;
+}
@@ -0,0 +1,138 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_snapshot.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_SNAPSHOT_H_
+#define GNUNET_CHAT_INTERNAL_SNAPSHOT_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+
+#define GNUNET_CHAT_INTERNAL_SNAPSHOT_MAGIC 0x47435350
+#define GNUNET_CHAT_INTERNAL_SNAPSHOT_VERSION 1
+
+GNUNET_NETWORK_STRUCT_BEGIN
+
+struct GNUNET_CHAT_InternalSnapshotHeader
+{
+  uint32_t magic GNUNET_PACKED;
+  uint32_t version GNUNET_PACKED;
+  uint32_t count GNUNET_PACKED;
+};
+
+struct GNUNET_CHAT_InternalSnapshotRecord
+{
+  struct GNUNET_HashCode key;
+  struct GNUNET_PeerIdentity door;
+  uint32_t type GNUNET_PACKED;
+  uint32_t flags GNUNET_PACKED;
+  uint16_t nick_size GNUNET_PACKED;
+  uint16_t topic_size GNUNET_PACKED;
+};
+
+GNUNET_NETWORK_STRUCT_END
+
+struct GNUNET_CHAT_InternalSnapshot
+{
+  char *filename;
+
+  char *buffer;
+  size_t size;
+  unsigned int count;
+};
+
+typedef enum GNUNET_GenericReturnValue
+(*GNUNET_CHAT_SnapshotCallback) (void *cls,
+                                 const struct GNUNET_CHAT_InternalSnapshotRecord *record,
+                                 const char *nick,
+                                 const char *topic);
+
+/**
+ * Creates a snapshot structure to store and restore the
+ * state of chat contexts in a versioned binary file with
+ * a given <i>filename</i>.
+ *
+ * @param[in] filename Path of the snapshot file
+ * @return New chat snapshot
+ */
+struct GNUNET_CHAT_InternalSnapshot*
+internal_snapshot_create (const char *filename);
+
+/**
+ * Destroys a <i>snapshot</i> structure to store and restore
+ * the state of chat contexts without writing its file.
+ *
+ * @param[out] snapshot Chat snapshot
+ */
+void
+internal_snapshot_destroy (struct GNUNET_CHAT_InternalSnapshot *snapshot);
+
+/**
+ * Adds a record of a chat context with its room <i>key</i>,
+ * <i>door</i>, <i>type</i>, <i>flags</i>, <i>nick</i> and
+ * <i>topic</i> to a selected <i>snapshot</i> structure.
+ *
+ * @param[in,out] snapshot Chat snapshot
+ * @param[in] key Room key
+ * @param[in] door Peer identity of the door
+ * @param[in] type Context type
+ * @param[in] flags Context flags
+ * @param[in] nick Nick of the context or NULL
+ * @param[in] topic Topic of the context or NULL
+ */
+void
+internal_snapshot_add (struct GNUNET_CHAT_InternalSnapshot *snapshot,
+                       const struct GNUNET_HashCode *key,
+                       const struct GNUNET_PeerIdentity *door,
+                       uint32_t type,
+                       uint32_t flags,
+                       const char *nick,
+                       const char *topic);
+
+/**
+ * Writes all records added to a selected <i>snapshot</i>
+ * structure to its file replacing the previous snapshot.
+ *
+ * @param[in] snapshot Chat snapshot
+ * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_snapshot_store (const struct GNUNET_CHAT_InternalSnapshot *snapshot);
+
+/**
+ * Maps the file of a selected <i>snapshot</i> structure into
+ * memory and iterates through its records with a custom
+ * callback and closure. Files of a different version are
+ * ignored.
+ *
+ * @param[in] snapshot Chat snapshot
+ * @param[in] cb Callback for iteration
+ * @param[in,out] cls Closure for iteration
+ * @return Amount of records iterated or #GNUNET_SYSERR on failure
+ */
+int
+internal_snapshot_iterate (const struct GNUNET_CHAT_InternalSnapshot *snapshot,
+                           GNUNET_CHAT_SnapshotCallback cb,
+                           void *cls);
+
+#endif /* GNUNET_CHAT_INTERNAL_SNAPSHOT_H_ */
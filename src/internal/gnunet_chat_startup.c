@@ -0,0 +1,105 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_startup.c
+ */
+
+#include "gnunet_chat_startup.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_InternalStartup*
+internal_startup_create ()
+{
+  struct GNUNET_CHAT_InternalStartup* startup = GNUNET_new(struct GNUNET_CHAT_InternalStartup);
+
+  for (unsigned int i = 0; i < GNUNET_CHAT_STARTUP_PHASE_COUNT; i++)
+  {
+    startup->begin[i] = GNUNET_TIME_absolute_get_zero_();
+    startup->end[i] = GNUNET_TIME_absolute_get_zero_();
+  }
+
+  return startup;
+}
+
+void
+internal_startup_destroy (struct GNUNET_CHAT_InternalStartup *startup)
+{
+  GNUNET_assert(startup);
+
+  GNUNET_free(startup);
+}
+
+void
+internal_startup_begin (struct GNUNET_CHAT_InternalStartup *startup,
+                        enum GNUNET_CHAT_InternalStartupPhase phase)
+{
+  GNUNET_assert((startup) && (phase < GNUNET_CHAT_STARTUP_PHASE_COUNT));
+
+  if ((! GNUNET_TIME_absolute_is_zero(startup->begin[phase])) &&
+      (GNUNET_TIME_absolute_is_zero(startup->end[phase])))
+    return;
+
+  startup->begin[phase] = GNUNET_TIME_absolute_get();
+  startup->end[phase] = GNUNET_TIME_absolute_get_zero_();
+}
+
+void
+internal_startup_end (struct GNUNET_CHAT_InternalStartup *startup,
+                      enum GNUNET_CHAT_InternalStartupPhase phase)
+{
+  GNUNET_assert((startup) && (phase < GNUNET_CHAT_STARTUP_PHASE_COUNT));
+
+  if ((GNUNET_TIME_absolute_is_zero(startup->begin[phase])) ||
+      (! GNUNET_TIME_absolute_is_zero(startup->end[phase])))
+    return;
+
+  startup->end[phase] = GNUNET_TIME_absolute_get();
+}
+
+enum GNUNET_GenericReturnValue
+internal_startup_get (const struct GNUNET_CHAT_InternalStartup *startup,
+                      enum GNUNET_CHAT_InternalStartupPhase phase,
+                      struct GNUNET_TIME_Relative *duration)
+{
+  GNUNET_assert((startup) && (phase < GNUNET_CHAT_STARTUP_PHASE_COUNT));
+
+  if (GNUNET_TIME_absolute_is_zero(startup->begin[phase]))
+  {
+    if (duration)
+      *duration = GNUNET_TIME_relative_get_zero_();
+
+    return GNUNET_SYSERR;
+  }
+
+  const enum GNUNET_GenericReturnValue completed = (
+    GNUNET_TIME_absolute_is_zero(startup->end[phase])? GNUNET_NO : GNUNET_YES
+  );
+
+  if (duration)
+    *duration = GNUNET_TIME_absolute_get_difference(
+      startup->begin[phase],
+      GNUNET_YES == completed? startup->end[phase] : GNUNET_TIME_absolute_get()
+    );
+
+  return completed;
+}
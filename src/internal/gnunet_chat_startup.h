@@ -0,0 +1,105 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_startup.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_STARTUP_H_
+#define GNUNET_CHAT_INTERNAL_STARTUP_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+enum GNUNET_CHAT_InternalStartupPhase
+{
+  GNUNET_CHAT_STARTUP_PHASE_SERVICES = 0,
+  GNUNET_CHAT_STARTUP_PHASE_IDENTITY = 1,
+  GNUNET_CHAT_STARTUP_PHASE_ZONE = 2,
+  GNUNET_CHAT_STARTUP_PHASE_MESSENGER = 3,
+
+  GNUNET_CHAT_STARTUP_PHASE_COUNT = 4
+};
+
+struct GNUNET_CHAT_InternalStartup
+{
+  struct GNUNET_TIME_Absolute begin [GNUNET_CHAT_STARTUP_PHASE_COUNT];
+  struct GNUNET_TIME_Absolute end [GNUNET_CHAT_STARTUP_PHASE_COUNT];
+};
+
+/**
+ * Creates a startup structure to profile the durations of
+ * the phases to start a chat handle and connect an account.
+ *
+ * @return New chat startup
+ */
+struct GNUNET_CHAT_InternalStartup*
+internal_startup_create ();
+
+/**
+ * Destroys a <i>startup</i> structure to profile the
+ * phases of starting a chat handle.
+ *
+ * @param[out] startup Chat startup
+ */
+void
+internal_startup_destroy (struct GNUNET_CHAT_InternalStartup *startup);
+
+/**
+ * Begins a given <i>phase</i> in a selected <i>startup</i>
+ * structure unless the phase is already in progress. A phase
+ * which completed before gets restarted.
+ *
+ * @param[in,out] startup Chat startup
+ * @param[in] phase Startup phase
+ */
+void
+internal_startup_begin (struct GNUNET_CHAT_InternalStartup *startup,
+                        enum GNUNET_CHAT_InternalStartupPhase phase);
+
+/**
+ * Completes a given <i>phase</i> in a selected <i>startup</i>
+ * structure if it is in progress.
+ *
+ * @param[in,out] startup Chat startup
+ * @param[in] phase Startup phase
+ */
+void
+internal_startup_end (struct GNUNET_CHAT_InternalStartup *startup,
+                      enum GNUNET_CHAT_InternalStartupPhase phase);
+
+/**
+ * Returns the <i>duration</i> of a given <i>phase</i> in a
+ * selected <i>startup</i> structure. The duration of a phase
+ * in progress is measured until now.
+ *
+ * @param[in] startup Chat startup
+ * @param[in] phase Startup phase
+ * @param[out] duration Duration of the phase
+ * @return #GNUNET_YES if the phase completed, #GNUNET_NO if it
+ *   is in progress and #GNUNET_SYSERR if it did not begin
+ */
+enum GNUNET_GenericReturnValue
+internal_startup_get (const struct GNUNET_CHAT_InternalStartup *startup,
+                      enum GNUNET_CHAT_InternalStartupPhase phase,
+                      struct GNUNET_TIME_Relative *duration);
+
+#endif /* GNUNET_CHAT_INTERNAL_STARTUP_H_ */
@@ -0,0 +1,469 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_store.c
+ */
+
+#include "gnunet_chat_store.h"
+#include "gnunet_chat_util.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+static const unsigned int initial_map_size_of_store = 8;
+
+static struct GNUNET_CHAT_InternalStoreEntry*
+get_store_entry (struct GNUNET_CHAT_InternalStore *store,
+                 const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((store) && (hash));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(store->entries, hash);
+
+  if (entry)
+    return entry;
+
+  entry = GNUNET_new(struct GNUNET_CHAT_InternalStoreEntry);
+
+  GNUNET_memcpy(&(entry->hash), hash, sizeof(entry->hash));
+
+  entry->size = 0;
+  entry->references = 0;
+
+  entry->stored = GNUNET_NO;
+  entry->listed = GNUNET_NO;
+  entry->collecting = GNUNET_NO;
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      store->entries, hash, entry,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    GNUNET_free(entry);
+    return NULL;
+  }
+
+  return entry;
+}
+
+static void
+update_store_entry (struct GNUNET_CHAT_InternalStore *store,
+                    struct GNUNET_CHAT_InternalStoreEntry *entry,
+                    enum GNUNET_GenericReturnValue collectable)
+{
+  GNUNET_assert((store) && (entry));
+
+  const enum GNUNET_GenericReturnValue listed = (
+    (GNUNET_YES == collectable) &&
+    (GNUNET_YES == entry->stored) &&
+    (GNUNET_NO == entry->collecting) &&
+    (0 == entry->references)
+  )? GNUNET_YES : GNUNET_NO;
+
+  if ((GNUNET_YES == entry->listed) && (GNUNET_YES != listed))
+    GNUNET_CONTAINER_DLL_remove(store->head, store->tail, entry);
+  else if ((GNUNET_YES != entry->listed) && (GNUNET_YES == listed))
+    GNUNET_CONTAINER_DLL_insert_tail(store->head, store->tail, entry);
+
+  entry->listed = listed;
+
+  if ((GNUNET_YES == entry->stored) || (GNUNET_YES == entry->collecting) ||
+      (entry->references > 0))
+    return;
+
+  GNUNET_CONTAINER_multihashmap_remove(store->entries, &(entry->hash), entry);
+  GNUNET_free(entry);
+}
+
+static void
+store_entry_file (struct GNUNET_CHAT_InternalStore *store,
+                  struct GNUNET_CHAT_InternalStoreEntry *entry,
+                  const char *filename,
+                  enum GNUNET_GenericReturnValue collectable)
+{
+  GNUNET_assert((store) && (entry) && (filename));
+
+  uint64_t size;
+  if (GNUNET_OK != GNUNET_DISK_file_size(filename, &size, GNUNET_NO, GNUNET_YES))
+    size = 0;
+
+  if (GNUNET_YES == entry->stored)
+    store->usage -= entry->size;
+
+  entry->size = size;
+  entry->stored = GNUNET_YES;
+
+  store->usage += entry->size;
+
+  update_store_entry(store, entry, collectable);
+}
+
+static enum GNUNET_GenericReturnValue
+it_scan_store_file (void *cls,
+                    const char *filename)
+{
+  GNUNET_assert((cls) && (filename));
+
+  struct GNUNET_CHAT_InternalStore *store = cls;
+  const char *name = GNUNET_STRINGS_get_short_name(filename);
+
+  struct GNUNET_HashCode hash;
+  if (GNUNET_OK != GNUNET_CRYPTO_hash_from_string2(name, strlen(name), &hash))
+    return GNUNET_OK;
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = get_store_entry(store, &hash);
+
+  if (entry)
+    store_entry_file(store, entry, filename, GNUNET_NO);
+
+  return GNUNET_OK;
+}
+
+struct GNUNET_CHAT_InternalStore*
+internal_store_create (const char *directory)
+{
+  GNUNET_assert(directory);
+
+  struct GNUNET_CHAT_InternalStore* store = GNUNET_new(struct GNUNET_CHAT_InternalStore);
+
+  store->directory = GNUNET_strdup(directory);
+  store->entries = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_store, GNUNET_NO);
+
+  store->head = NULL;
+  store->tail = NULL;
+
+  store->usage = 0;
+  store->pending = 0;
+  store->quota = 0;
+
+  char *dirname;
+  util_get_dirname(store->directory, "files", &dirname);
+
+  if (GNUNET_YES == GNUNET_DISK_directory_test(dirname, GNUNET_YES))
+    GNUNET_DISK_directory_scan(dirname, it_scan_store_file, store);
+
+  GNUNET_free(dirname);
+  return store;
+}
+
+static enum GNUNET_GenericReturnValue
+it_destroy_store_entries (GNUNET_UNUSED void *cls,
+                          GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                          void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = value;
+  GNUNET_free(entry);
+  return GNUNET_YES;
+}
+
+void
+internal_store_destroy (struct GNUNET_CHAT_InternalStore *store)
+{
+  GNUNET_assert((store) && (store->entries));
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    store->entries, it_destroy_store_entries, NULL
+  );
+
+  GNUNET_CONTAINER_multihashmap_destroy(store->entries);
+
+  GNUNET_free(store->directory);
+  GNUNET_free(store);
+}
+
+static enum GNUNET_GenericReturnValue
+clone_store_file (const char *source,
+                  const char *target)
+{
+  GNUNET_assert((source) && (target));
+
+#ifdef FICLONE
+  const int source_fd = open(source, O_RDONLY);
+
+  if (source_fd < 0)
+    goto skip_reflink;
+
+  const int target_fd = open(
+    target, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR
+  );
+
+  if (target_fd < 0)
+  {
+    close(source_fd);
+    goto skip_reflink;
+  }
+
+  const int result = ioctl(target_fd, FICLONE, source_fd);
+
+  close(target_fd);
+  close(source_fd);
+
+  if (0 == result)
+    return GNUNET_OK;
+
+  remove(target);
+
+skip_reflink:
+#endif
+  if (0 == link(source, target))
+    return GNUNET_OK;
+
+  return GNUNET_DISK_file_copy(source, target);
+}
+
+static enum GNUNET_GenericReturnValue
+transfer_store_file (struct GNUNET_CHAT_InternalStore *store,
+                     const char *path,
+                     const struct GNUNET_HashCode *hash,
+                     enum GNUNET_GenericReturnValue move)
+{
+  GNUNET_assert((store) && (path) && (hash));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = get_store_entry(store, hash);
+
+  if (!entry)
+    return GNUNET_SYSERR;
+
+  char *filename;
+  util_get_filename(store->directory, "files", hash, &filename);
+
+  enum GNUNET_GenericReturnValue result;
+
+  if (GNUNET_YES == GNUNET_DISK_file_test(filename))
+  {
+    if (GNUNET_YES == move)
+      remove(path);
+
+    result = GNUNET_NO;
+    goto account_file;
+  }
+
+  if (GNUNET_OK != GNUNET_DISK_directory_create_for_file(filename))
+    result = GNUNET_SYSERR;
+  else if (GNUNET_YES == move)
+    result = (0 == rename(path, filename))? GNUNET_OK : GNUNET_SYSERR;
+  else
+    result = clone_store_file(path, filename);
+
+  if (GNUNET_OK != result)
+  {
+    if (GNUNET_YES != move)
+      remove(filename);
+
+    update_store_entry(store, entry, GNUNET_YES);
+    GNUNET_free(filename);
+    return GNUNET_SYSERR;
+  }
+
+account_file:
+  if ((GNUNET_OK == result) || (GNUNET_YES != entry->stored))
+    store_entry_file(store, entry, filename, GNUNET_YES);
+
+  GNUNET_free(filename);
+  return result;
+}
+
+enum GNUNET_GenericReturnValue
+internal_store_import (struct GNUNET_CHAT_InternalStore *store,
+                       const char *path,
+                       const struct GNUNET_HashCode *hash)
+{
+  return transfer_store_file(store, path, hash, GNUNET_NO);
+}
+
+enum GNUNET_GenericReturnValue
+internal_store_insert (struct GNUNET_CHAT_InternalStore *store,
+                       const char *path,
+                       const struct GNUNET_HashCode *hash)
+{
+  return transfer_store_file(store, path, hash, GNUNET_YES);
+}
+
+void
+internal_store_add (struct GNUNET_CHAT_InternalStore *store,
+                    const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((store) && (hash));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = get_store_entry(store, hash);
+
+  if (!entry)
+    return;
+
+  char *filename;
+  util_get_filename(store->directory, "files", hash, &filename);
+
+  store_entry_file(store, entry, filename, GNUNET_YES);
+
+  GNUNET_free(filename);
+}
+
+void
+internal_store_remove (struct GNUNET_CHAT_InternalStore *store,
+                       const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((store) && (hash));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(store->entries, hash);
+
+  if (!entry)
+    return;
+
+  if (GNUNET_YES == entry->collecting)
+    store->pending -= entry->size;
+
+  if (GNUNET_YES == entry->stored)
+    store->usage -= entry->size;
+
+  entry->size = 0;
+  entry->stored = GNUNET_NO;
+  entry->collecting = GNUNET_NO;
+
+  update_store_entry(store, entry, GNUNET_YES);
+}
+
+struct GNUNET_CHAT_InternalStoreEntry*
+internal_store_acquire (struct GNUNET_CHAT_InternalStore *store,
+                        const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((store) && (hash));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = get_store_entry(store, hash);
+
+  if (!entry)
+    return NULL;
+
+  entry->references++;
+
+  update_store_entry(store, entry, GNUNET_YES);
+  return entry;
+}
+
+void
+internal_store_release (struct GNUNET_CHAT_InternalStore *store,
+                        struct GNUNET_CHAT_InternalStoreEntry *entry)
+{
+  GNUNET_assert((store) && (entry) && (entry->references > 0));
+
+  entry->references--;
+
+  update_store_entry(store, entry, GNUNET_YES);
+}
+
+void
+internal_store_drop (struct GNUNET_CHAT_InternalStore *store,
+                     struct GNUNET_CHAT_InternalStoreEntry *entry)
+{
+  GNUNET_assert((store) && (entry) && (entry->references > 0));
+
+  entry->references--;
+
+  update_store_entry(store, entry, GNUNET_NO);
+}
+
+enum GNUNET_GenericReturnValue
+internal_store_is_collecting (const struct GNUNET_CHAT_InternalStore *store,
+                              const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((store) && (hash));
+
+  const struct GNUNET_CHAT_InternalStoreEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(store->entries, hash);
+
+  if ((entry) && (GNUNET_YES == entry->collecting))
+    return GNUNET_YES;
+  else
+    return GNUNET_NO;
+}
+
+enum GNUNET_GenericReturnValue
+internal_store_is_exceeded (const struct GNUNET_CHAT_InternalStore *store)
+{
+  GNUNET_assert(store);
+
+  if ((!(store->quota)) || (store->usage - store->pending <= store->quota))
+    return GNUNET_NO;
+  else
+    return GNUNET_YES;
+}
+
+int
+internal_store_collect (struct GNUNET_CHAT_InternalStore *store,
+                        enum GNUNET_GenericReturnValue all,
+                        GNUNET_CHAT_StoreCollectCallback cb,
+                        void *cls)
+{
+  GNUNET_assert((store) && (cb));
+
+  struct GNUNET_CHAT_InternalStoreEntry *entry = store->head;
+  struct GNUNET_CHAT_InternalStoreEntry *prev;
+  struct GNUNET_CHAT_InternalStoreEntry *next;
+
+  int result = 0;
+
+  while (entry)
+  {
+    if ((GNUNET_YES != all) && (GNUNET_YES != internal_store_is_exceeded(store)))
+      break;
+
+    prev = entry->prev;
+    next = entry->next;
+
+    // The entry gets unlisted before the callback because it
+    // might confirm the removal of the file immediately.
+    GNUNET_CONTAINER_DLL_remove(store->head, store->tail, entry);
+
+    entry->listed = GNUNET_NO;
+    entry->collecting = GNUNET_YES;
+    store->pending += entry->size;
+
+    if (GNUNET_YES == cb(cls, &(entry->hash)))
+    {
+      result++;
+      goto next_entry;
+    }
+
+    entry->collecting = GNUNET_NO;
+    store->pending -= entry->size;
+
+    GNUNET_CONTAINER_DLL_insert_after(store->head, store->tail, prev, entry);
+    entry->listed = GNUNET_YES;
+
+next_entry:
+    entry = next;
+  }
+
+  return result;
+}
@@ -0,0 +1,224 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_store.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_STORE_H_
+#define GNUNET_CHAT_INTERNAL_STORE_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+
+struct GNUNET_CHAT_InternalStoreEntry
+{
+  struct GNUNET_HashCode hash;
+  uint64_t size;
+
+  unsigned int references;
+
+  enum GNUNET_GenericReturnValue stored;
+  enum GNUNET_GenericReturnValue listed;
+  enum GNUNET_GenericReturnValue collecting;
+
+  struct GNUNET_CHAT_InternalStoreEntry *prev;
+  struct GNUNET_CHAT_InternalStoreEntry *next;
+};
+
+struct GNUNET_CHAT_InternalStore
+{
+  char *directory;
+
+  struct GNUNET_CONTAINER_MultiHashMap *entries;
+
+  struct GNUNET_CHAT_InternalStoreEntry *head;
+  struct GNUNET_CHAT_InternalStoreEntry *tail;
+
+  uint64_t usage;
+  uint64_t pending;
+  uint64_t quota;
+};
+
+typedef enum GNUNET_GenericReturnValue
+(*GNUNET_CHAT_StoreCollectCallback) (void *cls,
+                                     const struct GNUNET_HashCode *hash);
+
+/**
+ * Creates a store structure to account for the content
+ * addressed files in a given <i>directory</i>. Files which
+ * exist already are accounted but only become subject to
+ * garbage collection once they got referenced and released.
+ *
+ * @param[in] directory Chat directory
+ * @return New chat store
+ */
+struct GNUNET_CHAT_InternalStore*
+internal_store_create (const char *directory);
+
+/**
+ * Destroys a <i>store</i> structure without touching any
+ * of the stored files.
+ *
+ * @param[out] store Chat store
+ */
+void
+internal_store_destroy (struct GNUNET_CHAT_InternalStore *store);
+
+/**
+ * Imports the file from a given <i>path</i> into a selected
+ * <i>store</i> structure under its <i>hash</i>. The file gets
+ * cloned via reflink or hardlink if possible and copied
+ * otherwise. If a file with the same <i>hash</i> is stored
+ * already, nothing gets copied.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] path Source path
+ * @param[in] hash File hash
+ * @return #GNUNET_OK on import, #GNUNET_NO if the file was
+ *   stored already and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_store_import (struct GNUNET_CHAT_InternalStore *store,
+                       const char *path,
+                       const struct GNUNET_HashCode *hash);
+
+/**
+ * Moves a temporary file from a given <i>path</i> into a
+ * selected <i>store</i> structure under its <i>hash</i>. If
+ * a file with the same <i>hash</i> is stored already, the
+ * temporary file gets removed instead.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] path Temporary path
+ * @param[in] hash File hash
+ * @return #GNUNET_OK on insertion, #GNUNET_NO if the file was
+ *   stored already and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_store_insert (struct GNUNET_CHAT_InternalStore *store,
+                       const char *path,
+                       const struct GNUNET_HashCode *hash);
+
+/**
+ * Accounts a file which has been written to its path in
+ * a selected <i>store</i> structure by other means under
+ * its <i>hash</i>, like a completed download.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] hash File hash
+ */
+void
+internal_store_add (struct GNUNET_CHAT_InternalStore *store,
+                    const struct GNUNET_HashCode *hash);
+
+/**
+ * Removes the accounting of a file with a given <i>hash</i>
+ * from a selected <i>store</i> structure after it has been
+ * deleted from disk.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] hash File hash
+ */
+void
+internal_store_remove (struct GNUNET_CHAT_InternalStore *store,
+                       const struct GNUNET_HashCode *hash);
+
+/**
+ * Adds a reference to the file with a given <i>hash</i>
+ * in a selected <i>store</i> structure.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] hash File hash
+ * @return Store entry of the file
+ */
+struct GNUNET_CHAT_InternalStoreEntry*
+internal_store_acquire (struct GNUNET_CHAT_InternalStore *store,
+                        const struct GNUNET_HashCode *hash);
+
+/**
+ * Drops a reference to a given store <i>entry</i> from a
+ * selected <i>store</i> structure. Entries of stored files
+ * without references become subject to garbage collection.
+ *
+ * @param[in,out] store Chat store
+ * @param[in,out] entry Store entry
+ */
+void
+internal_store_release (struct GNUNET_CHAT_InternalStore *store,
+                        struct GNUNET_CHAT_InternalStoreEntry *entry);
+
+/**
+ * Drops a reference to a given store <i>entry</i> from a
+ * selected <i>store</i> structure without making the file
+ * subject to garbage collection, like on teardown of a room
+ * which still uses the file.
+ *
+ * @param[in,out] store Chat store
+ * @param[in,out] entry Store entry
+ */
+void
+internal_store_drop (struct GNUNET_CHAT_InternalStore *store,
+                     struct GNUNET_CHAT_InternalStoreEntry *entry);
+
+/**
+ * Returns whether the file with a given <i>hash</i> is
+ * getting collected from a selected <i>store</i> structure.
+ *
+ * @param[in] store Chat store
+ * @param[in] hash File hash
+ * @return #GNUNET_YES if the file gets collected, otherwise #GNUNET_NO
+ */
+enum GNUNET_GenericReturnValue
+internal_store_is_collecting (const struct GNUNET_CHAT_InternalStore *store,
+                              const struct GNUNET_HashCode *hash);
+
+/**
+ * Returns whether the usage of a selected <i>store</i> structure
+ * exceeds its quota, not counting files getting collected.
+ *
+ * @param[in] store Chat store
+ * @return #GNUNET_YES if the quota is exceeded, otherwise #GNUNET_NO
+ */
+enum GNUNET_GenericReturnValue
+internal_store_is_exceeded (const struct GNUNET_CHAT_InternalStore *store);
+
+/**
+ * Passes files without references from a selected <i>store</i>
+ * structure to a custom callback with its closure, least recently
+ * released first. If <i>all</i> is set to #GNUNET_NO, the collection
+ * stops once the quota is not exceeded anymore.
+ *
+ * The callback returns #GNUNET_YES if it removes the file, which
+ * has to be confirmed via internal_store_remove() afterwards.
+ *
+ * @param[in,out] store Chat store
+ * @param[in] all Flag to collect all files without references
+ * @param[in] cb Callback for collection
+ * @param[in,out] cls Closure for collection
+ * @return Amount of files getting collected
+ */
+int
+internal_store_collect (struct GNUNET_CHAT_InternalStore *store,
+                        enum GNUNET_GenericReturnValue all,
+                        GNUNET_CHAT_StoreCollectCallback cb,
+                        void *cls);
+
+#endif /* GNUNET_CHAT_INTERNAL_STORE_H_ */
@@ -0,0 +1,272 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_tag_index.c
+ */
+
+#include "gnunet_chat_tag_index.h"
+#include "gnunet_chat_message.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const unsigned int initial_map_size_of_tag_index = 8;
+static const unsigned int initial_map_size_of_tag_index_entry = 4;
+
+static struct GNUNET_CHAT_InternalTagIndexEntry*
+create_tag_index_entry (struct GNUNET_CHAT_InternalTagIndex *index,
+                        const char *tag)
+{
+  GNUNET_assert(index);
+
+  struct GNUNET_CHAT_InternalTagIndexEntry *entry = GNUNET_new(
+    struct GNUNET_CHAT_InternalTagIndexEntry
+  );
+
+  entry->tag = tag? GNUNET_strdup(tag) : NULL;
+  entry->id = index->count;
+
+  entry->messages = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_tag_index_entry, GNUNET_NO);
+
+  if (index->count >= index->size)
+    GNUNET_array_grow(
+      index->entries,
+      index->size,
+      index->size? index->size * 2 : initial_map_size_of_tag_index
+    );
+
+  index->entries[index->count++] = entry;
+  return entry;
+}
+
+struct GNUNET_CHAT_InternalTagIndex*
+internal_tag_index_create ()
+{
+  struct GNUNET_CHAT_InternalTagIndex* index = GNUNET_new(struct GNUNET_CHAT_InternalTagIndex);
+
+  index->tags = GNUNET_CONTAINER_multihashmap32_create(
+    initial_map_size_of_tag_index);
+
+  index->entries = NULL;
+  index->count = 0;
+  index->size = 0;
+
+  create_tag_index_entry(index, NULL);
+  return index;
+}
+
+void
+internal_tag_index_destroy (struct GNUNET_CHAT_InternalTagIndex *index)
+{
+  GNUNET_assert(
+    (index) &&
+    (index->tags)
+  );
+
+  struct GNUNET_CHAT_InternalTagIndexEntry *entry;
+  for (unsigned int i = 0; i < index->count; i++)
+  {
+    entry = index->entries[i];
+
+    GNUNET_CONTAINER_multihashmap_destroy(entry->messages);
+
+    if (entry->tag)
+      GNUNET_free(entry->tag);
+
+    GNUNET_free(entry);
+  }
+
+  GNUNET_array_grow(index->entries, index->size, 0);
+  GNUNET_CONTAINER_multihashmap32_destroy(index->tags);
+
+  GNUNET_free(index);
+}
+
+static uint32_t
+convert_tag_to_key (const char *tag)
+{
+  GNUNET_assert(tag);
+
+  return (uint32_t) GNUNET_CRYPTO_crc32_n(tag, strlen(tag));
+}
+
+struct GNUNET_CHAT_InternalTagIndexFind
+{
+  const char *tag;
+  struct GNUNET_CHAT_InternalTagIndexEntry *entry;
+};
+
+static enum GNUNET_GenericReturnValue
+it_tag_index_find_entry (void *cls,
+                         uint32_t key,
+                         void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalTagIndexFind *find = cls;
+  struct GNUNET_CHAT_InternalTagIndexEntry *entry = value;
+
+  if (0 != strcmp(find->tag, entry->tag))
+    return GNUNET_YES;
+
+  find->entry = entry;
+  return GNUNET_NO;
+}
+
+static struct GNUNET_CHAT_InternalTagIndexEntry*
+find_tag_index_entry (const struct GNUNET_CHAT_InternalTagIndex *index,
+                      const char *tag,
+                      uint32_t key)
+{
+  GNUNET_assert((index) && (tag));
+
+  struct GNUNET_CHAT_InternalTagIndexFind find;
+  find.tag = tag;
+  find.entry = NULL;
+
+  GNUNET_CONTAINER_multihashmap32_get_multiple(
+    index->tags,
+    key,
+    it_tag_index_find_entry,
+    &find
+  );
+
+  return find.entry;
+}
+
+unsigned int
+internal_tag_index_intern (struct GNUNET_CHAT_InternalTagIndex *index,
+                           const char *tag)
+{
+  GNUNET_assert(index);
+
+  if (!tag)
+    return GNUNET_CHAT_INTERNAL_TAG_NONE;
+
+  const uint32_t key = convert_tag_to_key(tag);
+
+  struct GNUNET_CHAT_InternalTagIndexEntry *entry;
+  entry = find_tag_index_entry(index, tag, key);
+
+  if (entry)
+    return entry->id;
+
+  entry = create_tag_index_entry(index, tag);
+
+  GNUNET_CONTAINER_multihashmap32_put(
+    index->tags,
+    key,
+    entry,
+    GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE
+  );
+
+  return entry->id;
+}
+
+unsigned int
+internal_tag_index_lookup (const struct GNUNET_CHAT_InternalTagIndex *index,
+                           const char *tag)
+{
+  GNUNET_assert(index);
+
+  if (!tag)
+    return GNUNET_CHAT_INTERNAL_TAG_NONE;
+
+  const struct GNUNET_CHAT_InternalTagIndexEntry *entry;
+  entry = find_tag_index_entry(index, tag, convert_tag_to_key(tag));
+
+  return entry? entry->id : GNUNET_CHAT_INTERNAL_TAG_UNKNOWN;
+}
+
+void
+internal_tag_index_add (struct GNUNET_CHAT_InternalTagIndex *index,
+                        unsigned int id,
+                        struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((index) && (id < index->count) && (message));
+
+  GNUNET_CONTAINER_multihashmap_put(
+    index->entries[id]->messages,
+    &(message->hash),
+    message,
+    GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_ONLY
+  );
+}
+
+void
+internal_tag_index_remove (struct GNUNET_CHAT_InternalTagIndex *index,
+                           unsigned int id,
+                           const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((index) && (id < index->count) && (message));
+
+  GNUNET_CONTAINER_multihashmap_remove(
+    index->entries[id]->messages,
+    &(message->hash),
+    message
+  );
+}
+
+struct GNUNET_CHAT_InternalTagIndexIterator
+{
+  GNUNET_CHAT_TagIndexCallback cb;
+  void *cls;
+};
+
+static enum GNUNET_GenericReturnValue
+it_tag_index_iterate_message (void *cls,
+                              const struct GNUNET_HashCode *key,
+                              void *value)
+{
+  struct GNUNET_CHAT_InternalTagIndexIterator *it = cls;
+  struct GNUNET_CHAT_Message *message = value;
+
+  if (!(it->cb))
+    return GNUNET_YES;
+
+  return it->cb(it->cls, message);
+}
+
+int
+internal_tag_index_iterate (const struct GNUNET_CHAT_InternalTagIndex *index,
+                            const char *tag,
+                            GNUNET_CHAT_TagIndexCallback cb,
+                            void *cls)
+{
+  GNUNET_assert(index);
+
+  const unsigned int id = internal_tag_index_lookup(index, tag);
+
+  if (GNUNET_CHAT_INTERNAL_TAG_UNKNOWN == id)
+    return 0;
+
+  struct GNUNET_CHAT_InternalTagIndexIterator it;
+  it.cb = cb;
+  it.cls = cls;
+
+  return GNUNET_CONTAINER_multihashmap_iterate(
+    index->entries[id]->messages,
+    it_tag_index_iterate_message,
+    &it
+  );
+}
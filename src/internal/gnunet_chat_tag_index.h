@@ -0,0 +1,147 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_tag_index.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_TAG_INDEX_H_
+#define GNUNET_CHAT_INTERNAL_TAG_INDEX_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <limits.h>
+
+#define GNUNET_CHAT_INTERNAL_TAG_NONE 0
+#define GNUNET_CHAT_INTERNAL_TAG_UNKNOWN UINT_MAX
+
+struct GNUNET_CHAT_Message;
+
+struct GNUNET_CHAT_InternalTagIndexEntry
+{
+  char *tag;
+  unsigned int id;
+
+  struct GNUNET_CONTAINER_MultiHashMap *messages;
+};
+
+struct GNUNET_CHAT_InternalTagIndex
+{
+  struct GNUNET_CONTAINER_MultiHashMap32 *tags;
+
+  struct GNUNET_CHAT_InternalTagIndexEntry **entries;
+  unsigned int count;
+  unsigned int size;
+};
+
+typedef enum GNUNET_GenericReturnValue
+(*GNUNET_CHAT_TagIndexCallback) (void *cls,
+                                 struct GNUNET_CHAT_Message *message);
+
+/**
+ * Creates a tag index structure to intern tag values as small
+ * ids and to keep track of all tag messages per tag value.
+ *
+ * @return New chat tag index
+ */
+struct GNUNET_CHAT_InternalTagIndex*
+internal_tag_index_create ();
+
+/**
+ * Destroys a <i>tag index</i> structure to intern tag values
+ * and keep track of their tag messages.
+ *
+ * @param[out] index Chat tag index
+ */
+void
+internal_tag_index_destroy (struct GNUNET_CHAT_InternalTagIndex *index);
+
+/**
+ * Returns the id of a given <i>tag</i> value in a selected
+ * tag <i>index</i> structure, interning the value if it has
+ * not been used before. The tag value NULL always has the id
+ * #GNUNET_CHAT_INTERNAL_TAG_NONE.
+ *
+ * @param[in,out] index Chat tag index
+ * @param[in] tag Tag value or NULL
+ * @return Id of the tag value
+ */
+unsigned int
+internal_tag_index_intern (struct GNUNET_CHAT_InternalTagIndex *index,
+                           const char *tag);
+
+/**
+ * Returns the id of a given <i>tag</i> value in a selected
+ * tag <i>index</i> structure without interning it.
+ *
+ * @param[in] index Chat tag index
+ * @param[in] tag Tag value or NULL
+ * @return Id of the tag value or #GNUNET_CHAT_INTERNAL_TAG_UNKNOWN
+ */
+unsigned int
+internal_tag_index_lookup (const struct GNUNET_CHAT_InternalTagIndex *index,
+                           const char *tag);
+
+/**
+ * Adds a tag <i>message</i> to the messages of a tag value
+ * with a given <i>id</i> in a selected tag <i>index</i>
+ * structure.
+ *
+ * @param[in,out] index Chat tag index
+ * @param[in] id Id of the tag value
+ * @param[in,out] message Tag message
+ */
+void
+internal_tag_index_add (struct GNUNET_CHAT_InternalTagIndex *index,
+                        unsigned int id,
+                        struct GNUNET_CHAT_Message *message);
+
+/**
+ * Removes a tag <i>message</i> from the messages of a tag value
+ * with a given <i>id</i> in a selected tag <i>index</i>
+ * structure.
+ *
+ * @param[in,out] index Chat tag index
+ * @param[in] id Id of the tag value
+ * @param[in] message Tag message
+ */
+void
+internal_tag_index_remove (struct GNUNET_CHAT_InternalTagIndex *index,
+                           unsigned int id,
+                           const struct GNUNET_CHAT_Message *message);
+
+/**
+ * Iterates through all tag messages with a specific <i>tag</i>
+ * value from any context in a selected tag <i>index</i> structure
+ * forwarding them to a custom callback with its closure.
+ *
+ * @param[in] index Chat tag index
+ * @param[in] tag Tag value or NULL
+ * @param[in] cb Callback for iteration
+ * @param[in,out] cls Closure for iteration
+ * @return Amount of tag messages iterated or #GNUNET_SYSERR on error
+ */
+int
+internal_tag_index_iterate (const struct GNUNET_CHAT_InternalTagIndex *index,
+                            const char *tag,
+                            GNUNET_CHAT_TagIndexCallback cb,
+                            void *cls);
+
+#endif /* GNUNET_CHAT_INTERNAL_TAG_INDEX_H_ */
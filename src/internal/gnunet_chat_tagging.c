@@ -30,15 +30,20 @@
 #include <gnunet/gnunet_util_lib.h>
 #include <string.h>
 
-static const unsigned int initial_map_size_of_tagging = 4;
+static const unsigned int initial_size_of_tagging = 4;
 
 struct GNUNET_CHAT_InternalTagging*
-internal_tagging_create ()
+internal_tagging_create (struct GNUNET_CHAT_InternalTagIndex *index)
 {
+  GNUNET_assert(index);
+
   struct GNUNET_CHAT_InternalTagging* tagging = GNUNET_new(struct GNUNET_CHAT_InternalTagging);
 
-  tagging->tags = GNUNET_CONTAINER_multihashmap_create(
-    initial_map_size_of_tagging, GNUNET_NO);
+  tagging->index = index;
+
+  tagging->entries = NULL;
+  tagging->count = 0;
+  tagging->size = 0;
 
   return tagging;
 }
@@ -48,23 +53,61 @@ internal_tagging_destroy (struct GNUNET_CHAT_InternalTagging *tagging)
 {
   GNUNET_assert(
     (tagging) &&
-    (tagging->tags)
+    (tagging->index)
   );
 
-  GNUNET_CONTAINER_multihashmap_destroy(tagging->tags);
+  for (unsigned int i = 0; i < tagging->count; i++)
+    internal_tag_index_remove(
+      tagging->index,
+      tagging->entries[i].id,
+      tagging->entries[i].message
+    );
+
+  GNUNET_array_grow(tagging->entries, tagging->size, 0);
 
   GNUNET_free(tagging);
 }
 
-static void
-convert_tag_to_hash (const char *tag, struct GNUNET_HashCode *hash)
+static enum GNUNET_GenericReturnValue
+is_entry_before (const struct GNUNET_CHAT_InternalTaggingEntry *entry,
+                 unsigned int id,
+                 const struct GNUNET_CHAT_Message *message)
 {
-  GNUNET_assert(hash);
+  GNUNET_assert(entry);
 
-  if (tag)
-    GNUNET_CRYPTO_hash(tag, strlen(tag), hash);
+  if (entry->id < id)
+    return GNUNET_YES;
+  else if ((entry->id > id) || (!message))
+    return GNUNET_NO;
+
+  if (0 > GNUNET_CRYPTO_hash_cmp(&(entry->message->hash), &(message->hash)))
+    return GNUNET_YES;
   else
-    memset(hash, 0, sizeof(*hash));
+    return GNUNET_NO;
+}
+
+static unsigned int
+find_entry_position (const struct GNUNET_CHAT_InternalTagging *tagging,
+                     unsigned int id,
+                     const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert(tagging);
+
+  unsigned int lower = 0;
+  unsigned int upper = tagging->count;
+  unsigned int middle;
+
+  while (lower < upper)
+  {
+    middle = lower + (upper - lower) / 2;
+
+    if (GNUNET_YES == is_entry_before(&(tagging->entries[middle]), id, message))
+      lower = middle + 1;
+    else
+      upper = middle;
+  }
+
+  return lower;
 }
 
 enum GNUNET_GenericReturnValue
@@ -76,18 +119,36 @@ internal_tagging_add (struct GNUNET_CHAT_InternalTagging *tagging,
   if ((GNUNET_YES != message_has_msg(message)) ||
       (GNUNET_MESSENGER_KIND_TAG != message->msg->header.kind))
     return GNUNET_SYSERR;
-  
-  const char *tag = message->msg->body.tag.tag;
 
-  struct GNUNET_HashCode hash;
-  convert_tag_to_hash(tag, &hash);
+  const unsigned int id = internal_tag_index_intern(
+    tagging->index, message->msg->body.tag.tag
+  );
+
+  const unsigned int position = find_entry_position(tagging, id, message);
+
+  if ((position < tagging->count) &&
+      (tagging->entries[position].message == message))
+    return GNUNET_NO;
+
+  if (tagging->count >= tagging->size)
+    GNUNET_array_grow(
+      tagging->entries,
+      tagging->size,
+      tagging->size? tagging->size * 2 : initial_size_of_tagging
+    );
 
-  return GNUNET_CONTAINER_multihashmap_put(
-    tagging->tags,
-    &hash,
-    message,
-    GNUNET_CONTAINER_MULTIHASHMAPOPTION_MULTIPLE
+  memmove(
+    &(tagging->entries[position + 1]),
+    &(tagging->entries[position]),
+    sizeof(*(tagging->entries)) * (tagging->count - position)
   );
+
+  tagging->entries[position].id = id;
+  tagging->entries[position].message = message;
+  tagging->count++;
+
+  internal_tag_index_add(tagging->index, id, message);
+  return GNUNET_OK;
 }
 
 enum GNUNET_GenericReturnValue
@@ -99,37 +160,30 @@ internal_tagging_remove (struct GNUNET_CHAT_InternalTagging *tagging,
   if ((GNUNET_YES != message_has_msg(message)) ||
       (GNUNET_MESSENGER_KIND_TAG != message->msg->header.kind))
     return GNUNET_SYSERR;
-  
-  const char *tag = message->msg->body.tag.tag;
-
-  struct GNUNET_HashCode hash;
-  convert_tag_to_hash(tag, &hash);
 
-  return GNUNET_CONTAINER_multihashmap_remove(
-    tagging->tags,
-    &hash,
-    message
+  const unsigned int id = internal_tag_index_lookup(
+    tagging->index, message->msg->body.tag.tag
   );
-}
 
-struct GNUNET_CHAT_InternalTaggingIterator
-{
-  GNUNET_CHAT_TaggingCallback cb;
-  void *cls;
-};
+  if (GNUNET_CHAT_INTERNAL_TAG_UNKNOWN == id)
+    return GNUNET_NO;
 
-static enum GNUNET_GenericReturnValue
-internal_tagging_iterate_message (void *cls,
-                                  const struct GNUNET_HashCode *key,
-                                  void *value)
-{
-  struct GNUNET_CHAT_InternalTaggingIterator *it = cls;
-  struct GNUNET_CHAT_Message *message = value;
+  const unsigned int position = find_entry_position(tagging, id, message);
 
-  if (!(it->cb))
-    return GNUNET_YES;
-  
-  return it->cb(it->cls, message);
+  if ((position >= tagging->count) ||
+      (tagging->entries[position].message != message))
+    return GNUNET_NO;
+
+  tagging->count--;
+
+  memmove(
+    &(tagging->entries[position]),
+    &(tagging->entries[position + 1]),
+    sizeof(*(tagging->entries)) * (tagging->count - position)
+  );
+
+  internal_tag_index_remove(tagging->index, id, message);
+  return GNUNET_YES;
 }
 
 int
@@ -141,24 +195,34 @@ internal_tagging_iterate (const struct GNUNET_CHAT_InternalTagging *tagging,
 {
   GNUNET_assert(tagging);
 
-  struct GNUNET_CHAT_InternalTaggingIterator it;
-  it.cb = cb;
-  it.cls = cls;
+  unsigned int id = GNUNET_CHAT_INTERNAL_TAG_UNKNOWN;
+  unsigned int position = 0;
 
-  if (GNUNET_YES == ignore_tag)
-    return GNUNET_CONTAINER_multihashmap_iterate(
-      tagging->tags,
-      internal_tagging_iterate_message,
-      &it
-    );
+  if (GNUNET_YES != ignore_tag)
+  {
+    id = internal_tag_index_lookup(tagging->index, tag);
 
-  struct GNUNET_HashCode hash;
-  convert_tag_to_hash(tag, &hash);
+    if (GNUNET_CHAT_INTERNAL_TAG_UNKNOWN == id)
+      return 0;
 
-  return GNUNET_CONTAINER_multihashmap_get_multiple(
-    tagging->tags,
-    &hash,
-    internal_tagging_iterate_message,
-    &it
-  );
+    position = find_entry_position(tagging, id, NULL);
+  }
+
+  int result = 0;
+
+  while (position < tagging->count)
+  {
+    const struct GNUNET_CHAT_InternalTaggingEntry *entry;
+    entry = &(tagging->entries[position++]);
+
+    if ((GNUNET_YES != ignore_tag) && (entry->id != id))
+      break;
+
+    result++;
+
+    if ((cb) && (GNUNET_YES != cb(cls, entry->message)))
+      return GNUNET_SYSERR;
+  }
+
+  return result;
 }
@@ -25,14 +25,26 @@
 #ifndef GNUNET_CHAT_INTERNAL_TAGGING_H_
 #define GNUNET_CHAT_INTERNAL_TAGGING_H_
 
+#include "gnunet_chat_tag_index.h"
+
 #include <gnunet/gnunet_common.h>
 #include <gnunet/gnunet_util_lib.h>
 
 struct GNUNET_CHAT_Message;
 
+struct GNUNET_CHAT_InternalTaggingEntry
+{
+  unsigned int id;
+  struct GNUNET_CHAT_Message *message;
+};
+
 struct GNUNET_CHAT_InternalTagging
 {
-  struct GNUNET_CONTAINER_MultiHashMap *tags;
+  struct GNUNET_CHAT_InternalTagIndex *index;
+
+  struct GNUNET_CHAT_InternalTaggingEntry *entries;
+  unsigned int count;
+  unsigned int size;
 };
 
 typedef enum GNUNET_GenericReturnValue
@@ -41,12 +53,14 @@ typedef enum GNUNET_GenericReturnValue
 
 /**
  * Creates a tagging structure to manage different tag messages
- * mapped by its custom tag value.
+ * sorted by the id of their custom tag value interned in a
+ * given tag <i>index</i>.
  *
+ * @param[in,out] index Chat tag index
  * @return New chat tagging
  */
 struct GNUNET_CHAT_InternalTagging*
-internal_tagging_create ();
+internal_tagging_create (struct GNUNET_CHAT_InternalTagIndex *index);
 
 /**
  * Destroys a <i>tagging</i> structure to manage different tag 
@@ -63,7 +77,8 @@ internal_tagging_destroy (struct GNUNET_CHAT_InternalTagging *tagging);
  *
  * @param[in,out] tagging Chat tagging
  * @param[in,out] message Tag message
- * @return #GNUNET_OK on success, otherwise #GNUNET_SYSERR
+ * @return #GNUNET_OK on success, #GNUNET_NO if the message was
+ *   already added and otherwise #GNUNET_SYSERR
  */
 enum GNUNET_GenericReturnValue
 internal_tagging_add (struct GNUNET_CHAT_InternalTagging *tagging,
@@ -0,0 +1,350 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_timeline.c
+ */
+
+#include "gnunet_chat_timeline.h"
+#include "gnunet_chat_message.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_messenger_service.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const unsigned int initial_map_size_of_timeline = 8;
+
+struct GNUNET_CHAT_InternalTimeline*
+internal_timeline_create (unsigned int initial_size)
+{
+  struct GNUNET_CHAT_InternalTimeline* timeline = GNUNET_new(struct GNUNET_CHAT_InternalTimeline);
+
+  if (initial_size < initial_map_size_of_timeline)
+    initial_size = initial_map_size_of_timeline;
+
+  timeline->entries = GNUNET_CONTAINER_multihashmap_create(
+    initial_size, GNUNET_NO);
+
+  memset(timeline->head, 0, sizeof(timeline->head));
+  timeline->tail = NULL;
+
+  return timeline;
+}
+
+void
+internal_timeline_destroy (struct GNUNET_CHAT_InternalTimeline *timeline)
+{
+  GNUNET_assert(
+    (timeline) &&
+    (timeline->entries)
+  );
+
+  internal_timeline_clear(timeline);
+
+  GNUNET_CONTAINER_multihashmap_destroy(timeline->entries);
+
+  GNUNET_free(timeline);
+}
+
+static enum GNUNET_GenericReturnValue
+is_entry_before (const struct GNUNET_CHAT_InternalTimelineEntry *entry,
+                 struct GNUNET_TIME_Absolute timestamp,
+                 const struct GNUNET_HashCode *hash)
+{
+  GNUNET_assert((entry) && (entry->message));
+
+  if (entry->timestamp.abs_value_us < timestamp.abs_value_us)
+    return GNUNET_YES;
+  else if ((entry->timestamp.abs_value_us > timestamp.abs_value_us) || (!hash))
+    return GNUNET_NO;
+
+  if (0 > GNUNET_CRYPTO_hash_cmp(&(entry->message->hash), hash))
+    return GNUNET_YES;
+  else
+    return GNUNET_NO;
+}
+
+static void
+find_entry_predecessors (const struct GNUNET_CHAT_InternalTimeline *timeline,
+                         struct GNUNET_TIME_Absolute timestamp,
+                         const struct GNUNET_HashCode *hash,
+                         struct GNUNET_CHAT_InternalTimelineEntry **update)
+{
+  GNUNET_assert((timeline) && (update));
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry = NULL;
+  struct GNUNET_CHAT_InternalTimelineEntry *next;
+
+  for (unsigned int level = GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS; level > 0; level--)
+  {
+    next = entry? entry->next[level - 1] : timeline->head[level - 1];
+
+    while ((next) && (GNUNET_YES == is_entry_before(next, timestamp, hash)))
+    {
+      entry = next;
+      next = entry->next[level - 1];
+    }
+
+    update[level - 1] = entry;
+  }
+}
+
+static unsigned int
+random_entry_height ()
+{
+  uint32_t bits = GNUNET_CRYPTO_random_u32(
+    GNUNET_CRYPTO_QUALITY_WEAK, UINT32_MAX
+  );
+
+  unsigned int height = 1;
+  while ((height < GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS) && (bits & 1))
+  {
+    bits >>= 1;
+    height++;
+  }
+
+  return height;
+}
+
+enum GNUNET_GenericReturnValue
+internal_timeline_add (struct GNUNET_CHAT_InternalTimeline *timeline,
+                       struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((timeline) && (message));
+
+  if (GNUNET_YES != message_has_msg(message))
+    return GNUNET_SYSERR;
+
+  if (GNUNET_YES == GNUNET_CONTAINER_multihashmap_contains(
+      timeline->entries, &(message->hash)))
+    return GNUNET_NO;
+
+  const struct GNUNET_TIME_Absolute timestamp = GNUNET_TIME_absolute_ntoh(
+    message->msg->header.timestamp
+  );
+
+  struct GNUNET_CHAT_InternalTimelineEntry *update [
+    GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS
+  ];
+
+  find_entry_predecessors(timeline, timestamp, &(message->hash), update);
+
+  const unsigned int height = random_entry_height();
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry = GNUNET_malloc(
+    sizeof(*entry) + height * sizeof(entry->next[0])
+  );
+
+  entry->message = message;
+  entry->timestamp = timestamp;
+  entry->height = height;
+
+  if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+      timeline->entries, &(message->hash), entry,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+  {
+    GNUNET_free(entry);
+    return GNUNET_SYSERR;
+  }
+
+  for (unsigned int level = 0; level < height; level++)
+  {
+    if (update[level])
+    {
+      entry->next[level] = update[level]->next[level];
+      update[level]->next[level] = entry;
+    }
+    else
+    {
+      entry->next[level] = timeline->head[level];
+      timeline->head[level] = entry;
+    }
+  }
+
+  entry->prev = update[0];
+
+  if (entry->next[0])
+    entry->next[0]->prev = entry;
+  else
+    timeline->tail = entry;
+
+  return GNUNET_OK;
+}
+
+enum GNUNET_GenericReturnValue
+internal_timeline_remove (struct GNUNET_CHAT_InternalTimeline *timeline,
+                          const struct GNUNET_CHAT_Message *message)
+{
+  GNUNET_assert((timeline) && (message));
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(
+    timeline->entries, &(message->hash)
+  );
+
+  if (!entry)
+    return GNUNET_NO;
+
+  struct GNUNET_CHAT_InternalTimelineEntry *update [
+    GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS
+  ];
+
+  find_entry_predecessors(timeline, entry->timestamp, &(message->hash), update);
+
+  for (unsigned int level = 0; level < entry->height; level++)
+  {
+    if (update[level])
+      update[level]->next[level] = entry->next[level];
+    else
+      timeline->head[level] = entry->next[level];
+  }
+
+  if (entry->next[0])
+    entry->next[0]->prev = entry->prev;
+  else
+    timeline->tail = entry->prev;
+
+  GNUNET_CONTAINER_multihashmap_remove(
+    timeline->entries, &(message->hash), entry
+  );
+
+  GNUNET_free(entry);
+  return GNUNET_YES;
+}
+
+void
+internal_timeline_reserve (struct GNUNET_CHAT_InternalTimeline *timeline,
+                           unsigned int size)
+{
+  GNUNET_assert((timeline) && (timeline->entries));
+
+  if (GNUNET_CONTAINER_multihashmap_size(timeline->entries) >= size)
+    return;
+
+  struct GNUNET_CONTAINER_MultiHashMap *entries;
+  entries = GNUNET_CONTAINER_multihashmap_create(size, GNUNET_NO);
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry = timeline->head[0];
+
+  while (entry)
+  {
+    GNUNET_CONTAINER_multihashmap_put(
+      entries, &(entry->message->hash), entry,
+      GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST
+    );
+
+    entry = entry->next[0];
+  }
+
+  GNUNET_CONTAINER_multihashmap_destroy(timeline->entries);
+  timeline->entries = entries;
+}
+
+void
+internal_timeline_clear (struct GNUNET_CHAT_InternalTimeline *timeline)
+{
+  GNUNET_assert(timeline);
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry = timeline->head[0];
+  struct GNUNET_CHAT_InternalTimelineEntry *next;
+
+  while (entry)
+  {
+    next = entry->next[0];
+    GNUNET_free(entry);
+    entry = next;
+  }
+
+  GNUNET_CONTAINER_multihashmap_clear(timeline->entries);
+
+  memset(timeline->head, 0, sizeof(timeline->head));
+  timeline->tail = NULL;
+}
+
+unsigned int
+internal_timeline_size (const struct GNUNET_CHAT_InternalTimeline *timeline)
+{
+  GNUNET_assert(timeline);
+
+  return GNUNET_CONTAINER_multihashmap_size(timeline->entries);
+}
+
+int
+internal_timeline_iterate (const struct GNUNET_CHAT_InternalTimeline *timeline,
+                           struct GNUNET_TIME_Absolute from,
+                           struct GNUNET_TIME_Absolute to,
+                           unsigned int limit,
+                           enum GNUNET_GenericReturnValue reverse,
+                           GNUNET_CHAT_TimelineCallback cb,
+                           void *cls)
+{
+  GNUNET_assert(timeline);
+
+  if (from.abs_value_us > to.abs_value_us)
+    return 0;
+
+  struct GNUNET_CHAT_InternalTimelineEntry *update [
+    GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS
+  ];
+
+  struct GNUNET_CHAT_InternalTimelineEntry *entry;
+  struct GNUNET_CHAT_InternalTimelineEntry *next;
+
+  if (GNUNET_YES == reverse)
+  {
+    find_entry_predecessors(
+      timeline,
+      GNUNET_TIME_absolute_add(to, GNUNET_TIME_UNIT_MICROSECONDS),
+      NULL,
+      update
+    );
+
+    entry = update[0];
+  }
+  else
+  {
+    find_entry_predecessors(timeline, from, NULL, update);
+
+    entry = update[0]? update[0]->next[0] : timeline->head[0];
+  }
+
+  int result = 0;
+
+  while (entry)
+  {
+    if ((entry->timestamp.abs_value_us < from.abs_value_us) ||
+        (entry->timestamp.abs_value_us > to.abs_value_us))
+      break;
+
+    next = (GNUNET_YES == reverse)? entry->prev : entry->next[0];
+    result++;
+
+    if ((cb) && (GNUNET_YES != cb(cls, entry->message)))
+      break;
+
+    if ((limit) && ((unsigned int) result >= limit))
+      break;
+
+    entry = next;
+  }
+
+  return result;
+}
@@ -0,0 +1,164 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_timeline.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_TIMELINE_H_
+#define GNUNET_CHAT_INTERNAL_TIMELINE_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+#define GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS 24
+
+struct GNUNET_CHAT_Message;
+
+struct GNUNET_CHAT_InternalTimelineEntry
+{
+  struct GNUNET_CHAT_Message *message;
+  struct GNUNET_TIME_Absolute timestamp;
+
+  struct GNUNET_CHAT_InternalTimelineEntry *prev;
+
+  unsigned int height;
+  struct GNUNET_CHAT_InternalTimelineEntry *next [];
+};
+
+struct GNUNET_CHAT_InternalTimeline
+{
+  struct GNUNET_CONTAINER_MultiHashMap *entries;
+
+  struct GNUNET_CHAT_InternalTimelineEntry *head [
+    GNUNET_CHAT_INTERNAL_TIMELINE_LEVELS
+  ];
+
+  struct GNUNET_CHAT_InternalTimelineEntry *tail;
+};
+
+typedef enum GNUNET_GenericReturnValue
+(*GNUNET_CHAT_TimelineCallback) (void *cls,
+                                 struct GNUNET_CHAT_Message *message);
+
+/**
+ * Creates a timeline structure to keep messages ordered
+ * by their timestamp and hash for range queries.
+ *
+ * @param[in] initial_size Expected amount of messages
+ * @return New chat timeline
+ */
+struct GNUNET_CHAT_InternalTimeline*
+internal_timeline_create (unsigned int initial_size);
+
+/**
+ * Destroys a <i>timeline</i> structure to keep messages
+ * ordered by their timestamp and hash.
+ *
+ * @param[out] timeline Chat timeline
+ */
+void
+internal_timeline_destroy (struct GNUNET_CHAT_InternalTimeline *timeline);
+
+/**
+ * Adds a <i>message</i> to a selected <i>timeline</i>
+ * structure at the position of its timestamp.
+ *
+ * @param[in,out] timeline Chat timeline
+ * @param[in,out] message Chat message
+ * @return #GNUNET_OK on success, #GNUNET_NO if the message was
+ *   already added and otherwise #GNUNET_SYSERR
+ */
+enum GNUNET_GenericReturnValue
+internal_timeline_add (struct GNUNET_CHAT_InternalTimeline *timeline,
+                       struct GNUNET_CHAT_Message *message);
+
+/**
+ * Removes a <i>message</i> from a selected <i>timeline</i>
+ * structure.
+ *
+ * @param[in,out] timeline Chat timeline
+ * @param[in] message Chat message
+ * @return #GNUNET_YES on success, otherwise #GNUNET_NO
+ */
+enum GNUNET_GenericReturnValue
+internal_timeline_remove (struct GNUNET_CHAT_InternalTimeline *timeline,
+                          const struct GNUNET_CHAT_Message *message);
+
+/**
+ * Prepares a selected <i>timeline</i> structure to hold an
+ * expected amount of messages given by <i>size</i>.
+ *
+ * @param[in,out] timeline Chat timeline
+ * @param[in] size Expected amount of messages
+ */
+void
+internal_timeline_reserve (struct GNUNET_CHAT_InternalTimeline *timeline,
+                           unsigned int size);
+
+/**
+ * Removes all messages from a selected <i>timeline</i>
+ * structure.
+ *
+ * @param[in,out] timeline Chat timeline
+ */
+void
+internal_timeline_clear (struct GNUNET_CHAT_InternalTimeline *timeline);
+
+/**
+ * Returns the amount of messages in a selected <i>timeline</i>
+ * structure.
+ *
+ * @param[in] timeline Chat timeline
+ * @return Amount of messages
+ */
+unsigned int
+internal_timeline_size (const struct GNUNET_CHAT_InternalTimeline *timeline);
+
+/**
+ * Iterates through a selected <i>timeline</i> structure forwarding
+ * messages with a timestamp between <i>from</i> and <i>to</i>
+ * (both inclusive) to a custom callback with its closure.
+ *
+ * If <i>reverse</i> is set to #GNUNET_YES the messages will be
+ * iterated from newest to oldest, otherwise from oldest to newest.
+ * The iteration stops after <i>limit</i> messages unless the
+ * <i>limit</i> is zero.
+ *
+ * @param[in] timeline Chat timeline
+ * @param[in] from Lower bound of timestamps
+ * @param[in] to Upper bound of timestamps
+ * @param[in] limit Maximum amount of messages or zero
+ * @param[in] reverse Flag to set the order of the iteration
+ * @param[in] cb Callback for iteration
+ * @param[in,out] cls Closure for iteration
+ * @return Amount of messages iterated
+ */
+int
+internal_timeline_iterate (const struct GNUNET_CHAT_InternalTimeline *timeline,
+                           struct GNUNET_TIME_Absolute from,
+                           struct GNUNET_TIME_Absolute to,
+                           unsigned int limit,
+                           enum GNUNET_GenericReturnValue reverse,
+                           GNUNET_CHAT_TimelineCallback cb,
+                           void *cls);
+
+#endif /* GNUNET_CHAT_INTERNAL_TIMELINE_H_ */
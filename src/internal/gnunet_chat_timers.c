@@ -0,0 +1,356 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_timers.c
+ */
+
+#include "gnunet_chat_timers.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+#define TIMERS_MASK (GNUNET_CHAT_INTERNAL_TIMERS_SLOTS - 1)
+#define TIMERS_RANGE (                      \
+  (uint64_t) 1 << (                         \
+    GNUNET_CHAT_INTERNAL_TIMERS_BITS *      \
+    GNUNET_CHAT_INTERNAL_TIMERS_LEVELS      \
+  ))
+
+static void
+schedule_timers_task (struct GNUNET_CHAT_InternalTimers *timers);
+
+struct GNUNET_CHAT_InternalTimers*
+internal_timers_create (struct GNUNET_TIME_Relative resolution)
+{
+  GNUNET_assert(resolution.rel_value_us > 0);
+
+  struct GNUNET_CHAT_InternalTimers* timers = GNUNET_new(struct GNUNET_CHAT_InternalTimers);
+
+  timers->resolution = resolution;
+  timers->current = (
+    GNUNET_TIME_absolute_get().abs_value_us / resolution.rel_value_us
+  );
+
+  memset(timers->slots, 0, sizeof(timers->slots));
+  memset(timers->counts, 0, sizeof(timers->counts));
+
+  timers->count = 0;
+  timers->firing = GNUNET_NO;
+
+  timers->task = NULL;
+  timers->task_tick = 0;
+
+  return timers;
+}
+
+void
+internal_timers_destroy (struct GNUNET_CHAT_InternalTimers *timers)
+{
+  GNUNET_assert((timers) && (GNUNET_YES != timers->firing));
+
+  if (timers->task)
+    GNUNET_SCHEDULER_cancel(timers->task);
+
+  struct GNUNET_CHAT_InternalTimersSlot *slot;
+  struct GNUNET_CHAT_InternalTimer *timer;
+
+  for (unsigned int level = 0; level < GNUNET_CHAT_INTERNAL_TIMERS_LEVELS; level++)
+    for (unsigned int index = 0; index < GNUNET_CHAT_INTERNAL_TIMERS_SLOTS; index++)
+    {
+      slot = &(timers->slots[level][index]);
+
+      while (slot->head)
+      {
+        timer = slot->head;
+
+        GNUNET_CONTAINER_DLL_remove(
+          slot->head,
+          slot->tail,
+          timer
+        );
+
+        GNUNET_free(timer);
+      }
+    }
+
+  GNUNET_free(timers);
+}
+
+static void
+place_timer (struct GNUNET_CHAT_InternalTimers *timers,
+             struct GNUNET_CHAT_InternalTimer *timer)
+{
+  GNUNET_assert((timers) && (timer) && (timer->expires >= timers->current));
+
+  const uint64_t delta = timer->expires - timers->current;
+  uint64_t expires = timer->expires;
+
+  // Timers beyond the range of the wheel get placed at its
+  // end and will be placed again when they get cascaded.
+  if (delta >= TIMERS_RANGE)
+    expires = timers->current + TIMERS_RANGE - 1;
+
+  unsigned int level = 0;
+  while ((level + 1 < GNUNET_CHAT_INTERNAL_TIMERS_LEVELS) &&
+         (expires - timers->current >= (
+           (uint64_t) 1 << (GNUNET_CHAT_INTERNAL_TIMERS_BITS * (level + 1))
+         )))
+    level++;
+
+  timer->level = level;
+  timer->slot = (unsigned int) (
+    (expires >> (GNUNET_CHAT_INTERNAL_TIMERS_BITS * level)) & TIMERS_MASK
+  );
+
+  struct GNUNET_CHAT_InternalTimersSlot *slot;
+  slot = &(timers->slots[timer->level][timer->slot]);
+
+  GNUNET_CONTAINER_DLL_insert_tail(
+    slot->head,
+    slot->tail,
+    timer
+  );
+
+  timers->counts[level]++;
+}
+
+static void
+unplace_timer (struct GNUNET_CHAT_InternalTimers *timers,
+               struct GNUNET_CHAT_InternalTimer *timer)
+{
+  GNUNET_assert((timers) && (timer));
+
+  struct GNUNET_CHAT_InternalTimersSlot *slot;
+  slot = &(timers->slots[timer->level][timer->slot]);
+
+  GNUNET_CONTAINER_DLL_remove(
+    slot->head,
+    slot->tail,
+    timer
+  );
+
+  timers->counts[timer->level]--;
+}
+
+static void
+cascade_timers (struct GNUNET_CHAT_InternalTimers *timers)
+{
+  GNUNET_assert(timers);
+
+  struct GNUNET_CHAT_InternalTimersSlot *slot;
+  struct GNUNET_CHAT_InternalTimer *timer;
+  unsigned int index;
+
+  for (unsigned int level = 1; level < GNUNET_CHAT_INTERNAL_TIMERS_LEVELS; level++)
+  {
+    if (timers->current & (
+        ((uint64_t) 1 << (GNUNET_CHAT_INTERNAL_TIMERS_BITS * level)) - 1))
+      break;
+
+    index = (unsigned int) (
+      (timers->current >> (GNUNET_CHAT_INTERNAL_TIMERS_BITS * level)) & TIMERS_MASK
+    );
+
+    slot = &(timers->slots[level][index]);
+
+    struct GNUNET_CHAT_InternalTimer *head = slot->head;
+
+    slot->head = NULL;
+    slot->tail = NULL;
+
+    while (head)
+    {
+      timer = head;
+      head = timer->next;
+
+      timer->prev = NULL;
+      timer->next = NULL;
+
+      timers->counts[level]--;
+      place_timer(timers, timer);
+    }
+  }
+}
+
+static void
+cb_timers_tick (void *cls)
+{
+  struct GNUNET_CHAT_InternalTimers *timers = cls;
+
+  GNUNET_assert(timers);
+
+  timers->task = NULL;
+
+  const uint64_t now = (
+    GNUNET_TIME_absolute_get().abs_value_us / timers->resolution.rel_value_us
+  );
+
+  struct GNUNET_CHAT_InternalTimersSlot *slot;
+  struct GNUNET_CHAT_InternalTimer *timer;
+
+  GNUNET_SCHEDULER_TaskCallback callback;
+  void *callback_cls;
+
+  timers->firing = GNUNET_YES;
+
+  while (timers->current < now)
+  {
+    if (!(timers->count))
+    {
+      timers->current = now;
+      break;
+    }
+
+    timers->current++;
+    cascade_timers(timers);
+
+    slot = &(timers->slots[0][timers->current & TIMERS_MASK]);
+
+    while (slot->head)
+    {
+      timer = slot->head;
+
+      unplace_timer(timers, timer);
+      timers->count--;
+
+      callback = timer->callback;
+      callback_cls = timer->cls;
+
+      GNUNET_free(timer);
+
+      callback(callback_cls);
+    }
+  }
+
+  timers->firing = GNUNET_NO;
+
+  schedule_timers_task(timers);
+}
+
+static uint64_t
+next_timers_tick (const struct GNUNET_CHAT_InternalTimers *timers)
+{
+  GNUNET_assert((timers) && (timers->count > 0));
+
+  const unsigned int cascading = timers->count - timers->counts[0];
+  uint64_t tick = timers->current;
+
+  // Find the next occupied slot of the lowest level unless
+  // timers need to be cascaded from higher levels before.
+  for (unsigned int i = 0; i < GNUNET_CHAT_INTERNAL_TIMERS_SLOTS; i++)
+  {
+    tick++;
+
+    if ((cascading) && (0 == (tick & TIMERS_MASK)))
+      break;
+
+    if (timers->slots[0][tick & TIMERS_MASK].head)
+      break;
+  }
+
+  return tick;
+}
+
+static void
+schedule_timers_task (struct GNUNET_CHAT_InternalTimers *timers)
+{
+  GNUNET_assert(timers);
+
+  if (GNUNET_YES == timers->firing)
+    return;
+
+  if (!(timers->count))
+  {
+    if (timers->task)
+      GNUNET_SCHEDULER_cancel(timers->task);
+
+    timers->task = NULL;
+    return;
+  }
+
+  const uint64_t tick = next_timers_tick(timers);
+
+  if ((timers->task) && (timers->task_tick <= tick))
+    return;
+
+  if (timers->task)
+    GNUNET_SCHEDULER_cancel(timers->task);
+
+  struct GNUNET_TIME_Absolute at;
+  at.abs_value_us = tick * timers->resolution.rel_value_us;
+
+  timers->task_tick = tick;
+  timers->task = GNUNET_SCHEDULER_add_at(
+    at,
+    cb_timers_tick,
+    timers
+  );
+}
+
+struct GNUNET_CHAT_InternalTimer*
+internal_timers_add_at (struct GNUNET_CHAT_InternalTimers *timers,
+                        struct GNUNET_TIME_Absolute at,
+                        GNUNET_SCHEDULER_TaskCallback callback,
+                        void *cls)
+{
+  GNUNET_assert((timers) && (callback));
+
+  struct GNUNET_CHAT_InternalTimer *timer = GNUNET_new(
+    struct GNUNET_CHAT_InternalTimer
+  );
+
+  const uint64_t resolution = timers->resolution.rel_value_us;
+
+  timer->expires = at.abs_value_us / resolution;
+
+  if (at.abs_value_us % resolution)
+    timer->expires++;
+
+  // The slot of the current tick has already been fired.
+  if (timer->expires <= timers->current)
+    timer->expires = timers->current + 1;
+
+  timer->callback = callback;
+  timer->cls = cls;
+
+  place_timer(timers, timer);
+  timers->count++;
+
+  schedule_timers_task(timers);
+  return timer;
+}
+
+void
+internal_timers_cancel (struct GNUNET_CHAT_InternalTimers *timers,
+                        struct GNUNET_CHAT_InternalTimer *timer)
+{
+  GNUNET_assert((timers) && (timer) && (timers->count > 0));
+
+  unplace_timer(timers, timer);
+  timers->count--;
+
+  GNUNET_free(timer);
+
+  schedule_timers_task(timers);
+}
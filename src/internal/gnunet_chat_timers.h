@@ -0,0 +1,126 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_timers.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_TIMERS_H_
+#define GNUNET_CHAT_INTERNAL_TIMERS_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+#define GNUNET_CHAT_INTERNAL_TIMERS_BITS 6
+#define GNUNET_CHAT_INTERNAL_TIMERS_SLOTS (1 << GNUNET_CHAT_INTERNAL_TIMERS_BITS)
+#define GNUNET_CHAT_INTERNAL_TIMERS_LEVELS 4
+
+struct GNUNET_CHAT_InternalTimer
+{
+  struct GNUNET_CHAT_InternalTimer *prev;
+  struct GNUNET_CHAT_InternalTimer *next;
+
+  uint64_t expires;
+
+  unsigned int level;
+  unsigned int slot;
+
+  GNUNET_SCHEDULER_TaskCallback callback;
+  void *cls;
+};
+
+struct GNUNET_CHAT_InternalTimersSlot
+{
+  struct GNUNET_CHAT_InternalTimer *head;
+  struct GNUNET_CHAT_InternalTimer *tail;
+};
+
+struct GNUNET_CHAT_InternalTimers
+{
+  struct GNUNET_TIME_Relative resolution;
+  uint64_t current;
+
+  struct GNUNET_CHAT_InternalTimersSlot slots [
+    GNUNET_CHAT_INTERNAL_TIMERS_LEVELS
+  ][
+    GNUNET_CHAT_INTERNAL_TIMERS_SLOTS
+  ];
+
+  unsigned int counts [GNUNET_CHAT_INTERNAL_TIMERS_LEVELS];
+  unsigned int count;
+
+  enum GNUNET_GenericReturnValue firing;
+
+  struct GNUNET_SCHEDULER_Task *task;
+  uint64_t task_tick;
+};
+
+/**
+ * Creates a timers structure as hierarchical timer wheel to
+ * call many callbacks at given points in time with a selected
+ * <i>resolution</i> through a single scheduler task.
+ *
+ * @param[in] resolution Resolution of timers
+ * @return New chat timers
+ */
+struct GNUNET_CHAT_InternalTimers*
+internal_timers_create (struct GNUNET_TIME_Relative resolution);
+
+/**
+ * Destroys a <i>timers</i> structure dropping all of its
+ * timers without calling them.
+ *
+ * @param[out] timers Chat timers
+ */
+void
+internal_timers_destroy (struct GNUNET_CHAT_InternalTimers *timers);
+
+/**
+ * Adds a timer to a selected <i>timers</i> structure which
+ * calls a custom <i>callback</i> with its closure once at a
+ * given point in time <i>at</i>. The callback will not be
+ * called earlier but up to the resolution of the timers later.
+ *
+ * @param[in,out] timers Chat timers
+ * @param[in] at Point in time
+ * @param[in] callback Callback for timer
+ * @param[in,out] cls Closure for timer
+ * @return New timer
+ */
+struct GNUNET_CHAT_InternalTimer*
+internal_timers_add_at (struct GNUNET_CHAT_InternalTimers *timers,
+                        struct GNUNET_TIME_Absolute at,
+                        GNUNET_SCHEDULER_TaskCallback callback,
+                        void *cls);
+
+/**
+ * Cancels a <i>timer</i> of a selected <i>timers</i> structure
+ * before it got called.
+ *
+ * @param[in,out] timers Chat timers
+ * @param[out] timer Timer
+ */
+void
+internal_timers_cancel (struct GNUNET_CHAT_InternalTimers *timers,
+                        struct GNUNET_CHAT_InternalTimer *timer);
+
+#endif /* GNUNET_CHAT_INTERNAL_TIMERS_H_ */
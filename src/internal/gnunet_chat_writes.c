@@ -0,0 +1,375 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_writes.c
+ */
+
+#include "gnunet_chat_writes.h"
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_util_lib.h>
+#include <string.h>
+
+static const unsigned int initial_map_size_of_writes = 8;
+
+struct GNUNET_CHAT_InternalWrites*
+internal_writes_create (struct GNUNET_NAMESTORE_Handle *namestore,
+                        GNUNET_CHAT_WritesErrorCallback cb,
+                        void *cls)
+{
+  struct GNUNET_CHAT_InternalWrites* writes = GNUNET_new(struct GNUNET_CHAT_InternalWrites);
+
+  writes->namestore = namestore;
+  memset(&(writes->zone), 0, sizeof(writes->zone));
+
+  writes->entries = GNUNET_CONTAINER_multihashmap_create(
+    initial_map_size_of_writes, GNUNET_NO);
+
+  writes->head = NULL;
+  writes->tail = NULL;
+
+  writes->cb = cb;
+  writes->cls = cls;
+
+  writes->written = 0;
+  writes->coalesced = 0;
+  writes->acknowledged = 0;
+
+  writes->latency = GNUNET_TIME_relative_get_zero_();
+  writes->max_latency = GNUNET_TIME_relative_get_zero_();
+
+  return writes;
+}
+
+static void
+destroy_write_entry (struct GNUNET_CHAT_InternalWriteEntry *entry)
+{
+  GNUNET_assert((entry) && (entry->label));
+
+  if (entry->buffer)
+    GNUNET_free(entry->buffer);
+
+  GNUNET_free(entry->label);
+  GNUNET_free(entry);
+}
+
+static enum GNUNET_GenericReturnValue
+it_destroy_write_entry (GNUNET_UNUSED void *cls,
+                        GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                        void *value)
+{
+  GNUNET_assert(value);
+
+  struct GNUNET_CHAT_InternalWriteEntry *entry = value;
+  destroy_write_entry(entry);
+  return GNUNET_YES;
+}
+
+void
+internal_writes_destroy (struct GNUNET_CHAT_InternalWrites *writes)
+{
+  GNUNET_assert((writes) && (writes->entries));
+
+  struct GNUNET_CHAT_InternalWriteFlush *flush;
+  while (writes->head)
+  {
+    flush = writes->head;
+
+    if (flush->op)
+      GNUNET_NAMESTORE_cancel(flush->op);
+
+    GNUNET_CONTAINER_DLL_remove(
+      writes->head,
+      writes->tail,
+      flush
+    );
+
+    GNUNET_free(flush);
+  }
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    writes->entries, it_destroy_write_entry, NULL
+  );
+
+  GNUNET_CONTAINER_multihashmap_destroy(writes->entries);
+
+  GNUNET_free(writes);
+}
+
+enum GNUNET_GenericReturnValue
+internal_writes_add (struct GNUNET_CHAT_InternalWrites *writes,
+                     const struct GNUNET_CRYPTO_BlindablePrivateKey *zone,
+                     const char *label,
+                     unsigned int count,
+                     const struct GNUNET_GNSRECORD_Data *data)
+{
+  GNUNET_assert((writes) && (zone) && (label) && ((data) || (!count)));
+
+  const ssize_t size = GNUNET_GNSRECORD_records_get_size(count, data);
+
+  if (size < 0)
+    return GNUNET_SYSERR;
+
+  // Record sets are only queued for a single zone at a time, so
+  // anything queued for a different zone gets stored right away.
+  if ((0 != GNUNET_memcmp(&(writes->zone), zone)) &&
+      (0 < GNUNET_CONTAINER_multihashmap_size(writes->entries)))
+    internal_writes_flush(writes);
+
+  GNUNET_memcpy(&(writes->zone), zone, sizeof(writes->zone));
+
+  struct GNUNET_HashCode key;
+  GNUNET_CRYPTO_hash(label, strlen(label), &key);
+
+  const enum GNUNET_GenericReturnValue empty = (
+    0 == GNUNET_CONTAINER_multihashmap_size(writes->entries)?
+    GNUNET_YES : GNUNET_NO
+  );
+
+  struct GNUNET_CHAT_InternalWriteEntry *entry;
+  entry = GNUNET_CONTAINER_multihashmap_get(writes->entries, &key);
+
+  if (entry)
+  {
+    if (entry->buffer)
+      GNUNET_free(entry->buffer);
+
+    writes->coalesced++;
+  }
+  else
+  {
+    entry = GNUNET_new(struct GNUNET_CHAT_InternalWriteEntry);
+    entry->label = GNUNET_strdup(label);
+    entry->queued = GNUNET_TIME_absolute_get();
+
+    if (GNUNET_OK != GNUNET_CONTAINER_multihashmap_put(
+        writes->entries, &key, entry,
+        GNUNET_CONTAINER_MULTIHASHMAPOPTION_UNIQUE_FAST))
+    {
+      GNUNET_free(entry->label);
+      GNUNET_free(entry);
+      return GNUNET_SYSERR;
+    }
+  }
+
+  entry->count = count;
+  entry->size = (size_t) size;
+  entry->buffer = size? GNUNET_malloc(entry->size) : NULL;
+
+  // Storing an empty record set would delete all records under
+  // the label, so a record set failing to serialize gets dropped.
+  if ((entry->buffer) && (size != GNUNET_GNSRECORD_records_serialize(
+      count, data, entry->size, entry->buffer)))
+  {
+    GNUNET_CONTAINER_multihashmap_remove(writes->entries, &key, entry);
+    destroy_write_entry(entry);
+    return GNUNET_SYSERR;
+  }
+
+  return empty;
+}
+
+static void
+cont_writes_flush (void *cls,
+                   enum GNUNET_ErrorCode ec)
+{
+  struct GNUNET_CHAT_InternalWriteFlush *flush = cls;
+
+  GNUNET_assert((flush) && (flush->writes));
+
+  struct GNUNET_CHAT_InternalWrites *writes = flush->writes;
+  flush->op = NULL;
+
+  const struct GNUNET_TIME_Relative latency = (
+    GNUNET_TIME_absolute_get_duration(flush->oldest)
+  );
+
+  if (GNUNET_EC_NONE == ec)
+    writes->written += flush->count;
+
+  writes->acknowledged += flush->count;
+  writes->latency = GNUNET_TIME_relative_add(
+    writes->latency, GNUNET_TIME_relative_multiply(latency, flush->count)
+  );
+
+  writes->max_latency = GNUNET_TIME_relative_max(writes->max_latency, latency);
+
+  GNUNET_CONTAINER_DLL_remove(
+    writes->head,
+    writes->tail,
+    flush
+  );
+
+  GNUNET_free(flush);
+
+  if ((GNUNET_EC_NONE != ec) && (writes->cb))
+    writes->cb(writes->cls, ec);
+}
+
+struct GNUNET_CHAT_InternalWritesCollect
+{
+  struct GNUNET_CHAT_InternalWriteEntry **entries;
+  unsigned int count;
+};
+
+static enum GNUNET_GenericReturnValue
+it_collect_write_entry (void *cls,
+                        GNUNET_UNUSED const struct GNUNET_HashCode *key,
+                        void *value)
+{
+  GNUNET_assert((cls) && (value));
+
+  struct GNUNET_CHAT_InternalWritesCollect *collect = cls;
+  collect->entries[collect->count++] = value;
+  return GNUNET_YES;
+}
+
+unsigned int
+internal_writes_flush (struct GNUNET_CHAT_InternalWrites *writes)
+{
+  GNUNET_assert((writes) && (writes->entries));
+
+  const unsigned int count = GNUNET_CONTAINER_multihashmap_size(
+    writes->entries
+  );
+
+  if ((!count) || (!(writes->namestore)))
+    return 0;
+
+  struct GNUNET_CHAT_InternalWritesCollect collect;
+  collect.entries = GNUNET_new_array(count, struct GNUNET_CHAT_InternalWriteEntry*);
+  collect.count = 0;
+
+  GNUNET_CONTAINER_multihashmap_iterate(
+    writes->entries, it_collect_write_entry, &collect
+  );
+
+  struct GNUNET_NAMESTORE_RecordInfo *infos;
+  infos = GNUNET_new_array(count, struct GNUNET_NAMESTORE_RecordInfo);
+
+  unsigned int valid = 0;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    struct GNUNET_CHAT_InternalWriteEntry *entry = collect.entries[i];
+
+    infos[valid].a_label = entry->label;
+    infos[valid].a_rd_count = entry->count;
+    infos[valid].a_rd = entry->count? GNUNET_new_array(
+      entry->count, struct GNUNET_GNSRECORD_Data
+    ) : NULL;
+
+    // A record set failing to deserialize must not be stored
+    // empty since that would delete all records under its label.
+    if ((infos[valid].a_rd) && (GNUNET_OK != GNUNET_GNSRECORD_records_deserialize(
+        entry->size, entry->buffer, entry->count, infos[valid].a_rd)))
+    {
+      GNUNET_free(infos[valid].a_rd);
+      continue;
+    }
+
+    collect.entries[i] = collect.entries[valid];
+    collect.entries[valid++] = entry;
+  }
+
+  unsigned int requests = 0;
+  unsigned int offset = 0;
+
+  while (offset < valid)
+  {
+    struct GNUNET_CHAT_InternalWriteFlush *flush = GNUNET_new(
+      struct GNUNET_CHAT_InternalWriteFlush
+    );
+
+    unsigned int sent = 0;
+
+    flush->writes = writes;
+    flush->op = GNUNET_NAMESTORE_records_store(
+      writes->namestore,
+      &(writes->zone),
+      valid - offset,
+      infos + offset,
+      &sent,
+      cont_writes_flush,
+      flush
+    );
+
+    if ((!(flush->op)) || (!sent))
+    {
+      if (flush->op)
+        GNUNET_NAMESTORE_cancel(flush->op);
+
+      GNUNET_free(flush);
+      break;
+    }
+
+    flush->oldest = GNUNET_TIME_absolute_get();
+    flush->count = sent;
+
+    for (unsigned int i = offset; i < offset + sent; i++)
+      flush->oldest = GNUNET_TIME_absolute_min(
+        flush->oldest, collect.entries[i]->queued
+      );
+
+    GNUNET_CONTAINER_DLL_insert_tail(
+      writes->head,
+      writes->tail,
+      flush
+    );
+
+    requests++;
+    offset += sent;
+  }
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if ((i < valid) && (infos[i].a_rd))
+      GNUNET_free(infos[i].a_rd);
+
+    struct GNUNET_HashCode key;
+    GNUNET_CRYPTO_hash(
+      collect.entries[i]->label,
+      strlen(collect.entries[i]->label),
+      &key
+    );
+
+    GNUNET_CONTAINER_multihashmap_remove(
+      writes->entries, &key, collect.entries[i]
+    );
+
+    destroy_write_entry(collect.entries[i]);
+  }
+
+  GNUNET_free(infos);
+  GNUNET_free(collect.entries);
+
+  if ((offset < count) && (writes->cb))
+    writes->cb(writes->cls, GNUNET_EC_SERVICE_COMMUNICATION_FAILED);
+
+  return requests;
+}
+
+unsigned int
+internal_writes_size (const struct GNUNET_CHAT_InternalWrites *writes)
+{
+  GNUNET_assert((writes) && (writes->entries));
+
+  return GNUNET_CONTAINER_multihashmap_size(writes->entries);
+}
@@ -0,0 +1,155 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_writes.h
+ */
+
+#ifndef GNUNET_CHAT_INTERNAL_WRITES_H_
+#define GNUNET_CHAT_INTERNAL_WRITES_H_
+
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_gnsrecord_lib.h>
+#include <gnunet/gnunet_namestore_service.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <gnunet/gnunet_util_lib.h>
+
+typedef void
+(*GNUNET_CHAT_WritesErrorCallback) (void *cls,
+                                    enum GNUNET_ErrorCode ec);
+
+struct GNUNET_CHAT_InternalWrites;
+
+struct GNUNET_CHAT_InternalWriteEntry
+{
+  char *label;
+  unsigned int count;
+
+  char *buffer;
+  size_t size;
+
+  struct GNUNET_TIME_Absolute queued;
+};
+
+struct GNUNET_CHAT_InternalWriteFlush
+{
+  struct GNUNET_CHAT_InternalWriteFlush *next;
+  struct GNUNET_CHAT_InternalWriteFlush *prev;
+
+  struct GNUNET_CHAT_InternalWrites *writes;
+  struct GNUNET_NAMESTORE_QueueEntry *op;
+
+  struct GNUNET_TIME_Absolute oldest;
+  unsigned int count;
+};
+
+struct GNUNET_CHAT_InternalWrites
+{
+  struct GNUNET_NAMESTORE_Handle *namestore;
+  struct GNUNET_CRYPTO_BlindablePrivateKey zone;
+
+  struct GNUNET_CONTAINER_MultiHashMap *entries;
+
+  struct GNUNET_CHAT_InternalWriteFlush *head;
+  struct GNUNET_CHAT_InternalWriteFlush *tail;
+
+  GNUNET_CHAT_WritesErrorCallback cb;
+  void *cls;
+
+  unsigned long long written;
+  unsigned long long coalesced;
+  unsigned long long acknowledged;
+
+  struct GNUNET_TIME_Relative latency;
+  struct GNUNET_TIME_Relative max_latency;
+};
+
+/**
+ * Creates a writes structure to queue record sets for a
+ * <i>namestore</i> and store them in bulk. Failed writes
+ * get reported to a custom callback with its closure.
+ *
+ * @param[in,out] namestore Namestore handle
+ * @param[in] cb Callback for errors
+ * @param[in,out] cls Closure for errors
+ * @return New chat writes
+ */
+struct GNUNET_CHAT_InternalWrites*
+internal_writes_create (struct GNUNET_NAMESTORE_Handle *namestore,
+                        GNUNET_CHAT_WritesErrorCallback cb,
+                        void *cls);
+
+/**
+ * Destroys a <i>writes</i> structure to queue record sets.
+ * Queued record sets get dropped and pending writes get
+ * cancelled.
+ *
+ * @param[out] writes Chat writes
+ */
+void
+internal_writes_destroy (struct GNUNET_CHAT_InternalWrites *writes);
+
+/**
+ * Queues a record set of <i>count</i> records from <i>data</i>
+ * under a given <i>label</i> of a <i>zone</i> in a selected
+ * <i>writes</i> structure. A record set queued under the same
+ * label before gets replaced.
+ *
+ * @param[in,out] writes Chat writes
+ * @param[in] zone Private key of the zone
+ * @param[in] label Record label
+ * @param[in] count Amount of records
+ * @param[in] data Records
+ * @return #GNUNET_YES if the queue was empty before, #GNUNET_NO
+ *   if it was not and #GNUNET_SYSERR on failure
+ */
+enum GNUNET_GenericReturnValue
+internal_writes_add (struct GNUNET_CHAT_InternalWrites *writes,
+                     const struct GNUNET_CRYPTO_BlindablePrivateKey *zone,
+                     const char *label,
+                     unsigned int count,
+                     const struct GNUNET_GNSRECORD_Data *data);
+
+/**
+ * Stores all queued record sets of a selected <i>writes</i>
+ * structure in the namestore using as few requests as
+ * possible.
+ *
+ * Record sets which could not be passed to the namestore
+ * get dropped and the failure is reported to the error
+ * callback of the structure.
+ *
+ * @param[in,out] writes Chat writes
+ * @return Amount of requests sent to the namestore
+ */
+unsigned int
+internal_writes_flush (struct GNUNET_CHAT_InternalWrites *writes);
+
+/**
+ * Returns the amount of record sets queued in a selected
+ * <i>writes</i> structure.
+ *
+ * @param[in] writes Chat writes
+ * @return Amount of queued record sets
+ */
+unsigned int
+internal_writes_size (const struct GNUNET_CHAT_InternalWrites *writes);
+
+#endif /* GNUNET_CHAT_INTERNAL_WRITES_H_ */
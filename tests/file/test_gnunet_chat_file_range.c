@@ -0,0 +1,205 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_file_range.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_RANGE_ID       "gnunet_chat_file_range"
+#define TEST_RANGE_FILENAME "gnunet_chat_file_range_name"
+#define TEST_RANGE_GROUP    "gnunet_chat_file_range_group"
+#define TEST_RANGE_SIZE     (2 * 1024 * 1024 + 12345)
+
+static uint8_t
+get_gnunet_chat_file_range_byte(uint64_t offset)
+{
+  return (uint8_t) ((offset * 31 + offset / 4096) & 0xFF);
+}
+
+static void
+check_gnunet_chat_file_range(struct GNUNET_CHAT_File *file,
+                             uint64_t offset,
+                             size_t size,
+                             ssize_t expected)
+{
+  uint8_t buffer [4096];
+
+  ck_assert_uint_le(size, sizeof(buffer));
+
+  const ssize_t result = GNUNET_CHAT_file_read_range(
+    file, offset, buffer, size
+  );
+
+  ck_assert_int_eq(result, expected);
+
+  for (ssize_t i = 0; i < result; i++)
+    ck_assert_uint_eq(buffer[i], get_gnunet_chat_file_range_byte(offset + i));
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_file_range_msg(void *cls,
+                              struct GNUNET_CHAT_Context *context,
+                              struct GNUNET_CHAT_Message *message)
+{
+  static unsigned int file_stage = 0;
+  static char *filename = NULL;
+
+  struct GNUNET_CHAT_Handle *handle = *(
+      (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_Group *group;
+  struct GNUNET_CHAT_File *file;
+
+  uint8_t *data;
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+
+      if (file_stage == 0)
+      {
+        account = GNUNET_CHAT_find_account(handle, TEST_RANGE_ID);
+
+        ck_assert_ptr_nonnull(account);
+
+        GNUNET_CHAT_connect(handle, account);
+        file_stage = 1;
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_uint_eq(file_stage, 1);
+
+      group = GNUNET_CHAT_group_create(
+          handle, TEST_RANGE_GROUP
+      );
+
+      ck_assert_ptr_nonnull(group);
+
+      context = GNUNET_CHAT_group_get_context(group);
+
+      ck_assert_ptr_nonnull(context);
+      ck_assert_ptr_null(filename);
+
+      filename = GNUNET_DISK_mktemp(TEST_RANGE_FILENAME);
+
+      ck_assert_ptr_nonnull(filename);
+
+      data = GNUNET_malloc(TEST_RANGE_SIZE);
+
+      for (uint64_t i = 0; i < TEST_RANGE_SIZE; i++)
+        data[i] = get_gnunet_chat_file_range_byte(i);
+
+      ck_assert_int_eq(GNUNET_DISK_fn_write(
+          filename,
+          data,
+          TEST_RANGE_SIZE,
+          GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+      ), TEST_RANGE_SIZE);
+
+      GNUNET_free(data);
+
+      file = GNUNET_CHAT_context_send_file(
+          context,
+          filename,
+          NULL,
+          NULL
+      );
+
+      ck_assert_ptr_nonnull(file);
+
+      file_stage = 2;
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(filename);
+      ck_assert_uint_eq(file_stage, 3);
+
+      GNUNET_CHAT_stop(handle);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      ck_assert_ptr_null(context);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+    case GNUNET_CHAT_KIND_JOIN:
+    case GNUNET_CHAT_KIND_CONTACT:
+      ck_assert_ptr_nonnull(context);
+      break;
+    case GNUNET_CHAT_KIND_FILE:
+      ck_assert_ptr_nonnull(context);
+      ck_assert_ptr_nonnull(filename);
+      ck_assert_uint_eq(file_stage, 2);
+
+      file = GNUNET_CHAT_message_get_file(message);
+
+      ck_assert_ptr_nonnull(file);
+
+      check_gnunet_chat_file_range(file, 0, 64, 64);
+      check_gnunet_chat_file_range(file, 1024 * 1024 - 16, 64, 64);
+      check_gnunet_chat_file_range(file, 2 * 1024 * 1024 + 100, 4096, 4096);
+      check_gnunet_chat_file_range(file, 512, 1024, 1024);
+      check_gnunet_chat_file_range(file, TEST_RANGE_SIZE - 10, 100, 10);
+      check_gnunet_chat_file_range(file, TEST_RANGE_SIZE, 100, 0);
+
+      remove(filename);
+      GNUNET_free(filename);
+      filename = NULL;
+
+      GNUNET_CHAT_disconnect(handle);
+      file_stage = 3;
+      break;
+    default:
+      ck_abort();
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_file_range, TEST_RANGE_ID)
+
+void
+call_gnunet_chat_file_range(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_file_range_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_file_range, gnunet_chat_file_range)
+
+START_SUITE(handle_suite, "File")
+ADD_TEST_TO_SUITE(test_gnunet_chat_file_range, "Range")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,254 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2021--2024 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_handle_namestore.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_NAMESTORE_ID     "gnunet_chat_handle_namestore"
+#define TEST_NAMESTORE_GROUP  "gnunet_chat_handle_namestore_group"
+#define TEST_NAMESTORE_GROUPS 3
+#define TEST_NAMESTORE_BATCH  64
+
+static struct GNUNET_CHAT_Account *namestore_account = NULL;
+static unsigned int namestore_stage = 0;
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_namestore_group(GNUNET_UNUSED void *cls,
+                                      struct GNUNET_CHAT_Handle *handle,
+                                      struct GNUNET_CHAT_Group *group)
+{
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(group);
+
+  GNUNET_CHAT_group_leave(group);
+  return GNUNET_YES;
+}
+
+void
+task_gnunet_chat_handle_namestore(void *cls)
+{
+  struct GNUNET_CHAT_Handle *handle = cls;
+
+  unsigned long long round_trips;
+  unsigned long long records;
+  unsigned long long written;
+  unsigned int pending;
+
+  ck_assert_ptr_nonnull(handle);
+
+  if (namestore_stage == 2)
+  {
+    ck_assert_int_eq(GNUNET_CHAT_get_record_queue_stats(
+      handle, &pending, &written, NULL, NULL, NULL
+    ), GNUNET_OK);
+
+    // All groups need to be stored before the zone gets loaded.
+    if ((pending) || (written < TEST_NAMESTORE_GROUPS))
+      goto reschedule;
+
+    ck_assert_int_eq(GNUNET_CHAT_set_zone_batch_size(handle, 1), GNUNET_OK);
+
+    GNUNET_CHAT_connect(handle, namestore_account);
+    namestore_stage = 3;
+    return;
+  }
+
+  if (GNUNET_YES != GNUNET_CHAT_get_startup_profile(
+      handle, NULL, NULL, NULL, NULL))
+    goto reschedule;
+
+  ck_assert_int_eq(GNUNET_CHAT_get_namestore_stats(
+    handle, &round_trips, &records
+  ), GNUNET_OK);
+
+  ck_assert_uint_ge(records, TEST_NAMESTORE_GROUPS);
+
+  if (namestore_stage == 4)
+  {
+    // Without batching every record requires its own round trip.
+    ck_assert_uint_gt(round_trips, records);
+
+    GNUNET_CHAT_disconnect(handle);
+    namestore_stage = 5;
+  }
+  else
+  {
+    ck_assert_uint_eq(namestore_stage, 7);
+
+    // All records fit into the first batch, so they only require
+    // the initial round trip.
+    ck_assert_uint_lt(round_trips, records);
+
+    GNUNET_CHAT_iterate_groups(
+      handle, on_gnunet_chat_handle_namestore_group, NULL
+    );
+
+    GNUNET_CHAT_disconnect(handle);
+    namestore_stage = 8;
+  }
+
+  return;
+
+reschedule:
+  GNUNET_SCHEDULER_add_delayed(
+    GNUNET_TIME_relative_multiply(GNUNET_TIME_UNIT_MILLISECONDS, 50),
+    task_gnunet_chat_handle_namestore,
+    handle
+  );
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_namestore_msg(void *cls,
+                                     struct GNUNET_CHAT_Context *context,
+                                     struct GNUNET_CHAT_Message *message)
+{
+  struct GNUNET_CHAT_Handle *handle = *(
+      (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  struct GNUNET_CHAT_Account *connected;
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_Group *group;
+  const char *name;
+
+  connected = GNUNET_CHAT_get_connected(handle);
+  account = GNUNET_CHAT_message_get_account(message);
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(account);
+
+      if (namestore_stage == 0)
+      {
+        namestore_account = GNUNET_CHAT_find_account(handle, TEST_NAMESTORE_ID);
+
+        ck_assert_ptr_nonnull(namestore_account);
+
+        GNUNET_CHAT_connect(handle, namestore_account);
+        namestore_stage = 1;
+      }
+      
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(connected);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_ptr_eq(connected, account);
+
+      name = GNUNET_CHAT_account_get_name(account);
+
+      ck_assert_ptr_nonnull(name);
+      ck_assert_str_eq(name, TEST_NAMESTORE_ID);
+
+      if (namestore_stage == 1)
+      {
+        for (unsigned int i = 0; i < TEST_NAMESTORE_GROUPS; i++)
+        {
+          group = GNUNET_CHAT_group_create(handle, TEST_NAMESTORE_GROUP);
+
+          ck_assert_ptr_nonnull(group);
+        }
+
+        GNUNET_CHAT_disconnect(handle);
+        namestore_stage = 2;
+        break;
+      }
+
+      ck_assert(
+        (namestore_stage == 3) || (namestore_stage == 6)
+      );
+
+      namestore_stage++;
+
+      GNUNET_SCHEDULER_add_now(task_gnunet_chat_handle_namestore, handle);
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(connected);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_ptr_eq(connected, account);
+
+      if (namestore_stage == 2)
+        GNUNET_SCHEDULER_add_now(task_gnunet_chat_handle_namestore, handle);
+      else if (namestore_stage == 5)
+      {
+        ck_assert_int_eq(GNUNET_CHAT_set_zone_batch_size(
+          handle, TEST_NAMESTORE_BATCH
+        ), GNUNET_OK);
+
+        GNUNET_CHAT_connect(handle, namestore_account);
+        namestore_stage = 6;
+      }
+      else
+      {
+        ck_assert_uint_eq(namestore_stage, 8);
+
+        GNUNET_CHAT_stop(handle);
+        namestore_stage = 9;
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+      break;
+    case GNUNET_CHAT_KIND_JOIN:
+      break;
+    case GNUNET_CHAT_KIND_LEAVE:
+      break;
+    case GNUNET_CHAT_KIND_CONTACT:
+      break;
+    default:
+      ck_abort();
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_handle_namestore, TEST_NAMESTORE_ID)
+
+void
+call_gnunet_chat_handle_namestore(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_handle_namestore_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_handle_namestore, gnunet_chat_handle_namestore)
+
+START_SUITE(handle_suite, "Handle")
+ADD_TEST_TO_SUITE(test_gnunet_chat_handle_namestore, "Namestore statistics")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,255 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2021--2024 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_handle_snapshot.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_SNAPSHOT_ID    "gnunet_chat_handle_snapshot"
+#define TEST_SNAPSHOT_GROUP "gnunet_chat_handle_snapshot_group"
+
+static const struct GNUNET_CONFIGURATION_Handle *snapshot_cfg = NULL;
+static unsigned int snapshot_stage = 0;
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_snapshot_file(void *cls,
+                                    const char *filename)
+{
+  unsigned int *files = cls;
+
+  ck_assert_ptr_nonnull(files);
+  ck_assert_ptr_nonnull(filename);
+
+  // Snapshots of a different version have to be ignored, so
+  // the contexts get restored from the zone records instead.
+  const uint32_t header [3] = {
+    htonl(0x47435350), htonl(0xFFFFFFFF), htonl(1)
+  };
+
+  ck_assert_int_eq(GNUNET_DISK_fn_write(
+    filename, header, sizeof(header),
+    GNUNET_DISK_PERM_USER_READ | GNUNET_DISK_PERM_USER_WRITE
+  ), GNUNET_OK);
+
+  (*files)++;
+  return GNUNET_OK;
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_snapshot_group(void *cls,
+                                     struct GNUNET_CHAT_Handle *handle,
+                                     struct GNUNET_CHAT_Group *group)
+{
+  struct GNUNET_CHAT_Group **found = cls;
+
+  ck_assert_ptr_nonnull(found);
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(group);
+
+  const char *name = GNUNET_CHAT_group_get_name(group);
+
+  if ((name) && (0 == strcmp(name, TEST_SNAPSHOT_GROUP)))
+    *found = group;
+
+  return GNUNET_YES;
+}
+
+void
+task_gnunet_chat_handle_snapshot(void *cls)
+{
+  struct GNUNET_CHAT_Handle *handle = cls;
+  struct GNUNET_CHAT_Group *group = NULL;
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_uint_eq(snapshot_stage, 5);
+
+  GNUNET_CHAT_iterate_groups(
+    handle, on_gnunet_chat_handle_snapshot_group, &group
+  );
+
+  ck_assert_ptr_nonnull(group);
+  ck_assert_int_eq(GNUNET_CHAT_group_leave(group), GNUNET_OK);
+
+  GNUNET_CHAT_disconnect(handle);
+  snapshot_stage = 6;
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_snapshot_msg(void *cls,
+                                   struct GNUNET_CHAT_Context *context,
+                                   struct GNUNET_CHAT_Message *message)
+{
+  static struct GNUNET_CHAT_Account *snapshot_account = NULL;
+
+  struct GNUNET_CHAT_Handle *handle = *(
+      (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_Group *group;
+  char *directory;
+  char *snapshots;
+  unsigned int files;
+
+  account = GNUNET_CHAT_message_get_account(message);
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(account);
+
+      if (snapshot_stage == 0)
+      {
+        snapshot_account = GNUNET_CHAT_find_account(handle, TEST_SNAPSHOT_ID);
+
+        ck_assert_ptr_nonnull(snapshot_account);
+
+        GNUNET_CHAT_connect(handle, snapshot_account);
+        snapshot_stage = 1;
+      }
+      
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+
+      group = NULL;
+
+      if (snapshot_stage == 1)
+      {
+        group = GNUNET_CHAT_group_create(handle, TEST_SNAPSHOT_GROUP);
+
+        ck_assert_ptr_nonnull(group);
+
+        GNUNET_CHAT_disconnect(handle);
+        snapshot_stage = 2;
+      }
+      else if (snapshot_stage == 3)
+      {
+        // The group gets restored from the snapshot written on
+        // disconnect right when connecting to the account again.
+        GNUNET_CHAT_iterate_groups(
+          handle, on_gnunet_chat_handle_snapshot_group, &group
+        );
+
+        ck_assert_ptr_nonnull(group);
+
+        GNUNET_CHAT_disconnect(handle);
+        snapshot_stage = 4;
+      }
+      else
+      {
+        ck_assert_uint_eq(snapshot_stage, 5);
+
+        GNUNET_SCHEDULER_add_delayed(
+          GNUNET_TIME_relative_multiply(GNUNET_TIME_UNIT_SECONDS, 2),
+          task_gnunet_chat_handle_snapshot,
+          handle
+        );
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+
+      if (snapshot_stage == 2)
+      {
+        GNUNET_CHAT_connect(handle, snapshot_account);
+        snapshot_stage = 3;
+      }
+      else if (snapshot_stage == 4)
+      {
+        ck_assert_ptr_nonnull(snapshot_cfg);
+        ck_assert_int_eq(GNUNET_CONFIGURATION_get_value_filename(
+          snapshot_cfg, "messenger", "MESSENGER_DIR", &directory
+        ), GNUNET_OK);
+
+        GNUNET_asprintf(&snapshots, "%s/chat/snapshots", directory);
+        GNUNET_free(directory);
+
+        files = 0;
+        GNUNET_DISK_directory_scan(
+          snapshots, on_gnunet_chat_handle_snapshot_file, &files
+        );
+
+        GNUNET_free(snapshots);
+
+        ck_assert_uint_ge(files, 1);
+
+        GNUNET_CHAT_connect(handle, snapshot_account);
+        snapshot_stage = 5;
+      }
+      else
+      {
+        ck_assert_uint_eq(snapshot_stage, 6);
+
+        GNUNET_CHAT_stop(handle);
+        snapshot_stage = 7;
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+      break;
+    case GNUNET_CHAT_KIND_JOIN:
+      break;
+    case GNUNET_CHAT_KIND_LEAVE:
+      break;
+    case GNUNET_CHAT_KIND_CONTACT:
+      break;
+    default:
+      ck_abort();
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_handle_snapshot, TEST_SNAPSHOT_ID)
+
+void
+call_gnunet_chat_handle_snapshot(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  snapshot_cfg = cfg;
+
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_handle_snapshot_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_handle_snapshot, gnunet_chat_handle_snapshot)
+
+START_SUITE(handle_suite, "Handle")
+ADD_TEST_TO_SUITE(test_gnunet_chat_handle_snapshot, "Snapshot")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,175 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2021--2024 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_handle_writes.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_WRITES_ID    "gnunet_chat_handle_writes"
+#define TEST_WRITES_GROUP "gnunet_chat_handle_writes_group"
+#define TEST_WRITES_NAME  "gnunet_chat_handle_writes_name"
+
+static unsigned int writes_stage = 0;
+
+void
+task_gnunet_chat_handle_writes(void *cls)
+{
+  struct GNUNET_CHAT_Handle *handle = cls;
+
+  unsigned long long written;
+  unsigned long long average_latency;
+  unsigned long long maximum_latency;
+  unsigned int pending;
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_uint_eq(writes_stage, 2);
+
+  ck_assert_int_eq(GNUNET_CHAT_get_record_queue_stats(
+    handle, &pending, &written, NULL, &average_latency, &maximum_latency
+  ), GNUNET_OK);
+
+  // All record sets have been confirmed by the namestore by now.
+  ck_assert_uint_eq(pending, 0);
+  ck_assert_uint_ge(written, 1);
+  ck_assert_uint_le(average_latency, maximum_latency);
+
+  GNUNET_CHAT_disconnect(handle);
+  writes_stage = 3;
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_handle_writes_msg(void *cls,
+                                 struct GNUNET_CHAT_Context *context,
+                                 struct GNUNET_CHAT_Message *message)
+{
+  struct GNUNET_CHAT_Handle *handle = *(
+      (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_Group *group;
+  unsigned long long previous;
+  unsigned long long written;
+  unsigned long long coalesced;
+  unsigned int pending;
+
+  account = GNUNET_CHAT_message_get_account(message);
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(account);
+
+      if (writes_stage == 0)
+      {
+        account = GNUNET_CHAT_find_account(handle, TEST_WRITES_ID);
+
+        ck_assert_ptr_nonnull(account);
+
+        GNUNET_CHAT_connect(handle, account);
+        writes_stage = 1;
+      }
+      
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_uint_eq(writes_stage, 1);
+
+      ck_assert_int_eq(GNUNET_CHAT_get_record_queue_stats(
+        handle, NULL, &previous, NULL, NULL, NULL
+      ), GNUNET_OK);
+
+      group = GNUNET_CHAT_group_create(handle, TEST_WRITES_GROUP);
+
+      ck_assert_ptr_nonnull(group);
+
+      GNUNET_CHAT_group_set_name(group, TEST_WRITES_NAME);
+      GNUNET_CHAT_group_set_name(group, TEST_WRITES_GROUP);
+
+      // Updates of the same record set get coalesced in the queue
+      // and nothing gets stored before the write delay passed.
+      ck_assert_int_eq(GNUNET_CHAT_get_record_queue_stats(
+        handle, &pending, &written, &coalesced, NULL, NULL
+      ), GNUNET_OK);
+
+      ck_assert_uint_eq(pending, 1);
+      ck_assert_uint_eq(written, previous);
+      ck_assert_uint_ge(coalesced, 1);
+
+      GNUNET_SCHEDULER_add_delayed(
+        GNUNET_TIME_relative_multiply(GNUNET_TIME_UNIT_SECONDS, 2),
+        task_gnunet_chat_handle_writes,
+        handle
+      );
+
+      writes_stage = 2;
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_uint_eq(writes_stage, 3);
+
+      GNUNET_CHAT_stop(handle);
+      writes_stage = 4;
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+      break;
+    case GNUNET_CHAT_KIND_JOIN:
+      break;
+    case GNUNET_CHAT_KIND_CONTACT:
+      break;
+    default:
+      ck_abort();
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_handle_writes, TEST_WRITES_ID)
+
+void
+call_gnunet_chat_handle_writes(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_handle_writes_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_handle_writes, gnunet_chat_handle_writes)
+
+START_SUITE(handle_suite, "Handle")
+ADD_TEST_TO_SUITE(test_gnunet_chat_handle_writes, "Record queue statistics")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,235 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_message_batch.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_BATCH_ID    "gnunet_chat_message_batch"
+#define TEST_BATCH_GROUP "gnunet_chat_message_batch_group"
+#define TEST_BATCH_MSG   "test_batch_message"
+#define TEST_BATCH_TIMER "test_batch_timer"
+#define TEST_BATCH_SIZE  2
+#define TEST_BATCH_TEXTS 4
+#define TEST_BATCH_DELAY 100
+
+static unsigned int batch_stage = 0;
+static unsigned int batch_texts = 0;
+static struct GNUNET_TIME_Absolute batch_sent;
+
+void
+on_gnunet_chat_message_batch_batch(void *cls,
+                                   struct GNUNET_CHAT_Context *context,
+                                   struct GNUNET_CHAT_Message **messages,
+                                   unsigned int count)
+{
+  struct GNUNET_CHAT_Handle *handle = *(
+    (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  struct GNUNET_CHAT_Group *group;
+  const char *text;
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(context);
+  ck_assert_ptr_nonnull(messages);
+  ck_assert_uint_gt(count, 0);
+
+  // The delay of the first stages never passes during the test,
+  // so all batches get delivered because they are full.
+  if (batch_stage < 4)
+    ck_assert_uint_eq(count, TEST_BATCH_SIZE);
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    ck_assert_ptr_nonnull(messages[i]);
+
+    switch (GNUNET_CHAT_message_get_kind(messages[i]))
+    {
+      case GNUNET_CHAT_KIND_JOIN:
+        if (batch_stage != 2)
+          break;
+
+        for (unsigned int j = 0; j < TEST_BATCH_TEXTS; j++)
+          ck_assert_int_eq(GNUNET_CHAT_context_send_text(
+            context, TEST_BATCH_MSG
+          ), GNUNET_OK);
+
+        batch_stage = 3;
+        break;
+      case GNUNET_CHAT_KIND_TEXT:
+        text = GNUNET_CHAT_message_get_text(messages[i]);
+
+        ck_assert_ptr_nonnull(text);
+
+        if (0 == strcmp(text, TEST_BATCH_MSG))
+        {
+          batch_texts++;
+          break;
+        }
+
+        ck_assert_str_eq(text, TEST_BATCH_TIMER);
+        ck_assert_uint_eq(batch_stage, 5);
+
+        // The batch is far from full, so only its delay can have
+        // triggered the delivery.
+        ck_assert_uint_lt(count, TEST_BATCH_TEXTS * TEST_BATCH_SIZE);
+        ck_assert_uint_ge(
+          GNUNET_TIME_absolute_get_duration(batch_sent).rel_value_us,
+          TEST_BATCH_DELAY * 1000LL
+        );
+
+        group = GNUNET_CHAT_context_get_group(context);
+
+        ck_assert_ptr_nonnull(group);
+        ck_assert_int_eq(GNUNET_CHAT_group_leave(group), GNUNET_OK);
+
+        batch_stage = 6;
+        break;
+      case GNUNET_CHAT_KIND_LEAVE:
+        if (batch_stage != 6)
+          break;
+
+        GNUNET_CHAT_disconnect(handle);
+        batch_stage = 7;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if ((batch_stage != 3) || (batch_texts < TEST_BATCH_SIZE))
+    return;
+
+  batch_stage = 4;
+
+  ck_assert_int_eq(GNUNET_CHAT_set_batch_callback(
+    handle,
+    on_gnunet_chat_message_batch_batch,
+    cls,
+    TEST_BATCH_TEXTS * TEST_BATCH_SIZE,
+    TEST_BATCH_DELAY
+  ), GNUNET_OK);
+
+  batch_sent = GNUNET_TIME_absolute_get();
+
+  ck_assert_int_eq(GNUNET_CHAT_context_send_text(
+    context, TEST_BATCH_TIMER
+  ), GNUNET_OK);
+
+  batch_stage = 5;
+}
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_message_batch_msg(void *cls,
+                                 struct GNUNET_CHAT_Context *context,
+                                 struct GNUNET_CHAT_Message *message)
+{
+  struct GNUNET_CHAT_Handle *handle = *(
+    (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_Group *group;
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  account = GNUNET_CHAT_message_get_account(message);
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(account);
+
+      if (batch_stage == 0)
+      {
+        account = GNUNET_CHAT_find_account(handle, TEST_BATCH_ID);
+
+        ck_assert_ptr_nonnull(account);
+        ck_assert_int_eq(GNUNET_CHAT_set_batch_callback(
+          handle,
+          on_gnunet_chat_message_batch_batch,
+          cls,
+          TEST_BATCH_SIZE,
+          TEST_BATCH_DELAY * 1000
+        ), GNUNET_OK);
+
+        GNUNET_CHAT_connect(handle, account);
+        batch_stage = 1;
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_uint_eq(batch_stage, 1);
+
+      group = GNUNET_CHAT_group_create(handle, TEST_BATCH_GROUP);
+
+      ck_assert_ptr_nonnull(group);
+
+      batch_stage = 2;
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_uint_eq(batch_stage, 7);
+
+      GNUNET_CHAT_stop(handle);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      ck_assert_ptr_nonnull(account);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+      ck_assert_ptr_nonnull(context);
+      break;
+    default:
+      ck_abort_msg("%d\n", GNUNET_CHAT_message_get_kind(message));
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_message_batch, TEST_BATCH_ID)
+
+void
+call_gnunet_chat_message_batch(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_message_batch_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_message_batch, gnunet_chat_message_batch)
+
+START_SUITE(handle_suite, "Message")
+ADD_TEST_TO_SUITE(test_gnunet_chat_message_batch, "Batch")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,179 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file test_gnunet_chat_tag_stub.c
+ */
+
+#include "test_gnunet_chat.h"
+
+#define TEST_STUB_ID    "gnunet_chat_tag_stub"
+#define TEST_STUB_GROUP "gnunet_chat_tag_stub_group"
+#define TEST_STUB_NAME  "gnunet_chat_tag_stub_name"
+
+enum GNUNET_GenericReturnValue
+on_gnunet_chat_tag_stub_msg(void *cls,
+                            struct GNUNET_CHAT_Context *context,
+                            struct GNUNET_CHAT_Message *message)
+{
+  static unsigned int stub_stage = 0;
+  static enum GNUNET_GenericReturnValue stub_checked = GNUNET_NO;
+  static enum GNUNET_GenericReturnValue stub_joined = GNUNET_NO;
+
+  struct GNUNET_CHAT_Handle *handle = *(
+      (struct GNUNET_CHAT_Handle**) cls
+  );
+
+  ck_assert_ptr_nonnull(handle);
+  ck_assert_ptr_nonnull(message);
+
+  struct GNUNET_CHAT_Account *account;
+  account = GNUNET_CHAT_message_get_account(message);
+
+  const char *name = GNUNET_CHAT_get_name(handle);
+
+  struct GNUNET_CHAT_Group *group;
+  group = GNUNET_CHAT_context_get_group(context);
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_WARNING:
+      ck_abort_msg("%s\n", GNUNET_CHAT_message_get_text(message));
+      break;
+    case GNUNET_CHAT_KIND_REFRESH:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_null(account);
+
+      if (stub_stage == 0)
+      {
+        account = GNUNET_CHAT_find_account(handle, TEST_STUB_ID);
+
+        ck_assert_ptr_nonnull(account);
+
+        GNUNET_CHAT_connect(handle, account);
+        stub_stage = 1;
+      }
+
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_ptr_nonnull(name);
+      ck_assert_str_eq(name, TEST_STUB_ID);
+      ck_assert_uint_eq(stub_stage, 1);
+
+      group = GNUNET_CHAT_group_create(handle, TEST_STUB_GROUP);
+
+      ck_assert_ptr_nonnull(group);
+
+      // Renaming the group right away emits an update for its context
+      // before any message of the room could materialize it.
+      GNUNET_CHAT_group_set_name(group, TEST_STUB_NAME);
+
+      stub_stage = 2;
+      break;
+    case GNUNET_CHAT_KIND_LOGOUT:
+      ck_assert_ptr_null(context);
+      ck_assert_ptr_nonnull(account);
+      ck_assert_uint_eq(stub_stage, 4);
+
+      GNUNET_CHAT_stop(handle);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_ACCOUNT:
+      ck_assert_ptr_nonnull(account);
+      break;
+    case GNUNET_CHAT_KIND_UPDATE_CONTEXT:
+      ck_assert_ptr_nonnull(context);
+
+      if ((!group) || (GNUNET_YES == stub_checked))
+        break;
+
+      ck_assert_uint_eq(stub_stage, 2);
+
+      ck_assert_int_eq(
+        GNUNET_CHAT_message_is_tagged(message, NULL),
+        GNUNET_NO
+      );
+
+      ck_assert_int_eq(
+        GNUNET_CHAT_message_iterate_tags(message, NULL, NULL),
+        0
+      );
+
+      ck_assert_ptr_null(GNUNET_CHAT_message_get_target(message));
+      ck_assert_ptr_null(GNUNET_CHAT_message_get_invitation(message));
+
+      stub_checked = GNUNET_YES;
+
+      if (GNUNET_YES != stub_joined)
+        break;
+
+      ck_assert_int_eq(GNUNET_CHAT_group_leave(group), GNUNET_OK);
+      stub_stage = 3;
+      break;
+    case GNUNET_CHAT_KIND_JOIN:
+      ck_assert_ptr_nonnull(context);
+      ck_assert_ptr_nonnull(group);
+      ck_assert_uint_eq(stub_stage, 2);
+
+      stub_joined = GNUNET_YES;
+
+      if (GNUNET_YES != stub_checked)
+        break;
+
+      ck_assert_int_eq(GNUNET_CHAT_group_leave(group), GNUNET_OK);
+      stub_stage = 3;
+      break;
+    case GNUNET_CHAT_KIND_LEAVE:
+      ck_assert_ptr_nonnull(context);
+      ck_assert_uint_eq(stub_stage, 3);
+
+      GNUNET_CHAT_disconnect(handle);
+      stub_stage = 4;
+      break;
+    case GNUNET_CHAT_KIND_CONTACT:
+      break;
+    default:
+      ck_abort_msg("%d\n", GNUNET_CHAT_message_get_kind(message));
+      ck_abort();
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+REQUIRE_GNUNET_CHAT_ACCOUNT(gnunet_chat_tag_stub, TEST_STUB_ID)
+
+void
+call_gnunet_chat_tag_stub(const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  static struct GNUNET_CHAT_Handle *handle = NULL;
+  handle = GNUNET_CHAT_start(cfg, on_gnunet_chat_tag_stub_msg, &handle);
+
+  ck_assert_ptr_nonnull(handle);
+}
+
+CREATE_GNUNET_TEST(test_gnunet_chat_tag_stub, gnunet_chat_tag_stub)
+
+START_SUITE(handle_suite, "Tag")
+ADD_TEST_TO_SUITE(test_gnunet_chat_tag_stub, "Stub")
+END_SUITE
+
+MAIN_SUITE(handle_suite, CK_NORMAL)
@@ -0,0 +1,282 @@
+/*
+   This file is part of GNUnet.
+   Copyright (C) 2025 GNUnet e.V.
+
+   GNUnet is free software: you can redistribute it and/or modify it
+   under the terms of the GNU Affero General Public License as published
+   by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   GNUnet is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Affero General Public License for more details.
+
+   You should have received a copy of the GNU Affero General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   SPDX-License-Identifier: AGPL3.0-or-later
+ */
+/*
+ * @author Tobias Frisch
+ * @file gnunet_chat_lib_discourse.c
+ */
+
+
+#include "gnunet/gnunet_chat_lib.h"
+#include <gnunet/gnunet_common.h>
+#include <gnunet/gnunet_scheduler_lib.h>
+#include <gnunet/gnunet_time_lib.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_DISCOURSE_DATA 65536
+
+struct GNUNET_CHAT_DiscourseTool
+{
+  struct GNUNET_CHAT_Handle *handle;
+  char *account_name;
+  char *group_name;
+  unsigned int count;
+  unsigned int size;
+
+  bool connected;
+  bool joined;
+
+  unsigned int opened;
+  unsigned long long received;
+
+  int pipe [2];
+
+  struct GNUNET_TIME_Absolute start;
+};
+
+static void
+write_discourse (struct GNUNET_CHAT_DiscourseTool *tool,
+                 struct GNUNET_CHAT_Discourse *discourse)
+{
+  static char data [MAX_DISCOURSE_DATA];
+
+  const int fd = GNUNET_CHAT_discourse_get_fd(discourse);
+
+  if (-1 == fd)
+    return;
+
+  if (!(tool->opened))
+    tool->start = GNUNET_TIME_absolute_get();
+
+  tool->opened++;
+
+  // The whole data fits into the pipe of the discourse, so
+  // this does not block before the data gets read again.
+  size_t offset = 0;
+  ssize_t written;
+
+  while (offset < tool->size)
+  {
+    written = write(fd, data + offset, tool->size - offset);
+
+    if (written <= 0)
+      break;
+
+    offset += written;
+  }
+}
+
+static void
+forward_data (struct GNUNET_CHAT_DiscourseTool *tool,
+              struct GNUNET_CHAT_Message *message)
+{
+  static char data [MAX_DISCOURSE_DATA];
+
+  if (-1 == tool->pipe[1])
+    return;
+
+  GNUNET_CHAT_message_feed(message, tool->pipe[1]);
+
+  while (0 < read(tool->pipe[0], data, MAX_DISCOURSE_DATA))
+    continue;
+}
+
+static enum GNUNET_GenericReturnValue
+chat_message (void *cls,
+              struct GNUNET_CHAT_Context *context,
+              struct GNUNET_CHAT_Message *message)
+{
+  struct GNUNET_CHAT_DiscourseTool *tool = cls;
+
+  struct GNUNET_CHAT_Discourse *discourse;
+  discourse = GNUNET_CHAT_message_get_discourse(message);
+
+  struct GNUNET_CHAT_Account *account;
+  struct GNUNET_CHAT_DiscourseId id;
+  struct GNUNET_TIME_Relative duration;
+
+  switch (GNUNET_CHAT_message_get_kind(message))
+  {
+    case GNUNET_CHAT_KIND_REFRESH:
+      if (tool->connected)
+        break;
+
+      account = GNUNET_CHAT_find_account(
+        tool->handle, tool->account_name
+      );
+
+      if (!account)
+        break;
+
+      GNUNET_CHAT_connect(tool->handle, account);
+      tool->connected = true;
+      break;
+    case GNUNET_CHAT_KIND_LOGIN:
+      GNUNET_CHAT_group_create(tool->handle, tool->group_name);
+      break;
+    case GNUNET_CHAT_KIND_JOIN:
+      if ((tool->joined) || (!context))
+        break;
+
+      for (unsigned int index = 0; index < tool->count; index++)
+      {
+        memset(&id, 0, sizeof(id));
+        GNUNET_memcpy(&id, &index, sizeof(index));
+
+        GNUNET_CHAT_context_open_discourse(context, &id);
+      }
+
+      tool->joined = true;
+      break;
+    case GNUNET_CHAT_KIND_DISCOURSE:
+      if ((discourse) && (GNUNET_YES == GNUNET_CHAT_discourse_is_open(discourse)))
+        write_discourse(tool, discourse);
+
+      break;
+    case GNUNET_CHAT_KIND_DATA:
+      forward_data(tool, message);
+
+      tool->received += GNUNET_CHAT_message_available(message);
+
+      if (tool->received < (unsigned long long) tool->count * tool->size)
+        break;
+
+      duration = GNUNET_TIME_absolute_get_duration(tool->start);
+
+      printf(
+        "%u %u %llu %.2f\n",
+        tool->count,
+        tool->size,
+        (unsigned long long) duration.rel_value_us,
+        duration.rel_value_us? (
+          (double) tool->received / duration.rel_value_us
+        ) : 0.0
+      );
+
+      GNUNET_CHAT_stop(tool->handle);
+      tool->handle = NULL;
+      break;
+    default:
+      break;
+  }
+
+  return GNUNET_YES;
+}
+
+static void
+run (void *cls,
+     char* const* args,
+     const char *cfgfile,
+     const struct GNUNET_CONFIGURATION_Handle *cfg)
+{
+  struct GNUNET_CHAT_DiscourseTool *tool = cls;
+
+  if ((!(tool->account_name)) || (!(tool->count)) || (!(tool->size)))
+    return;
+
+  if (!(tool->group_name))
+    tool->group_name = GNUNET_strdup("discourses");
+
+  if (tool->size > MAX_DISCOURSE_DATA)
+    tool->size = MAX_DISCOURSE_DATA;
+
+  if (0 != pipe(tool->pipe))
+  {
+    tool->pipe[0] = -1;
+    tool->pipe[1] = -1;
+  }
+  else
+    fcntl(tool->pipe[0], F_SETFL, O_NONBLOCK);
+
+  tool->handle = GNUNET_CHAT_start(
+    cfg,
+    chat_message,
+    tool
+  );
+}
+
+int
+main (int argc,
+      char* const* argv)
+{
+  struct GNUNET_CHAT_DiscourseTool tool;
+  memset(&tool, 0, sizeof(tool));
+
+  tool.count = 1;
+  tool.size = 4096;
+
+  tool.pipe[0] = -1;
+  tool.pipe[1] = -1;
+
+  const struct GNUNET_OS_ProjectData *data;
+  data = GNUNET_OS_project_data_gnunet ();
+
+  struct GNUNET_GETOPT_CommandLineOption options[] = {
+    GNUNET_GETOPT_option_string(
+      'a',
+      "account",
+      "ACCOUNT_NAME",
+      "name of account to open discourses with",
+      &(tool.account_name)
+    ),
+    GNUNET_GETOPT_option_string(
+      'g',
+      "group",
+      "GROUP_NAME",
+      "name of group chat to open discourses in",
+      &(tool.group_name)
+    ),
+    GNUNET_GETOPT_option_uint(
+      'n',
+      "count",
+      "COUNT",
+      "amount of discourses to open",
+      &(tool.count)
+    ),
+    GNUNET_GETOPT_option_uint(
+      's',
+      "size",
+      "SIZE",
+      "amount of bytes to write into each discourse",
+      &(tool.size)
+    ),
+    GNUNET_GETOPT_OPTION_END
+  };
+
+  enum GNUNET_GenericReturnValue result = GNUNET_PROGRAM_run(
+    data,
+    argc,
+    argv,
+    "libgnunetchat_discourse",
+    gettext_noop("A tool to benchmark discourses of libgnunetchat."),
+    options,
+    &run,
+    &tool
+  );
+
+  if (-1 != tool.pipe[0])
+    close(tool.pipe[0]);
+  if (-1 != tool.pipe[1])
+    close(tool.pipe[1]);
+
+  return GNUNET_OK == result? 0 : 1;
+}